@@ -0,0 +1,63 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT 2021 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MIX MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/mix_myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+/*! \file
+ *
+ *  \author SRA
+ *
+ *  \brief Minimal Arduino core replacement for host builds
+ *
+ *  Provides the few Arduino core services used by the library so that the
+ *  RFAL and NDEF sources can be compiled on a host machine together with
+ *  the host RF front-end (rfal_rf_host.h).
+ *  Time is virtual: millis() and delay() operate on the clock kept by the
+ *  host front-end, so that runs are deterministic and independent of the
+ *  host CPU speed.
+ *
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/*
+******************************************************************************
+* INCLUDES
+******************************************************************************
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+******************************************************************************
+* GLOBAL FUNCTION PROTOTYPES
+******************************************************************************
+*/
+
+/*! Returns the virtual time elapsed since start-up in ms */
+uint32_t millis(void);
+
+/*! Advances the virtual time by the given amount of ms */
+void delay(uint32_t ms);
+
+#endif /* ARDUINO_H */
@@ -0,0 +1,924 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT 2021 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MIX MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/mix_myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+/*! \file
+ *
+ *  \author SRA
+ *
+ *  \brief NDEF poller benchmark
+ *
+ *  Runs the NDEF poller operations (format, write message, detect, read
+ *  raw message twice) against the host tag models for every tag type,
+ *  sweeping the message size from 16 bytes to 8 Kbytes. Detect and read
+ *  start from a new poller context, whose initialization is reported as
+ *  reinit (what is remembered across taps); the second read (reread) shows what
+ *  the poller caches save. Last, the message is written again with one
+ *  payload byte changed in differential write mode (update), then with its
+ *  record split into 256 bytes chunks (chunked), read back chunk by chunk
+ *  through a decoder buffer shorter than the record. On T5T the
+ *  same number of bytes is then streamed through the ST25DV Mailbox to a
+ *  host side that echoes every message back (mailbox).
+ *  A second tag of each type holds a message of up to 16 records, more than
+ *  the internal record pool, starting with a Wi-Fi and a vCard record from
+ *  512 bytes on. It is read and decoded into a caller-supplied record
+ *  arena (arena). The same message is then decoded as it is read, from
+ *  16 bytes reads (incremental) and record by record (records). Read once
+ *  more, it is compared with its records encoded side by side, one payload
+ *  item of each in turn with its own cursor (interleaved). It is written
+ *  again, one payload byte changed, through a 256 bytes Write Message buffer
+ *  (write-buf).
+ *  For each operation the number of RF frames, the bytes on air, the
+ *  airtime and the elapsed time are reported, as CSV (default) or JSON.
+ *
+ *  Usage: ndef_bench [-j] [-t t2t|t3t|t3t-max|t4t|t4t-ext|t5t]
+ *
+ */
+
+/*
+******************************************************************************
+* INCLUDES
+******************************************************************************
+*/
+#include <stdio.h>
+#include "rfal_host_tags.h"
+#include "rfal_nfc.h"
+#include "ndef_class.h"
+
+/*
+******************************************************************************
+* LOCAL DEFINES
+******************************************************************************
+*/
+
+#define BENCH_SIZE_MIN            16U       /*!< Smallest NDEF message length                              */
+#define BENCH_SIZE_MAX            8192U     /*!< Largest NDEF message length                               */
+#define BENCH_BUF_LEN             (BENCH_SIZE_MAX + 256U)  /*!< Message buffers length, chunk headers included */
+#define BENCH_ACTIVATION_LOOPS    10000U    /*!< Max worker calls to reach the activated state             */
+#define BENCH_NDEF_SR_OVERHEAD    3U        /*!< Header, type length and 1 byte payload length             */
+#define BENCH_NDEF_OVERHEAD       6U        /*!< Header, type length and 4 bytes payload length            */
+
+#define BENCH_T2T_DATA_SIZE       1904U     /*!< T2T user memory (NTAG I2C 2k), 2 sectors                  */
+#define BENCH_T3T_BLOCKS          512U      /*!< T3T data blocks                                           */
+#define BENCH_T3T_MAX_NBR         15U       /*!< T3T Nbr of the t3t-max profile: CHECK limit               */
+#define BENCH_T3T_MAX_NBW         13U       /*!< T3T Nbw of the t3t-max profile: UPDATE limit              */
+#define BENCH_T4T_FILE_LEN        (BENCH_SIZE_MAX + 2U)    /*!< T4T NDEF file, NLEN included                 */
+#define BENCH_T4T_EXT_MLE         0x0400U   /*!< T4T MLe of the t4t-ext profile: extended Le               */
+#define BENCH_T4T_EXT_MLC         0x0400U   /*!< T4T MLc of the t4t-ext profile: extended Lc               */
+#define BENCH_MULTI_RECORDS_MAX   16U       /*!< Records of the multi-record message, more than NDEF_MAX_RECORD */
+#define BENCH_MULTI_RECORD_LEN    64U       /*!< Shortest record of the multi-record message               */
+#define BENCH_SHORT_READ_LEN      16U       /*!< Read length of the incremental decode                     */
+#define BENCH_DECODER_BUF_LEN     1024U     /*!< Incremental decoder buffer: one record and a read ahead   */
+#define BENCH_WRITE_BUF_LEN       256U      /*!< Write Message buffer                                      */
+#define BENCH_MULTI_TYPED_MIN     512U      /*!< Shortest multi-record message starting with Wi-Fi and vCard records */
+#define BENCH_CHUNK_LEN           256U      /*!< Payload length of the chunks of a chunked record          */
+#define BENCH_MB_HOST_TIME        rfalConvMsTo1fc(20U)     /*!< Mailbox: host response time                  */
+#define BENCH_MB_I2C_TIME         rfalConvMsTo1fc(5U)      /*!< Mailbox: host I2C access time                */
+#define BENCH_MB_TIMEOUT          100U      /*!< Mailbox channel timeout in ms                             */
+
+#define BENCH_FC_PER_US(t)        (((t) * 100U) / 1356U)   /*!< Convert 1/fc to us                           */
+
+/*
+******************************************************************************
+* LOCAL TYPES
+******************************************************************************
+*/
+
+/*! Tag profile */
+typedef struct {
+  const char *name;                 /*!< Tag type name                                  */
+  uint16_t    techs;                /*!< Technologies to poll for                       */
+} benchTag;
+
+/*! Result of an operation */
+typedef struct {
+  const char   *tag;                /*!< Tag type name                                  */
+  const char   *op;                 /*!< Operation name                                 */
+  uint32_t      size;               /*!< NDEF message length                            */
+  const char   *status;             /*!< Outcome: ok, nomem, mismatch or error          */
+  ReturnCode    err;                /*!< Error code of the operation                    */
+  rfalHostStats stats;              /*!< RF counters                                    */
+  uint64_t      elapsed;            /*!< Elapsed time in 1/fc                           */
+} benchResult;
+
+/*
+******************************************************************************
+* LOCAL VARIABLES
+******************************************************************************
+*/
+
+static RfalRfHostClass rfal_rf;
+static RfalNfcClass    rfal_nfc(&rfal_rf);
+static NdefClass       ndef(&rfal_nfc);
+
+static const benchTag benchTags[] = {
+  { "t2t", RFAL_NFC_POLL_TECH_A },
+  { "t3t", RFAL_NFC_POLL_TECH_F },
+  { "t3t-max", RFAL_NFC_POLL_TECH_F },
+  { "t4t", RFAL_NFC_POLL_TECH_A },
+  { "t4t-ext", RFAL_NFC_POLL_TECH_A },
+  { "t5t", RFAL_NFC_POLL_TECH_V },
+};
+
+static const uint8_t benchUid7[]    = { 0x04U, 0x51U, 0x8AU, 0x22U, 0xC3U, 0x5DU, 0x80U };
+static const uint8_t benchVersion[] = { 0x00U, 0x04U, 0x04U, 0x05U, 0x02U, 0x02U, 0x15U, 0x03U };
+static const uint8_t benchNfcid2[]  = { 0x02U, 0xFEU, 0x00U, 0x01U, 0x02U, 0x03U, 0x04U, 0x05U };
+static const uint8_t benchUidV[]    = { 0x6EU, 0x3AU, 0x52U, 0x14U, 0x26U, 0x51U, 0x02U, 0xE0U };
+static const uint8_t benchSsid[]    = "ndef-bench";
+static const uint8_t benchKey[]     = "0123456789abcdef";
+static const uint8_t benchVCardN[]  = "N";
+static const uint8_t benchVCardFN[] = "FN";
+static const uint8_t benchVCardTEL[] = "TEL";
+static const uint8_t benchName[]    = "Bench;Ndef";
+static const uint8_t benchFullName[] = "Ndef Bench";
+static const uint8_t benchPhone[]   = "+33123456789";
+
+static ndefConstBuffer benchVCardNone     = { NULL, 0U };
+static ndefConstBuffer benchVCardType[]   = { { benchVCardN, sizeof(benchVCardN) - 1U }, { benchVCardFN, sizeof(benchVCardFN) - 1U }, { benchVCardTEL, sizeof(benchVCardTEL) - 1U } };
+static ndefConstBuffer benchVCardValue[]  = { { benchName, sizeof(benchName) - 1U }, { benchFullName, sizeof(benchFullName) - 1U }, { benchPhone, sizeof(benchPhone) - 1U } };
+static const ndefVCardInput benchVCardInput[] = {
+  { &benchVCardType[0], &benchVCardNone, &benchVCardValue[0] },
+  { &benchVCardType[1], &benchVCardNone, &benchVCardValue[1] },
+  { &benchVCardType[2], &benchVCardNone, &benchVCardValue[2] },
+};
+
+static uint8_t benchPayload[BENCH_BUF_LEN];
+static uint8_t benchExpected[BENCH_BUF_LEN];
+static uint8_t benchRead[BENCH_BUF_LEN];
+static uint8_t benchEncoded[BENCH_BUF_LEN];
+static ndefRecord benchRecords[BENCH_MULTI_RECORDS_MAX];
+static ndefRecord benchArena[BENCH_MULTI_RECORDS_MAX];
+static ndefType   benchWifi;
+static ndefType   benchVCard;
+static uint8_t benchDecoder[BENCH_DECODER_BUF_LEN];
+static uint8_t benchWriteBuf[BENCH_WRITE_BUF_LEN];
+
+static bool    benchJson;
+static bool    benchFirst = true;
+
+/*
+******************************************************************************
+* LOCAL FUNCTION PROTOTYPES
+******************************************************************************
+*/
+
+static RfalHostTag *benchCreateTag(const char *name);
+static ReturnCode benchActivate(const benchTag *tag);
+static ReturnCode benchReinit(void);
+static bool benchCheckTag(const ndefBuffer *bufExpected);
+static void benchBegin(benchResult *res, const char *tag, const char *op, uint32_t size);
+static void benchEnd(benchResult *res, ReturnCode err);
+static void benchPrint(const benchResult *res);
+static ReturnCode benchMailbox(RfalHostT5TTag *hostTag, benchResult *res, uint32_t size);
+static bool benchCheckChunked(const ndefBuffer *bufExpected, const ndefConstBuffer *bufPayload);
+static uint32_t benchMultiMessage(ndefMessage *message, uint32_t size);
+static bool benchCheckMessage(const ndefMessage *message, uint32_t nbRecords, const ndefBuffer *bufExpected);
+static bool benchCheckInterleaved(const ndefMessage *message, const uint8_t *raw, uint32_t rawLen);
+static ReturnCode benchDecodeIncremental(bool perRecord, uint32_t messageLen, uint32_t nbRecords, const ndefBuffer *bufExpected, benchResult *res);
+static void benchRun(const benchTag *tag, uint32_t size);
+static void benchRunMulti(const benchTag *tag, uint32_t size);
+
+
+/*
+******************************************************************************
+* GLOBAL FUNCTIONS
+******************************************************************************
+*/
+
+/*******************************************************************************/
+int main(int argc, char **argv)
+{
+  const char *only = NULL;
+  uint32_t    size;
+  uint32_t    i;
+  int         a;
+
+  for (a = 1; a < argc; a++) {
+    if (strcmp(argv[a], "-j") == 0) {
+      benchJson = true;
+    } else if ((strcmp(argv[a], "-t") == 0) && ((a + 1) < argc)) {
+      a++;
+      only = argv[a];
+    } else {
+      fprintf(stderr, "Usage: %s [-j] [-t t2t|t3t|t3t-max|t4t|t4t-ext|t5t]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  for (i = 0; i < sizeof(benchPayload); i++) {
+    benchPayload[i] = (uint8_t)((i * 7U) + 3U);
+  }
+
+  if (benchJson) {
+    printf("[\n");
+  } else {
+    printf("tag,op,size,status,err,frames,timeouts,tx_bytes,rx_bytes,airtime_us,elapsed_us\n");
+  }
+
+  for (i = 0; i < (sizeof(benchTags) / sizeof(benchTags[0])); i++) {
+    if ((only != NULL) && (strcmp(only, benchTags[i].name) != 0)) {
+      continue;
+    }
+    for (size = BENCH_SIZE_MIN; size <= BENCH_SIZE_MAX; size *= 2U) {
+      benchRun(&benchTags[i], size);
+      benchRunMulti(&benchTags[i], size);
+    }
+  }
+
+  if (benchJson) {
+    printf("\n]\n");
+  }
+
+  return 0;
+}
+
+
+/*
+******************************************************************************
+* LOCAL FUNCTIONS
+******************************************************************************
+*/
+
+/*******************************************************************************/
+static RfalHostTag *benchCreateTag(const char *name)
+{
+  if (strcmp(name, "t2t") == 0) {
+    return new RfalHostT2TTag(benchUid7, BENCH_T2T_DATA_SIZE, benchVersion);
+  }
+  if (strcmp(name, "t3t") == 0) {
+    return new RfalHostT3TTag(benchNfcid2, BENCH_T3T_BLOCKS, RFAL_HOST_T3T_NBR_DEFAULT, RFAL_HOST_T3T_NBW_DEFAULT);
+  }
+  if (strcmp(name, "t3t-max") == 0) {
+    return new RfalHostT3TTag(benchNfcid2, BENCH_T3T_BLOCKS, BENCH_T3T_MAX_NBR, BENCH_T3T_MAX_NBW);
+  }
+  if (strcmp(name, "t4t") == 0) {
+    return new RfalHostT4TTag(benchUid7, BENCH_T4T_FILE_LEN, RFAL_HOST_T4T_MLE, RFAL_HOST_T4T_MLC);
+  }
+  if (strcmp(name, "t4t-ext") == 0) {
+    return new RfalHostT4TTag(benchUid7, BENCH_T4T_FILE_LEN, BENCH_T4T_EXT_MLE, BENCH_T4T_EXT_MLC);
+  }
+  return new RfalHostT5TTag(benchUidV, RFAL_HOST_T5T_BLOCK_LEN, RFAL_HOST_T5T_BLOCKS_DEFAULT);
+}
+
+
+/*******************************************************************************/
+static ReturnCode benchActivate(const benchTag *tag)
+{
+  rfalNfcDiscoverParam discParam;
+  rfalNfcDevice       *dev;
+  ReturnCode           err;
+  uint32_t             i;
+
+  ST_MEMSET(&discParam, 0x00, sizeof(discParam));
+  discParam.compMode      = RFAL_COMPLIANCE_MODE_NFC;
+  discParam.devLimit      = 1U;
+  discParam.nfcfBR        = RFAL_BR_212;
+  discParam.ap2pBR        = RFAL_BR_424;
+  discParam.techs2Find    = tag->techs;
+  discParam.totalDuration = 1000U;
+
+  EXIT_ON_ERR(err, rfal_nfc.rfalNfcInitialize());
+  EXIT_ON_ERR(err, rfal_nfc.rfalNfcDiscover(&discParam));
+
+  for (i = 0; i < BENCH_ACTIVATION_LOOPS; i++) {
+    rfal_nfc.rfalNfcWorker();
+    if (rfalNfcIsDevActivated(rfal_nfc.rfalNfcGetState())) {
+      EXIT_ON_ERR(err, rfal_nfc.rfalNfcGetActiveDevice(&dev));
+      return ndef.ndefPollerContextInitialization(dev);
+    }
+  }
+
+  return ERR_TIMEOUT;
+}
+
+
+/*******************************************************************************/
+static ReturnCode benchReinit(void)
+{
+  rfalNfcDevice       *dev;
+  ReturnCode           err;
+
+  EXIT_ON_ERR(err, rfal_nfc.rfalNfcGetActiveDevice(&dev));
+  return ndef.ndefPollerContextInitialization(dev);
+}
+
+
+/*******************************************************************************/
+static bool benchCheckTag(const ndefBuffer *bufExpected)
+{
+  ndefInfo             info;
+  uint32_t             rcvdLen;
+
+  /* New session, so that the message is read from the tag */
+  if ((benchReinit() != ERR_NONE) || (ndef.ndefPollerNdefDetect(&info) != ERR_NONE)) {
+    return false;
+  }
+  if (ndef.ndefPollerReadRawMessage(benchRead, sizeof(benchRead), &rcvdLen) != ERR_NONE) {
+    return false;
+  }
+  return ((rcvdLen == bufExpected->length) && (ST_BYTECMP(benchRead, bufExpected->buffer, rcvdLen) == 0));
+}
+
+
+/*******************************************************************************/
+static void benchBegin(benchResult *res, const char *tag, const char *op, uint32_t size)
+{
+  ST_MEMSET(res, 0x00, sizeof(benchResult));
+  res->tag  = tag;
+  res->op   = op;
+  res->size = size;
+
+  rfal_rf.rfalHostClearStats();
+  res->elapsed = rfalHostGetTime();
+}
+
+
+/*******************************************************************************/
+static void benchEnd(benchResult *res, ReturnCode err)
+{
+  res->elapsed = (rfalHostGetTime() - res->elapsed);
+  rfal_rf.rfalHostGetStats(&res->stats);
+
+  res->err = err;
+  if (res->status == NULL) {
+    res->status = ((err == ERR_NONE) ? "ok" : ((err == ERR_NOMEM) ? "nomem" : "error"));
+  }
+}
+
+
+/*******************************************************************************/
+static void benchPrint(const benchResult *res)
+{
+  unsigned long long airtime = BENCH_FC_PER_US(res->stats.txTime + res->stats.rxTime);
+  unsigned long long elapsed = BENCH_FC_PER_US(res->elapsed);
+
+  if (benchJson) {
+    printf("%s  {\"tag\": \"%s\", \"op\": \"%s\", \"size\": %u, \"status\": \"%s\", \"err\": %u, "
+           "\"frames\": %u, \"timeouts\": %u, \"tx_bytes\": %u, \"rx_bytes\": %u, \"airtime_us\": %llu, \"elapsed_us\": %llu}",
+           (benchFirst ? "" : ",\n"), res->tag, res->op, (unsigned)res->size, res->status, (unsigned)res->err,
+           (unsigned)res->stats.frames, (unsigned)res->stats.timeouts, (unsigned)res->stats.txBytes, (unsigned)res->stats.rxBytes,
+           airtime, elapsed);
+  } else {
+    printf("%s,%s,%u,%s,%u,%u,%u,%u,%u,%llu,%llu\n",
+           res->tag, res->op, (unsigned)res->size, res->status, (unsigned)res->err,
+           (unsigned)res->stats.frames, (unsigned)res->stats.timeouts, (unsigned)res->stats.txBytes, (unsigned)res->stats.rxBytes,
+           airtime, elapsed);
+  }
+  benchFirst = false;
+}
+
+
+/*******************************************************************************/
+static bool benchCheckChunked(const ndefBuffer *bufExpected, const ndefConstBuffer *bufPayload)
+{
+  ndefMessageDecoder dec;
+  ndefRecord         chunk;
+  ndefConstBuffer    bufChunkPayload;
+  ndefBuffer         bufEncoded;
+  ndefInfo           info;
+  ReturnCode         err;
+  uint32_t           offset;
+  uint32_t           payloadOffset;
+
+  /* New session, the record read chunk by chunk into a decoder buffer shorter than the record */
+  if ((benchReinit() != ERR_NONE) || (ndef.ndefPollerNdefDetect(&info) != ERR_NONE) ||
+      (ndef.ndefMessageDecoderInit(&dec, benchDecoder, sizeof(benchDecoder)) != ERR_NONE)) {
+    return false;
+  }
+
+  offset        = 0U;
+  payloadOffset = 0U;
+  for (;;) {
+    err = ndef.ndefPollerReadRecord(&dec, &chunk);
+    if (err == ERR_DONE) {
+      break;
+    }
+    if (err != ERR_NONE) {
+      return false;
+    }
+
+    /* Chunk as written on the tag, its payload the next part of the record payload */
+    bufEncoded.buffer = benchEncoded;
+    bufEncoded.length = sizeof(benchEncoded);
+    (void)ndef.ndefRecordGetPayload(&chunk, &bufChunkPayload);
+    if ((ndef.ndefRecordEncode(&chunk, &bufEncoded) != ERR_NONE) || ((offset + bufEncoded.length) > bufExpected->length) ||
+        (ST_BYTECMP(benchEncoded, &bufExpected->buffer[offset], bufEncoded.length) != 0) ||
+        ((payloadOffset + bufChunkPayload.length) > bufPayload->length) ||
+        (ST_BYTECMP(bufChunkPayload.buffer, &bufPayload->buffer[payloadOffset], bufChunkPayload.length) != 0)) {
+      return false;
+    }
+    offset        += bufEncoded.length;
+    payloadOffset += bufChunkPayload.length;
+
+    /* Only the next chunk is kept in the decoder buffer */
+    (void)ndef.ndefMessageDecoderCompact(&dec);
+  }
+
+  return ((offset == bufExpected->length) && (payloadOffset == bufPayload->length));
+}
+
+
+/*******************************************************************************/
+static ReturnCode benchMailbox(RfalHostT5TTag *hostTag, benchResult *res, uint32_t size)
+{
+  rfalST25xVMbChannel ch;
+  const uint8_t      *chunk;
+  const uint8_t      *hostData;
+  ReturnCode          err;
+  uint32_t            hostLen;
+  uint32_t            it;
+  uint32_t            len;
+  uint16_t            chunkLen;
+
+  /* Reader enables the Mailbox, the host side echoes every message back */
+  hostTag->mbConfigure(BENCH_MB_HOST_TIME, BENCH_MB_I2C_TIME, true);
+  EXIT_ON_ERR(err, rfal_nfc.rfalST25xVPollerWriteDynamicConfiguration(RFAL_NFCV_REQ_FLAG_DEFAULT, benchUidV, RFAL_ST25DV_MB_CTRL_DYN, RFAL_ST25DV_MB_CTRL_MB_EN));
+  EXIT_ON_ERR(err, rfal_nfc.rfalST25xVMbChannelInit(&ch, RFAL_NFCV_REQ_FLAG_DEFAULT, benchUidV, false, BENCH_MB_TIMEOUT));
+
+  it = 0;
+  while (it < size) {
+    len = MIN((size - it), RFAL_ST25DV_MB_CHUNK_MAX_LEN);
+    if ((size - it - len) == 1U) {
+      len--;
+    }
+    EXIT_ON_ERR(err, rfal_nfc.rfalST25xVMbChannelSend(&ch, &benchPayload[it], len));
+    EXIT_ON_ERR(err, rfal_nfc.rfalST25xVMbChannelReceive(&ch, &chunk, &chunkLen));
+    if ((chunkLen != len) || (ST_BYTECMP(chunk, &benchPayload[it], len) != 0)) {
+      res->status = "mismatch";
+    }
+    it += len;
+  }
+
+  hostData = hostTag->mbGetHostData(&hostLen);
+  if ((hostLen != size) || (ST_BYTECMP(hostData, benchPayload, size) != 0)) {
+    res->status = "mismatch";
+  }
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+static void benchRun(const benchTag *tag, uint32_t size)
+{
+  RfalHostTag    *hostTag;
+  benchResult     res;
+  ndefRecord      record;
+  ndefMessage     message;
+  ndefConstBuffer bufPayload;
+  ndefConstBuffer8 bufType;
+  ndefBuffer      bufExpected;
+  ndefInfo        info;
+  ReturnCode      err;
+  uint32_t        rcvdLen;
+
+  /* Single record message of the requested length */
+  bufType.buffer    = NULL;
+  bufType.length    = 0U;
+  bufPayload.buffer = benchPayload;
+  bufPayload.length = (size - (((size - BENCH_NDEF_SR_OVERHEAD) <= NDEF_SHORT_RECORD_LENGTH_MAX) ? BENCH_NDEF_SR_OVERHEAD : BENCH_NDEF_OVERHEAD));
+  (void)ndef.ndefRecordInit(&record, NDEF_TNF_UNKNOWN, &bufType, NULL, &bufPayload);
+  (void)ndef.ndefMessageInit(&message);
+  (void)ndef.ndefMessageAppend(&message, &record);
+  bufExpected.buffer = benchExpected;
+  bufExpected.length = sizeof(benchExpected);
+  (void)ndef.ndefMessageEncode(&message, &bufExpected);
+
+  /* Fresh tag, activated outside of the measurements */
+  hostTag = benchCreateTag(tag->name);
+  rfal_rf.rfalHostSetTag(hostTag);
+  err = benchActivate(tag);
+  if (err == ERR_NONE) {
+    err = ndef.ndefPollerNdefDetect(&info);
+  }
+  if (err != ERR_NONE) {
+    benchBegin(&res, tag->name, "activate", size);
+    benchEnd(&res, err);
+    benchPrint(&res);
+  } else {
+    benchBegin(&res, tag->name, "format", size);
+    benchEnd(&res, ndef.ndefPollerTagFormat(NULL, 0U));
+    benchPrint(&res);
+
+    benchBegin(&res, tag->name, "write", size);
+    err = ndef.ndefPollerWriteMessage(&message);
+    benchEnd(&res, (((err == ERR_PARAM) && (ndef.ndefPollerCheckAvailableSpace(bufExpected.length) == ERR_NOMEM)) ? ERR_NOMEM : err));
+    benchPrint(&res);
+
+    if (err == ERR_NONE) {
+      /* New session: only what the poller keeps across taps survives the write */
+      benchBegin(&res, tag->name, "reinit", size);
+      err = benchReinit();
+      benchEnd(&res, err);
+      benchPrint(&res);
+    }
+    if (err == ERR_NONE) {
+      benchBegin(&res, tag->name, "detect", size);
+      err = ndef.ndefPollerNdefDetect(&info);
+      if ((err == ERR_NONE) && (info.messageLen != bufExpected.length)) {
+        res.status = "mismatch";
+      }
+      benchEnd(&res, err);
+      benchPrint(&res);
+
+      benchBegin(&res, tag->name, "read", size);
+      rcvdLen = 0U;
+      err     = ndef.ndefPollerReadRawMessage(benchRead, sizeof(benchRead), &rcvdLen);
+      if ((err == ERR_NONE) && ((rcvdLen != bufExpected.length) || (ST_BYTECMP(benchRead, benchExpected, rcvdLen) != 0))) {
+        res.status = "mismatch";
+      }
+      benchEnd(&res, err);
+      benchPrint(&res);
+
+      benchBegin(&res, tag->name, "reread", size);
+      rcvdLen = 0U;
+      err     = ndef.ndefPollerReadRawMessage(benchRead, sizeof(benchRead), &rcvdLen);
+      if ((err == ERR_NONE) && ((rcvdLen != bufExpected.length) || (ST_BYTECMP(benchRead, benchExpected, rcvdLen) != 0))) {
+        res.status = "mismatch";
+      }
+      benchEnd(&res, err);
+      benchPrint(&res);
+
+      /* Same message with one payload byte changed, written in differential mode */
+      benchPayload[bufPayload.length / 2U] ^= 0xFFU;
+      bufExpected.length = sizeof(benchExpected);
+      (void)ndef.ndefMessageEncode(&message, &bufExpected);
+      ndef.ndefPollerSetDifferentialWrite(true);
+
+      benchBegin(&res, tag->name, "update", size);
+      err = ndef.ndefPollerWriteMessage(&message);
+      benchEnd(&res, err);
+      ndef.ndefPollerSetDifferentialWrite(false);
+      if ((err == ERR_NONE) && !benchCheckTag(&bufExpected)) {
+        res.status = "mismatch";
+      }
+      benchPrint(&res);
+      benchPayload[bufPayload.length / 2U] ^= 0xFFU;
+
+      /* Same message, its record written as chunks */
+      bufExpected.length = sizeof(benchExpected);
+      (void)ndef.ndefMessageEncodeChunked(&message, BENCH_CHUNK_LEN, &bufExpected);
+      ndef.ndefPollerSetChunkLength(BENCH_CHUNK_LEN);
+
+      benchBegin(&res, tag->name, "chunked", size);
+      err = ndef.ndefPollerWriteMessage(&message);
+      benchEnd(&res, (((err == ERR_PARAM) && (ndef.ndefPollerCheckAvailableSpace(bufExpected.length) == ERR_NOMEM)) ? ERR_NOMEM : err));
+      ndef.ndefPollerSetChunkLength(0U);
+      if ((err == ERR_NONE) && !benchCheckChunked(&bufExpected, &bufPayload)) {
+        res.status = "mismatch";
+      }
+      benchPrint(&res);
+    }
+
+    if (hostTag->getMode() == RFAL_MODE_POLL_NFCV) {
+      /* Payload streamed to the host side through the Mailbox and back */
+      benchBegin(&res, tag->name, "mailbox", size);
+      err = benchMailbox(static_cast<RfalHostT5TTag *>(hostTag), &res, size);
+      benchEnd(&res, err);
+      benchPrint(&res);
+    }
+  }
+
+  (void)rfal_nfc.rfalNfcDeactivate(false);
+  rfal_rf.rfalHostSetTag(NULL);
+  delete hostTag;
+}
+
+
+/*******************************************************************************/
+static uint32_t benchMultiMessage(ndefMessage *message, uint32_t size)
+{
+  ndefConstBuffer  bufPayload;
+  ndefConstBuffer8 bufType;
+  ndefTypeWifi     wifiConfig;
+  uint32_t         nbRecords;
+  uint32_t         nbTyped;
+  uint32_t         recordLen;
+  uint32_t         left;
+  uint32_t         offset;
+  uint32_t         i;
+
+  /* Records of about the same length, the message being size bytes long */
+  nbRecords = MIN(MAX((size / BENCH_MULTI_RECORD_LEN), 2U), BENCH_MULTI_RECORDS_MAX);
+
+  (void)ndef.ndefMessageInit(message);
+  left    = size;
+  nbTyped = 0U;
+  if (size >= BENCH_MULTI_TYPED_MIN) {
+    /* Wi-Fi and vCard records first, their payload built item by item when encoded */
+    wifiConfig.bufNetworkSSID.buffer = benchSsid;
+    wifiConfig.bufNetworkSSID.length = (sizeof(benchSsid) - 1U);
+    wifiConfig.bufNetworkKey.buffer  = benchKey;
+    wifiConfig.bufNetworkKey.length  = (sizeof(benchKey) - 1U);
+    wifiConfig.authentication        = NDEF_WIFI_AUTHENTICATION_WPA2PSK;
+    wifiConfig.encryption            = NDEF_WIFI_ENCRYPTION_AES;
+    (void)ndef.ndefWifi(&benchWifi, &wifiConfig);
+    (void)ndef.ndefWifiToRecord(&benchWifi, &benchRecords[0]);
+    (void)ndef.ndefVCard(&benchVCard, benchVCardInput, (sizeof(benchVCardInput) / sizeof(benchVCardInput[0])));
+    (void)ndef.ndefVCardToRecord(&benchVCard, &benchRecords[1]);
+    for (nbTyped = 0U; nbTyped < 2U; nbTyped++) {
+      (void)ndef.ndefMessageAppend(message, &benchRecords[nbTyped]);
+      left -= ndef.ndefRecordGetLength(&benchRecords[nbTyped]);
+    }
+  }
+
+  bufType.buffer = NULL;
+  bufType.length = 0U;
+  offset = 0U;
+  for (i = nbTyped; i < nbRecords; i++) {
+    recordLen         = ((i == (nbRecords - 1U)) ? (left - offset) : (left / (nbRecords - nbTyped)));
+    bufPayload.buffer = &benchPayload[offset];
+    bufPayload.length = (recordLen - (((recordLen - BENCH_NDEF_SR_OVERHEAD) <= NDEF_SHORT_RECORD_LENGTH_MAX) ? BENCH_NDEF_SR_OVERHEAD : BENCH_NDEF_OVERHEAD));
+    (void)ndef.ndefRecordInit(&benchRecords[i], NDEF_TNF_UNKNOWN, &bufType, NULL, &bufPayload);
+    (void)ndef.ndefMessageAppend(message, &benchRecords[i]);
+    offset += recordLen;
+  }
+
+  return nbRecords;
+}
+
+
+/*******************************************************************************/
+static bool benchCheckMessage(const ndefMessage *message, uint32_t nbRecords, const ndefBuffer *bufExpected)
+{
+  ndefMessageInfo info;
+  ndefBuffer      bufEncoded;
+
+  /* Same records, encoded back to the bytes written on the tag */
+  (void)ndef.ndefMessageGetInfo(message, &info);
+  bufEncoded.buffer = benchEncoded;
+  bufEncoded.length = sizeof(benchEncoded);
+  if ((info.recordCount != nbRecords) || (ndef.ndefMessageEncode(message, &bufEncoded) != ERR_NONE)) {
+    return false;
+  }
+  return ((bufEncoded.length == bufExpected->length) && (ST_BYTECMP(benchEncoded, bufExpected->buffer, bufEncoded.length) == 0));
+}
+
+
+/*******************************************************************************/
+static bool benchCheckInterleaved(const ndefMessage *message, const uint8_t *raw, uint32_t rawLen)
+{
+  ndefPayloadItemCursor cursor[BENCH_MULTI_RECORDS_MAX];
+  const ndefRecord     *record[BENCH_MULTI_RECORDS_MAX];
+  uint32_t              pos[BENCH_MULTI_RECORDS_MAX];
+  uint32_t              end[BENCH_MULTI_RECORDS_MAX];
+  bool                  begin[BENCH_MULTI_RECORDS_MAX];
+  const ndefRecord     *rec;
+  ndefConstBuffer       bufItem;
+  ndefBuffer            bufHeader;
+  uint32_t              nbRecords;
+  uint32_t              active;
+  uint32_t              offset;
+  uint32_t              i;
+
+  /* Record headers, types and Ids, leaving room for each payload */
+  nbRecords = 0U;
+  offset    = 0U;
+  for (rec = ndefMessageGetFirstRecord(message); rec != NULL; rec = ndefMessageGetNextRecord(rec)) {
+    if ((nbRecords == BENCH_MULTI_RECORDS_MAX) || ((offset + ndef.ndefRecordGetLength(rec)) > sizeof(benchEncoded))) {
+      return false;
+    }
+    bufHeader.buffer = &benchEncoded[offset];
+    bufHeader.length = (sizeof(benchEncoded) - offset);
+    (void)ndef.ndefRecordEncodeHeader(rec, &bufHeader);
+    offset += bufHeader.length;
+    (void)ST_MEMCPY(&benchEncoded[offset], rec->type, rec->typeLength);
+    offset += rec->typeLength;
+    (void)ST_MEMCPY(&benchEncoded[offset], rec->id, rec->idLength);
+    offset += rec->idLength;
+
+    record[nbRecords] = rec;
+    pos[nbRecords]    = offset;
+    begin[nbRecords]  = true;
+    offset           += ndef.ndefRecordGetPayloadLength(rec);
+    end[nbRecords]    = offset;
+    nbRecords++;
+  }
+
+  /* One payload item of each record in turn, every record with its own cursor */
+  active = nbRecords;
+  while (active > 0U) {
+    active = 0U;
+    for (i = 0U; i < nbRecords; i++) {
+      if ((record[i] == NULL) || (ndef.ndefRecordGetPayloadItem(record[i], &bufItem, &cursor[i], begin[i]) == NULL)) {
+        record[i] = NULL;
+        continue;
+      }
+      if ((pos[i] + bufItem.length) > end[i]) {
+        return false;
+      }
+      (void)ST_MEMCPY(&benchEncoded[pos[i]], bufItem.buffer, bufItem.length);
+      pos[i]   += bufItem.length;
+      begin[i]  = false;
+      active++;
+    }
+  }
+
+  for (i = 0U; i < nbRecords; i++) {
+    if (pos[i] != end[i]) {
+      return false;
+    }
+  }
+  return ((offset == rawLen) && (ST_BYTECMP(benchEncoded, raw, rawLen) == 0));
+}
+
+
+/*******************************************************************************/
+static ReturnCode benchDecodeIncremental(bool perRecord, uint32_t messageLen, uint32_t nbRecords, const ndefBuffer *bufExpected, benchResult *res)
+{
+  ndefMessageDecoder dec;
+  ndefRecord         record;
+  ndefBuffer         bufEncoded;
+  ReturnCode         err;
+  uint32_t           pos;
+  uint32_t           offset;
+  uint32_t           count;
+  uint32_t           len;
+  uint32_t           rcvdLen;
+
+  EXIT_ON_ERR(err, ndef.ndefMessageDecoderInit(&dec, benchDecoder, sizeof(benchDecoder)));
+
+  pos    = 0U;
+  offset = 0U;
+  count  = 0U;
+  for (;;) {
+    if (perRecord) {
+      err = ndef.ndefPollerReadRecord(&dec, &record);
+    } else {
+      err = ndef.ndefMessageDecoderGetRecord(&dec, &record, NULL);
+      if (err == ERR_AGAIN) {
+        /* Next short read pushed in place, until the message end */
+        if (pos >= messageLen) {
+          return ERR_PROTO;
+        }
+        len = MIN(BENCH_SHORT_READ_LEN, (messageLen - pos));
+        EXIT_ON_ERR(err, ndef.ndefPollerReadBytes((ndef.messageOffset + pos), len, &dec.buffer[dec.fill], &rcvdLen));
+        EXIT_ON_ERR(err, ndef.ndefMessageDecoderPush(&dec, &dec.buffer[dec.fill], MIN(rcvdLen, len)));
+        pos += len;
+        continue;
+      }
+    }
+    if (err == ERR_DONE) {
+      break;
+    }
+    if (err != ERR_NONE) {
+      return err;
+    }
+
+    /* Each record encoded back to the bytes written on the tag */
+    bufEncoded.buffer = benchEncoded;
+    bufEncoded.length = sizeof(benchEncoded);
+    if ((ndef.ndefRecordEncode(&record, &bufEncoded) != ERR_NONE) || ((offset + bufEncoded.length) > bufExpected->length) ||
+        (ST_BYTECMP(benchEncoded, &bufExpected->buffer[offset], bufEncoded.length) != 0)) {
+      res->status = "mismatch";
+    }
+    offset += bufEncoded.length;
+    count++;
+
+    /* The decoder buffer only holds the record being decoded */
+    (void)ndef.ndefMessageDecoderCompact(&dec);
+  }
+
+  if ((count != nbRecords) || (offset != bufExpected->length)) {
+    res->status = "mismatch";
+  }
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+static void benchRunMulti(const benchTag *tag, uint32_t size)
+{
+  RfalHostTag    *hostTag;
+  benchResult     res;
+  ndefMessage     message;
+  ndefMessage     decoded;
+  ndefRecordArena arena;
+  ndefBuffer      bufExpected;
+  ndefConstBuffer bufRaw;
+  ndefInfo        info;
+  ReturnCode      err;
+  uint32_t        nbRecords;
+  uint32_t        rcvdLen;
+
+  /* Message of more records than the internal pool holds */
+  nbRecords          = benchMultiMessage(&message, size);
+  bufExpected.buffer = benchExpected;
+  bufExpected.length = sizeof(benchExpected);
+  (void)ndef.ndefMessageEncode(&message, &bufExpected);
+
+  /* Fresh tag holding the message, written outside of the measurements */
+  hostTag = benchCreateTag(tag->name);
+  rfal_rf.rfalHostSetTag(hostTag);
+  err = benchActivate(tag);
+  if (err == ERR_NONE) {
+    err = ndef.ndefPollerNdefDetect(&info);
+  }
+  if (err == ERR_NONE) {
+    err = ndef.ndefPollerWriteMessage(&message);
+    if ((err == ERR_PARAM) && (ndef.ndefPollerCheckAvailableSpace(bufExpected.length) == ERR_NOMEM)) {
+      err = ERR_NOMEM;
+    }
+  }
+  if ((err == ERR_NONE) && !benchCheckTag(&bufExpected)) {
+    err = ERR_PROTO;
+  }
+
+  if (err != ERR_NONE) {
+    benchBegin(&res, tag->name, "arena", size);
+    benchEnd(&res, err);
+    benchPrint(&res);
+  } else {
+    /* Whole message read, its records taken from a caller-supplied arena */
+    benchBegin(&res, tag->name, "arena", size);
+    rcvdLen = 0U;
+    err     = ndef.ndefPollerReadRawMessage(benchRead, sizeof(benchRead), &rcvdLen);
+    if (err == ERR_NONE) {
+      bufRaw.buffer = benchRead;
+      bufRaw.length = rcvdLen;
+      (void)ndef.ndefRecordArenaInit(&arena, benchArena, BENCH_MULTI_RECORDS_MAX);
+      err = ndef.ndefMessageDecodeArena(&bufRaw, &decoded, &arena);
+    }
+    benchEnd(&res, err);
+    if ((err == ERR_NONE) && !benchCheckMessage(&decoded, nbRecords, &bufExpected)) {
+      res.status = "mismatch";
+    }
+    benchPrint(&res);
+
+    /* Message decoded as short reads of the tag come in, new session */
+    err = benchReinit();
+    if (err == ERR_NONE) {
+      err = ndef.ndefPollerNdefDetect(&info);
+    }
+    benchBegin(&res, tag->name, "incremental", size);
+    if (err == ERR_NONE) {
+      err = benchDecodeIncremental(false, info.messageLen, nbRecords, &bufExpected, &res);
+    }
+    benchEnd(&res, err);
+    benchPrint(&res);
+
+    /* Records read from the tag one at a time, new session */
+    err = benchReinit();
+    if (err == ERR_NONE) {
+      err = ndef.ndefPollerNdefDetect(&info);
+    }
+    benchBegin(&res, tag->name, "records", size);
+    if (err == ERR_NONE) {
+      err = benchDecodeIncremental(true, info.messageLen, nbRecords, &bufExpected, &res);
+    }
+    benchEnd(&res, err);
+    benchPrint(&res);
+
+    /* Message read back, compared with the records encoded side by side, new session */
+    err = benchReinit();
+    if (err == ERR_NONE) {
+      err = ndef.ndefPollerNdefDetect(&info);
+    }
+    benchBegin(&res, tag->name, "interleaved", size);
+    rcvdLen = 0U;
+    if (err == ERR_NONE) {
+      err = ndef.ndefPollerReadRawMessage(benchRead, sizeof(benchRead), &rcvdLen);
+    }
+    benchEnd(&res, err);
+    if ((err == ERR_NONE) && !benchCheckInterleaved(&message, benchRead, rcvdLen)) {
+      res.status = "mismatch";
+    }
+    benchPrint(&res);
+
+    /* Message with one payload byte changed, serialized through the Write Message buffer */
+    benchPayload[size / 2U] ^= 0xFFU;
+    bufExpected.length = sizeof(benchExpected);
+    (void)ndef.ndefMessageEncode(&message, &bufExpected);
+    ndef.ndefPollerSetWriteBuffer(benchWriteBuf, sizeof(benchWriteBuf));
+
+    benchBegin(&res, tag->name, "write-buf", size);
+    err = ndef.ndefPollerWriteMessage(&message);
+    benchEnd(&res, err);
+    ndef.ndefPollerSetWriteBuffer(NULL, 0U);
+    if ((err == ERR_NONE) && !benchCheckTag(&bufExpected)) {
+      res.status = "mismatch";
+    }
+    benchPrint(&res);
+    benchPayload[size / 2U] ^= 0xFFU;
+  }
+
+  (void)rfal_nfc.rfalNfcDeactivate(false);
+  rfal_rf.rfalHostSetTag(NULL);
+  delete hostTag;
+}
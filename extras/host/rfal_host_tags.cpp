@@ -0,0 +1,1771 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT 2021 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MIX MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/mix_myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+/*! \file
+ *
+ *  \author SRA
+ *
+ *  \brief RFAL host tag models
+ *
+ */
+
+/*
+******************************************************************************
+* INCLUDES
+******************************************************************************
+*/
+#include "rfal_host_tags.h"
+#include "rfal_nfcf.h"
+#include "rfal_nfcv.h"
+#include "rfal_st25xv.h"
+#include "nfc_utils.h"
+
+/*
+******************************************************************************
+* LOCAL DEFINES
+******************************************************************************
+*/
+
+#define RFAL_HOST_NFCA_STATE_IDLE         0U        /*!< ISO14443-3A IDLE state                                    */
+#define RFAL_HOST_NFCA_STATE_READY        1U        /*!< ISO14443-3A READY state                                   */
+#define RFAL_HOST_NFCA_STATE_ACTIVE       2U        /*!< ISO14443-3A ACTIVE state                                  */
+#define RFAL_HOST_NFCA_STATE_HALT         3U        /*!< ISO14443-3A HALT state                                    */
+
+#define RFAL_HOST_NFCA_CMD_REQA           0x26U     /*!< REQA (SENS_REQ)                                           */
+#define RFAL_HOST_NFCA_CMD_WUPA           0x52U     /*!< WUPA (ALL_REQ)                                            */
+#define RFAL_HOST_NFCA_CMD_HLTA           0x50U     /*!< HLTA (SLP_REQ)                                            */
+#define RFAL_HOST_NFCA_SEL_CL1            0x93U     /*!< SEL command of cascade level 1                            */
+#define RFAL_HOST_NFCA_NVB_SDD            0x20U     /*!< NVB of a SDD_REQ with no UID bits                         */
+#define RFAL_HOST_NFCA_NVB_SEL            0x70U     /*!< NVB of a SEL_REQ                                          */
+#define RFAL_HOST_NFCA_CT                 0x88U     /*!< Cascade Tag                                               */
+#define RFAL_HOST_NFCA_SAK_CASCADE        0x04U     /*!< SAK: UID not complete                                     */
+#define RFAL_HOST_NFCA_CLN_LEN            4U        /*!< Length of the UID part of a cascade level                 */
+
+#define RFAL_HOST_T2T_CMD_READ            0x30U     /*!< T2T READ                                                  */
+#define RFAL_HOST_T2T_CMD_WRITE           0xA2U     /*!< T2T WRITE                                                 */
+#define RFAL_HOST_T2T_CMD_SECTOR_SELECT   0xC2U     /*!< T2T SECTOR_SELECT                                         */
+#define RFAL_HOST_T2T_CMD_GET_VERSION     0x60U     /*!< NTAG GET_VERSION                                          */
+#define RFAL_HOST_T2T_CMD_FAST_READ       0x3AU     /*!< NTAG FAST_READ                                            */
+#define RFAL_HOST_T2T_ACK                 0x0AU     /*!< 4 bits ACK                                                */
+#define RFAL_HOST_T2T_NAK                 0x00U     /*!< 4 bits NAK: invalid argument                              */
+#define RFAL_HOST_T2T_ACK_BITS            4U        /*!< ACK/NAK length in bits                                    */
+#define RFAL_HOST_T2T_HDR_PAGES           4U        /*!< UID, lock and CC pages                                    */
+#define RFAL_HOST_T2T_CFG_PAGES           5U        /*!< Dynamic lock and configuration pages (NTAG)               */
+#define RFAL_HOST_T2T_STATIC_SIZE         48U       /*!< Data area size without dynamic memory structure           */
+
+#define RFAL_HOST_ISODEP_RATS             0xE0U     /*!< RATS command                                              */
+#define RFAL_HOST_ISODEP_PPS_MASK         0xF0U     /*!< PPSS mask                                                 */
+#define RFAL_HOST_ISODEP_PPS              0xD0U     /*!< PPSS start byte                                           */
+#define RFAL_HOST_ISODEP_I_BLOCK          0x02U     /*!< I-block PCB                                               */
+#define RFAL_HOST_ISODEP_R_ACK            0xA2U     /*!< R(ACK) PCB                                                */
+#define RFAL_HOST_ISODEP_S_DESELECT       0xC2U     /*!< S(DESELECT) PCB                                           */
+#define RFAL_HOST_ISODEP_S_WTX            0xF2U     /*!< S(WTX) PCB                                                */
+#define RFAL_HOST_ISODEP_PCB_MASK_I       0xE2U     /*!< Mask identifying an I-block                               */
+#define RFAL_HOST_ISODEP_PCB_MASK_R       0xE6U     /*!< Mask identifying a R-block                                */
+#define RFAL_HOST_ISODEP_PCB_MASK_S       0xC7U     /*!< Mask identifying a S-block                                */
+#define RFAL_HOST_ISODEP_PCB_CHAINING     0x10U     /*!< I-block chaining bit                                      */
+#define RFAL_HOST_ISODEP_PCB_NAK          0x10U     /*!< R-block NAK bit                                           */
+#define RFAL_HOST_ISODEP_PCB_CID          0x08U     /*!< CID following bit                                         */
+#define RFAL_HOST_ISODEP_PCB_BN           0x01U     /*!< Block number bit                                          */
+#define RFAL_HOST_ISODEP_S_TYPE_MASK      0x30U     /*!< S-block type bits                                         */
+#define RFAL_HOST_ISODEP_WTXM_MAX         59U       /*!< Maximum WTXM                                              */
+#define RFAL_HOST_ISODEP_PROLOGUE_CRC     3U        /*!< PCB and CRC length                                        */
+#define RFAL_HOST_ISODEP_FWT(fwi)         ((uint32_t)4096U << (fwi))   /*!< FWT from FWI in 1/fc                   */
+
+#define RFAL_HOST_T4T_SW_OK               0x9000U   /*!< Command completed                                         */
+#define RFAL_HOST_T4T_SW_NOT_FOUND        0x6A82U   /*!< File or application not found                             */
+#define RFAL_HOST_T4T_SW_NOT_ALLOWED      0x6986U   /*!< Command not allowed, no current EF                        */
+#define RFAL_HOST_T4T_SW_WRONG_PARAM      0x6B00U   /*!< Wrong parameters P1-P2 / offset                           */
+#define RFAL_HOST_T4T_SW_WRONG_INS        0x6D00U   /*!< Instruction not supported                                 */
+#define RFAL_HOST_T4T_SW_WRONG_CLA        0x6E00U   /*!< Class not supported                                       */
+#define RFAL_HOST_T4T_SW_SECURITY         0x6982U   /*!< Security status not satisfied                             */
+#define RFAL_HOST_T4T_SW_WRONG_LEN        0x6700U   /*!< Wrong length                                              */
+#define RFAL_HOST_T4T_INS_SELECT          0xA4U     /*!< SELECT                                                    */
+#define RFAL_HOST_T4T_INS_READ            0xB0U     /*!< READ BINARY                                               */
+#define RFAL_HOST_T4T_INS_READ_ODO        0xB1U     /*!< READ BINARY with ODO                                      */
+#define RFAL_HOST_T4T_INS_UPDATE          0xD6U     /*!< UPDATE BINARY                                             */
+#define RFAL_HOST_T4T_INS_UPDATE_ODO      0xD7U     /*!< UPDATE BINARY with ODO                                    */
+#define RFAL_HOST_T4T_CC_FID              0xE103U   /*!< CC file identifier                                        */
+#define RFAL_HOST_T4T_NDEF_FID            0xE104U   /*!< NDEF file identifier                                      */
+#define RFAL_HOST_T4T_FILE_NONE           0U        /*!< No file selected                                          */
+#define RFAL_HOST_T4T_FILE_CC             1U        /*!< CC file selected                                          */
+#define RFAL_HOST_T4T_FILE_NDEF           2U        /*!< NDEF file selected                                        */
+#define RFAL_HOST_T4T_PAGE_LEN            16U       /*!< EEPROM page length                                        */
+
+#define RFAL_HOST_T3T_SC_NDEF             0x12FCU   /*!< NDEF system code                                          */
+#define RFAL_HOST_T3T_SVC_RO              0x000BU   /*!< NDEF read only service                                    */
+#define RFAL_HOST_T3T_SVC_RW              0x0009U   /*!< NDEF read/write service                                   */
+#define RFAL_HOST_T3T_RC_SC               0x01U     /*!< Request code: system code                                 */
+#define RFAL_HOST_T3T_BLE_2BYTES          0x80U     /*!< Block list element of 2 bytes                             */
+#define RFAL_HOST_T3T_ST1_ERR             0xFFU     /*!< Status flag 1: error                                      */
+#define RFAL_HOST_T3T_ST2_SERV_NUM        0xA1U     /*!< Status flag 2: illegal number of services                 */
+#define RFAL_HOST_T3T_ST2_BLK_NUM         0xA2U     /*!< Status flag 2: illegal number of blocks                   */
+#define RFAL_HOST_T3T_ST2_SERV_CODE       0xA6U     /*!< Status flag 2: illegal service code                       */
+#define RFAL_HOST_T3T_ST2_BLK             0xA8U     /*!< Status flag 2: illegal block number                       */
+#define RFAL_HOST_T3T_HDR_LEN             10U       /*!< LEN, command code and NFCID2                              */
+#define RFAL_HOST_T3T_T0                  4096U     /*!< MRT time unit in 1/fc                                     */
+#define RFAL_HOST_T3T_PMM_CHECK           5U        /*!< PMm byte of the CHECK MRT parameter                       */
+#define RFAL_HOST_T3T_PMM_UPDATE          6U        /*!< PMm byte of the UPDATE MRT parameter                      */
+
+#define RFAL_HOST_T5T_STATE_READY         0U        /*!< ISO15693 READY state                                      */
+#define RFAL_HOST_T5T_STATE_SELECTED      1U        /*!< ISO15693 SELECTED state                                   */
+#define RFAL_HOST_T5T_STATE_QUIET         2U        /*!< ISO15693 QUIET state                                      */
+#define RFAL_HOST_T5T_SLOTS               16U       /*!< Number of slots of a 16 slots inventory                   */
+#define RFAL_HOST_T5T_WR_MULTI_MAX        4U        /*!< Maximum blocks of a Write Multiple Blocks                 */
+#define RFAL_HOST_T5T_DSFID               0x00U     /*!< DSFID                                                     */
+#define RFAL_HOST_T5T_AFI                 0x00U     /*!< AFI                                                       */
+#define RFAL_HOST_T5T_IC_REF              0x26U     /*!< IC reference                                              */
+#define RFAL_HOST_T5T_INFO_DSFID          0x01U     /*!< System info: DSFID present                                */
+#define RFAL_HOST_T5T_INFO_AFI            0x02U     /*!< System info: AFI present                                  */
+#define RFAL_HOST_T5T_INFO_MEM            0x04U     /*!< System info: memory size present                          */
+#define RFAL_HOST_T5T_INFO_IC             0x08U     /*!< System info: IC reference present                         */
+#define RFAL_HOST_T5T_INFO_CMDLIST        0x20U     /*!< System info: command list present                         */
+#define RFAL_HOST_T5T_CMDLIST_0           0x7BU     /*!< Cmd list: read/write single and multiple, select, reset   */
+#define RFAL_HOST_T5T_CMDLIST_1           0x70U     /*!< Cmd list: get system info, custom, fast read multiple     */
+#define RFAL_HOST_T5T_CMDLIST_2           0x5BU     /*!< Cmd list: extended read/write single and multiple, fast   */
+#define RFAL_HOST_T5T_CMDLIST_3           0x00U     /*!< Cmd list: RFU                                             */
+#define RFAL_HOST_T5T_MAX_BLOCK_1B        256U      /*!< Blocks addressable with 1 byte                            */
+#define RFAL_HOST_T5T_CC_MAGIC_1B         0xE1U     /*!< CC magic number: 1 byte MLEN                              */
+#define RFAL_HOST_T5T_CC_MAGIC_2B         0xE2U     /*!< CC magic number: 2 bytes MLEN                             */
+#define RFAL_HOST_T5T_CC_VERSION          0x40U     /*!< CC version 1.0, read/write access granted                 */
+#define RFAL_HOST_T5T_CC_MBREAD           0x01U     /*!< CC feature: Read Multiple Blocks supported                */
+#define RFAL_HOST_T5T_IC_MFG_CODE         0x02U     /*!< ST IC manufacturer code                                   */
+#define RFAL_HOST_T5T_MB_CTRL_RW          RFAL_ST25DV_MB_CTRL_MB_EN   /*!< MB_CTRL_Dyn bits written by the reader          */
+
+#define RFAL_HOST_NDEF_EMPTY_TLV_LEN      3U        /*!< Empty NDEF TLV followed by a Terminator TLV               */
+
+/*
+******************************************************************************
+* LOCAL VARIABLES
+******************************************************************************
+*/
+
+static const uint8_t gRfalHostNdefEmptyTlv[RFAL_HOST_NDEF_EMPTY_TLV_LEN] = { 0x03U, 0x00U, 0xFEU };
+static const uint8_t gRfalHostT4TAid[]  = { 0xD2U, 0x76U, 0x00U, 0x00U, 0x85U, 0x01U, 0x01U };
+static const uint16_t gRfalHostFsdTable[] = { 16U, 24U, 32U, 40U, 48U, 64U, 96U, 128U, 256U, 512U, 1024U, 2048U, 4096U };
+
+/*
+******************************************************************************
+* LOCAL FUNCTION PROTOTYPES
+******************************************************************************
+*/
+
+static void rfalHostSetSW(uint8_t *buf, uint16_t *len, uint16_t sw);
+
+
+/*
+******************************************************************************
+* GLOBAL FUNCTIONS
+******************************************************************************
+*/
+
+/*******************************************************************************/
+/* NFC-A                                                                       */
+/*******************************************************************************/
+
+/*******************************************************************************/
+RfalHostNfcaTag::RfalHostNfcaTag(const uint8_t *uid, uint8_t uidLen, uint8_t atqa0, uint8_t atqa1, uint8_t sak)
+{
+  this->uidLen = MIN(uidLen, RFAL_HOST_NFCA_UID_MAX_LEN);
+  ST_MEMCPY(this->uid, uid, this->uidLen);
+
+  atqa[0]   = atqa0;
+  atqa[1]   = atqa1;
+  this->sak = sak;
+  state     = RFAL_HOST_NFCA_STATE_IDLE;
+  cl        = 0;
+  halted    = false;
+}
+
+
+/*******************************************************************************/
+rfalMode RfalHostNfcaTag::getMode(void)
+{
+  return RFAL_MODE_POLL_NFCA;
+}
+
+
+/*******************************************************************************/
+void RfalHostNfcaTag::powerOn(void)
+{
+  state  = RFAL_HOST_NFCA_STATE_IDLE;
+  cl     = 0;
+  halted = false;
+  activeReset();
+}
+
+
+/*******************************************************************************/
+void RfalHostNfcaTag::halt(void)
+{
+  state  = RFAL_HOST_NFCA_STATE_HALT;
+  halted = true;
+  activeReset();
+}
+
+
+/*******************************************************************************/
+void RfalHostNfcaTag::idle(void)
+{
+  state = (halted ? RFAL_HOST_NFCA_STATE_HALT : RFAL_HOST_NFCA_STATE_IDLE);
+  activeReset();
+}
+
+
+/*******************************************************************************/
+bool RfalHostNfcaTag::transceive(rfalHostFrameType type, const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime)
+{
+  uint8_t cln[RFAL_HOST_NFCA_CLN_LEN + 1U];
+  uint8_t level;
+
+  *resTime = RFAL_HOST_NFCA_FDT;
+
+  if (reqLen == 0U) {
+    return false;
+  }
+
+  /* REQA / WUPA */
+  if (type == RFAL_HOST_FRAME_SHORT) {
+    if ((req[0] == RFAL_HOST_NFCA_CMD_WUPA) || ((req[0] == RFAL_HOST_NFCA_CMD_REQA) && (state != RFAL_HOST_NFCA_STATE_HALT))) {
+      state = RFAL_HOST_NFCA_STATE_READY;
+      cl    = 0;
+      activeReset();
+
+      res[0]   = atqa[0];
+      res[1]   = atqa[1];
+      *resBits = (uint16_t)rfalConvBytesToBits(2U);
+      return true;
+    }
+    return false;
+  }
+
+  if (type != RFAL_HOST_FRAME_STD) {
+    /* SDD_REQ: only a full anticollision request is answered */
+    if ((type == RFAL_HOST_FRAME_SDD) && (state == RFAL_HOST_NFCA_STATE_READY) && (reqLen == 2U) && (req[1] == RFAL_HOST_NFCA_NVB_SDD)) {
+      level = (uint8_t)((req[0] - RFAL_HOST_NFCA_SEL_CL1) / 2U);
+      if (getCascadeLevel(level, cln)) {
+        ST_MEMCPY(res, cln, sizeof(cln));
+        *resBits = (uint16_t)rfalConvBytesToBits(sizeof(cln));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* SEL_REQ */
+  if ((state == RFAL_HOST_NFCA_STATE_READY) && (reqLen == 7U) && (req[1] == RFAL_HOST_NFCA_NVB_SEL)) {
+    level = (uint8_t)((req[0] - RFAL_HOST_NFCA_SEL_CL1) / 2U);
+    if (!getCascadeLevel(level, cln) || (ST_BYTECMP(&req[2], cln, sizeof(cln)) != 0)) {
+      return false;
+    }
+
+    if (((level * 3U) + RFAL_HOST_NFCA_CLN_LEN) < uidLen) {
+      cl     = (uint8_t)(level + 1U);
+      res[0] = RFAL_HOST_NFCA_SAK_CASCADE;
+    } else {
+      state  = RFAL_HOST_NFCA_STATE_ACTIVE;
+      res[0] = sak;
+    }
+    *resBits = (uint16_t)rfalConvBytesToBits(1U);
+    return true;
+  }
+
+  /* HLTA */
+  if ((reqLen == 2U) && (req[0] == RFAL_HOST_NFCA_CMD_HLTA) && (req[1] == 0x00U)) {
+    if (state == RFAL_HOST_NFCA_STATE_ACTIVE) {
+      halt();
+    }
+    return false;
+  }
+
+  if (state != RFAL_HOST_NFCA_STATE_ACTIVE) {
+    return false;
+  }
+
+  return activeTransceive(req, reqLen, res, resBits, resTime);
+}
+
+
+/*******************************************************************************/
+bool RfalHostNfcaTag::getCascadeLevel(uint8_t level, uint8_t *cln)
+{
+  uint8_t i;
+  uint8_t off;
+
+  if ((level > 2U) || (level > cl)) {
+    return false;
+  }
+
+  /* 4 bytes: UID0-3;  7 bytes: CT UID0-2 | UID3-6;  10 bytes: CT UID0-2 | CT UID3-5 | UID6-9 */
+  off = (uint8_t)(level * 3U);
+  if ((off + RFAL_HOST_NFCA_CLN_LEN) < uidLen) {
+    cln[0] = RFAL_HOST_NFCA_CT;
+    ST_MEMCPY(&cln[1], &uid[off], 3U);
+  } else if ((off + RFAL_HOST_NFCA_CLN_LEN) == uidLen) {
+    ST_MEMCPY(cln, &uid[off], RFAL_HOST_NFCA_CLN_LEN);
+  } else {
+    return false;
+  }
+
+  cln[RFAL_HOST_NFCA_CLN_LEN] = 0;
+  for (i = 0; i < RFAL_HOST_NFCA_CLN_LEN; i++) {
+    cln[RFAL_HOST_NFCA_CLN_LEN] ^= cln[i];
+  }
+
+  return true;
+}
+
+
+/*******************************************************************************/
+/* T2T                                                                         */
+/*******************************************************************************/
+
+/*******************************************************************************/
+RfalHostT2TTag::RfalHostT2TTag(const uint8_t *uid7, uint16_t dataSize, const uint8_t *version)
+  : RfalHostNfcaTag(uid7, 7U, 0x44U, 0x00U, 0x00U)
+{
+  uint32_t size;
+
+  pages = (RFAL_HOST_T2T_HDR_PAGES + (dataSize / RFAL_HOST_T2T_PAGE_LEN));
+  if (dataSize > RFAL_HOST_T2T_STATIC_SIZE) {
+    pages += RFAL_HOST_T2T_CFG_PAGES;
+  }
+
+  size = (pages * RFAL_HOST_T2T_PAGE_LEN);
+  mem  = new uint8_t[size];
+  ST_MEMSET(mem, 0x00, size);
+
+  /* UID and BCCs */
+  mem[0] = uid7[0];
+  mem[1] = uid7[1];
+  mem[2] = uid7[2];
+  mem[3] = (uint8_t)(RFAL_HOST_NFCA_CT ^ uid7[0] ^ uid7[1] ^ uid7[2]);
+  ST_MEMCPY(&mem[4], &uid7[3], 4U);
+  mem[8] = (uint8_t)(uid7[3] ^ uid7[4] ^ uid7[5] ^ uid7[6]);
+  mem[9] = 0x48U;
+
+  /* Capability Container and empty NDEF message */
+  mem[12] = 0xE1U;
+  mem[13] = 0x10U;
+  mem[14] = (uint8_t)MIN((dataSize / 8U), 0xFFU);
+  mem[15] = 0x00U;
+  ST_MEMCPY(&mem[16], gRfalHostNdefEmptyTlv, sizeof(gRfalHostNdefEmptyTlv));
+
+  hasVersion = (version != NULL);
+  if (hasVersion) {
+    ST_MEMCPY(this->version, version, RFAL_HOST_T2T_VERSION_LEN);
+  }
+
+  sector        = 0;
+  secSelPending = false;
+}
+
+
+/*******************************************************************************/
+RfalHostT2TTag::~RfalHostT2TTag()
+{
+  delete[] mem;
+}
+
+
+/*******************************************************************************/
+uint8_t *RfalHostT2TTag::getMemory(void)
+{
+  return mem;
+}
+
+
+/*******************************************************************************/
+uint32_t RfalHostT2TTag::getMemoryLen(void)
+{
+  return (pages * RFAL_HOST_T2T_PAGE_LEN);
+}
+
+
+/*******************************************************************************/
+void RfalHostT2TTag::activeReset(void)
+{
+  sector        = 0;
+  secSelPending = false;
+}
+
+
+/*******************************************************************************/
+uint16_t RfalHostT2TTag::sectorPages(void)
+{
+  uint32_t left;
+
+  left = (pages - ((uint32_t)sector * RFAL_HOST_T2T_SECTOR_PAGES));
+  return (uint16_t)MIN(left, RFAL_HOST_T2T_SECTOR_PAGES);
+}
+
+
+/*******************************************************************************/
+bool RfalHostT2TTag::nak(uint8_t *res, uint16_t *resBits, uint32_t *resTime)
+{
+  /* NTAG21x: a NAK sends the tag back to IDLE (or HALT) */
+  idle();
+
+  res[0]   = RFAL_HOST_T2T_NAK;
+  *resBits = RFAL_HOST_T2T_ACK_BITS;
+  *resTime = RFAL_HOST_NFCA_FDT;
+  return true;
+}
+
+
+/*******************************************************************************/
+bool RfalHostT2TTag::ack(uint8_t *res, uint16_t *resBits, uint32_t *resTime, uint32_t t)
+{
+  res[0]   = RFAL_HOST_T2T_ACK;
+  *resBits = RFAL_HOST_T2T_ACK_BITS;
+  *resTime = t;
+  return true;
+}
+
+
+/*******************************************************************************/
+bool RfalHostT2TTag::activeTransceive(const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime)
+{
+  uint32_t base;
+  uint16_t secPages;
+  uint16_t i;
+  uint8_t  page;
+  uint8_t *p;
+
+  *resTime = RFAL_HOST_NFCA_FDT;
+  base     = ((uint32_t)sector * RFAL_HOST_T2T_SECTOR_PAGES);
+  secPages = sectorPages();
+
+  /* SECTOR_SELECT packet 2: passive ACK, the tag stays silent */
+  if (secSelPending) {
+    secSelPending = false;
+    if ((reqLen == 4U) && (((uint32_t)req[0] * RFAL_HOST_T2T_SECTOR_PAGES) < pages)) {
+      sector = req[0];
+      return false;
+    }
+    return nak(res, resBits, resTime);
+  }
+
+  switch (req[0]) {
+    case RFAL_HOST_T2T_CMD_READ:
+      if ((reqLen != 2U) || (req[1] >= secPages)) {
+        return nak(res, resBits, resTime);
+      }
+      /* 4 pages, rolling over to page 0 of the sector */
+      for (i = 0; i < 4U; i++) {
+        page = (uint8_t)((req[1] + i) % secPages);
+        ST_MEMCPY(&res[i * RFAL_HOST_T2T_PAGE_LEN], &mem[(base + page) * RFAL_HOST_T2T_PAGE_LEN], RFAL_HOST_T2T_PAGE_LEN);
+      }
+      *resBits = (uint16_t)rfalConvBytesToBits(4U * RFAL_HOST_T2T_PAGE_LEN);
+      return true;
+
+    case RFAL_HOST_T2T_CMD_FAST_READ:
+      if (!hasVersion || (reqLen != 3U) || (req[1] > req[2]) || (req[2] >= secPages) ||
+          ((((uint32_t)req[2] - req[1] + 1U) * RFAL_HOST_T2T_PAGE_LEN) > RFAL_HOST_FRAME_MAX_LEN)) {
+        return nak(res, resBits, resTime);
+      }
+      ST_MEMCPY(res, &mem[(base + req[1]) * RFAL_HOST_T2T_PAGE_LEN], (((uint32_t)req[2] - req[1] + 1U) * RFAL_HOST_T2T_PAGE_LEN));
+      *resBits = (uint16_t)rfalConvBytesToBits(((uint32_t)req[2] - req[1] + 1U) * RFAL_HOST_T2T_PAGE_LEN);
+      return true;
+
+    case RFAL_HOST_T2T_CMD_WRITE:
+      if ((reqLen != (2U + RFAL_HOST_T2T_PAGE_LEN)) || (req[1] >= secPages) || ((base + req[1]) < 2U)) {
+        return nak(res, resBits, resTime);
+      }
+      p = &mem[(base + req[1]) * RFAL_HOST_T2T_PAGE_LEN];
+      if ((base + req[1]) == 2U) {
+        /* Static lock bytes: OTP, serial number and internal bytes read only */
+        p[2] |= req[4];
+        p[3] |= req[5];
+      } else if ((base + req[1]) == 3U) {
+        /* Capability Container: OTP */
+        for (i = 0; i < RFAL_HOST_T2T_PAGE_LEN; i++) {
+          p[i] |= req[2U + i];
+        }
+      } else {
+        ST_MEMCPY(p, &req[2], RFAL_HOST_T2T_PAGE_LEN);
+      }
+      return ack(res, resBits, resTime, RFAL_HOST_T2T_WRITE_TIME);
+
+    case RFAL_HOST_T2T_CMD_GET_VERSION:
+      if (!hasVersion || (reqLen != 1U)) {
+        return nak(res, resBits, resTime);
+      }
+      ST_MEMCPY(res, version, RFAL_HOST_T2T_VERSION_LEN);
+      *resBits = (uint16_t)rfalConvBytesToBits(RFAL_HOST_T2T_VERSION_LEN);
+      return true;
+
+    case RFAL_HOST_T2T_CMD_SECTOR_SELECT:
+      if ((pages <= RFAL_HOST_T2T_SECTOR_PAGES) || (reqLen != 2U) || (req[1] != 0xFFU)) {
+        return nak(res, resBits, resTime);
+      }
+      secSelPending = true;
+      return ack(res, resBits, resTime, RFAL_HOST_NFCA_FDT);
+
+    default:
+      return nak(res, resBits, resTime);
+  }
+}
+
+
+/*******************************************************************************/
+/* T4T                                                                         */
+/*******************************************************************************/
+
+/*******************************************************************************/
+RfalHostT4TTag::RfalHostT4TTag(const uint8_t *uid7, uint16_t fileSize, uint16_t mLe, uint16_t mLc)
+  : RfalHostNfcaTag(uid7, 7U, 0x44U, 0x03U, 0x20U)
+{
+  ndefFileLen = MIN(MAX(fileSize, 2U), RFAL_HOST_T4T_FILE_MAX_LEN);
+  ndefFile    = new uint8_t[ndefFileLen];
+  ST_MEMSET(ndefFile, 0x00, ndefFileLen);
+  extApdu     = ((mLe > 256U) || (mLc > 255U));
+
+  /* CC file, mapping version 2.0 */
+  ccFile[0]  = 0x00U;
+  ccFile[1]  = (uint8_t)sizeof(ccFile);
+  ccFile[2]  = 0x20U;
+  ccFile[3]  = (uint8_t)(mLe >> 8U);
+  ccFile[4]  = (uint8_t)(mLe & 0xFFU);
+  ccFile[5]  = (uint8_t)(mLc >> 8U);
+  ccFile[6]  = (uint8_t)(mLc & 0xFFU);
+  ccFile[7]  = 0x04U;
+  ccFile[8]  = 0x06U;
+  ccFile[9]  = (uint8_t)(RFAL_HOST_T4T_NDEF_FID >> 8U);
+  ccFile[10] = (uint8_t)(RFAL_HOST_T4T_NDEF_FID & 0xFFU);
+  ccFile[11] = (uint8_t)(ndefFileLen >> 8U);
+  ccFile[12] = (uint8_t)(ndefFileLen & 0xFFU);
+  ccFile[13] = 0x00U;
+  ccFile[14] = 0x00U;
+
+  activeReset();
+}
+
+
+/*******************************************************************************/
+RfalHostT4TTag::~RfalHostT4TTag()
+{
+  delete[] ndefFile;
+}
+
+
+/*******************************************************************************/
+uint8_t *RfalHostT4TTag::getMemory(void)
+{
+  return ndefFile;
+}
+
+
+/*******************************************************************************/
+uint32_t RfalHostT4TTag::getMemoryLen(void)
+{
+  return ndefFileLen;
+}
+
+
+/*******************************************************************************/
+void RfalHostT4TTag::activeReset(void)
+{
+  isoDep       = false;
+  fsd          = 256U;
+  appSelected  = false;
+  fileSelected = RFAL_HOST_T4T_FILE_NONE;
+  cid          = 0;
+  hasCid       = false;
+  apduLen      = 0;
+  rapduLen     = 0;
+  rapduOff     = 0;
+  lastChunk    = 0;
+  pendingTime  = 0;
+}
+
+
+/*******************************************************************************/
+uint16_t RfalHostT4TTag::sendChunk(uint8_t bn, uint8_t *res)
+{
+  uint16_t maxInf;
+  uint16_t len;
+  uint16_t pos;
+
+  maxInf = (uint16_t)(MIN(fsd, RFAL_HOST_FRAME_MAX_LEN) - RFAL_HOST_ISODEP_PROLOGUE_CRC - (hasCid ? 1U : 0U));
+  len    = (uint16_t)MIN((uint16_t)(rapduLen - rapduOff), maxInf);
+
+  pos      = 0;
+  res[pos] = (uint8_t)(RFAL_HOST_ISODEP_I_BLOCK | (bn & RFAL_HOST_ISODEP_PCB_BN));
+  if ((rapduOff + len) < rapduLen) {
+    res[pos] |= RFAL_HOST_ISODEP_PCB_CHAINING;
+  }
+  if (hasCid) {
+    res[pos] |= RFAL_HOST_ISODEP_PCB_CID;
+    pos++;
+    res[pos] = cid;
+  }
+  pos++;
+
+  ST_MEMCPY(&res[pos], &rapdu[rapduOff], len);
+  rapduOff  += len;
+  lastChunk  = len;
+
+  return (uint16_t)(pos + len);
+}
+
+
+/*******************************************************************************/
+bool RfalHostT4TTag::activeTransceive(const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime)
+{
+  uint32_t procTime;
+  uint32_t fwt;
+  uint16_t pos;
+  uint16_t len;
+  uint8_t  pcb;
+  uint8_t  bn;
+
+  *resTime = RFAL_HOST_NFCA_FDT;
+
+  /* RATS -> ATS */
+  if (!isoDep) {
+    if ((reqLen != 2U) || (req[0] != RFAL_HOST_ISODEP_RATS)) {
+      return false;
+    }
+
+    fsd    = (((req[1] >> 4U) < (sizeof(gRfalHostFsdTable) / sizeof(gRfalHostFsdTable[0]))) ? gRfalHostFsdTable[req[1] >> 4U] : 256U);
+    isoDep = true;
+
+    res[0]   = 0x05U;                                   /* TL                                  */
+    res[1]   = 0x78U;                                   /* T0: TA, TB, TC present, FSCI = 256  */
+    res[2]   = 0x00U;                                   /* TA: 106 kbps only, both directions  */
+    res[3]   = (uint8_t)(RFAL_HOST_T4T_FWI << 4U);      /* TB: FWI, SFGI = 0                   */
+    res[4]   = 0x00U;                                   /* TC: no NAD nor CID                  */
+    *resBits = (uint16_t)rfalConvBytesToBits(5U);
+    return true;
+  }
+
+  pcb = req[0];
+  bn  = (uint8_t)(pcb & RFAL_HOST_ISODEP_PCB_BN);
+
+  /* PPS */
+  if ((pcb & RFAL_HOST_ISODEP_PPS_MASK) == RFAL_HOST_ISODEP_PPS) {
+    res[0]   = pcb;
+    *resBits = (uint16_t)rfalConvBytesToBits(1U);
+    return true;
+  }
+
+  pos    = 1;
+  hasCid = ((pcb & RFAL_HOST_ISODEP_PCB_CID) != 0U);
+  if (hasCid) {
+    cid = req[pos];
+    pos++;
+  }
+  if (pos > reqLen) {
+    return false;
+  }
+
+  /* I-block */
+  if ((pcb & RFAL_HOST_ISODEP_PCB_MASK_I) == RFAL_HOST_ISODEP_I_BLOCK) {
+    len = (uint16_t)MIN((uint16_t)(reqLen - pos), (uint16_t)(sizeof(apdu) - apduLen));
+    ST_MEMCPY(&apdu[apduLen], &req[pos], len);
+    apduLen += len;
+
+    if ((pcb & RFAL_HOST_ISODEP_PCB_CHAINING) != 0U) {
+      len = 0;
+      res[len++] = (uint8_t)(RFAL_HOST_ISODEP_R_ACK | bn | (hasCid ? RFAL_HOST_ISODEP_PCB_CID : 0U));
+      if (hasCid) {
+        res[len++] = cid;
+      }
+      *resBits = (uint16_t)rfalConvBytesToBits(len);
+      return true;
+    }
+
+    rapduLen = processApdu(apdu, apduLen, rapdu, &procTime);
+    rapduOff = 0;
+    apduLen  = 0;
+
+    /* Request more time if the processing exceeds the FWT */
+    fwt = RFAL_HOST_ISODEP_FWT(RFAL_HOST_T4T_FWI);
+    if (procTime > (fwt / 2U)) {
+      pendingTime = (procTime - (fwt / 2U));
+
+      len = 0;
+      res[len++] = (uint8_t)(RFAL_HOST_ISODEP_S_WTX | (hasCid ? RFAL_HOST_ISODEP_PCB_CID : 0U));
+      if (hasCid) {
+        res[len++] = cid;
+      }
+      res[len++] = (uint8_t)MIN(((pendingTime / fwt) + 1U), RFAL_HOST_ISODEP_WTXM_MAX);
+      *resTime   = (fwt / 2U);
+      *resBits   = (uint16_t)rfalConvBytesToBits(len);
+
+      /* Keep the block number to answer after the S(WTX) response */
+      cid = (hasCid ? cid : bn);
+      return true;
+    }
+
+    *resTime = (RFAL_HOST_NFCA_FDT + procTime);
+    *resBits = (uint16_t)rfalConvBytesToBits(sendChunk(bn, res));
+    return true;
+  }
+
+  /* R-block */
+  if ((pcb & RFAL_HOST_ISODEP_PCB_MASK_R) == RFAL_HOST_ISODEP_R_ACK) {
+    if ((pcb & RFAL_HOST_ISODEP_PCB_NAK) != 0U) {
+      len = 0;
+      res[len++] = (uint8_t)(RFAL_HOST_ISODEP_R_ACK | bn | (hasCid ? RFAL_HOST_ISODEP_PCB_CID : 0U));
+      if (hasCid) {
+        res[len++] = cid;
+      }
+      *resBits = (uint16_t)rfalConvBytesToBits(len);
+      return true;
+    }
+
+    /* R(ACK): next chunk of a chained R-APDU, or retransmission of the last one */
+    if (rapduOff >= rapduLen) {
+      rapduOff = (uint16_t)(rapduOff - lastChunk);
+    }
+    *resBits = (uint16_t)rfalConvBytesToBits(sendChunk(bn, res));
+    return true;
+  }
+
+  /* S-block */
+  if ((pcb & RFAL_HOST_ISODEP_PCB_MASK_S) == RFAL_HOST_ISODEP_S_DESELECT) {
+    if ((pcb & RFAL_HOST_ISODEP_S_TYPE_MASK) == 0x00U) {
+      res[0]   = pcb;
+      *resBits = (uint16_t)rfalConvBytesToBits(pos);
+      if (hasCid) {
+        res[1] = cid;
+      }
+      halt();
+      return true;
+    }
+
+    if ((pcb & RFAL_HOST_ISODEP_S_TYPE_MASK) == RFAL_HOST_ISODEP_S_TYPE_MASK) {
+      /* S(WTX) response: deliver the pending R-APDU */
+      bn       = (hasCid ? 0U : cid);
+      *resTime = pendingTime;
+      *resBits = (uint16_t)rfalConvBytesToBits(sendChunk(bn, res));
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+/*******************************************************************************/
+uint16_t RfalHostT4TTag::processApdu(const uint8_t *capdu, uint16_t capduLen, uint8_t *rapdu, uint32_t *procTime)
+{
+  const uint8_t *data;
+  uint8_t       *file;
+  uint32_t       off;
+  uint32_t       le;
+  uint16_t       lc;
+  uint16_t       fileLen;
+  uint16_t       rLen;
+  uint16_t       n;
+  uint16_t       hdr;
+
+  *procTime = RFAL_HOST_T4T_PROC_TIME;
+  rLen      = 0;
+
+  if (capduLen < 4U) {
+    rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_LEN);
+    return rLen;
+  }
+
+  if (capdu[0] != 0x00U) {
+    rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_CLA);
+    return rLen;
+  }
+
+  /* Short APDU cases 1 to 4, extended cases 2E to 4E (00h followed by a 2 bytes Lc or Le) */
+  lc   = 0;
+  le   = 0;
+  data = NULL;
+  if (capduLen == 5U) {
+    le = ((capdu[4] == 0U) ? 256U : capdu[4]);
+  } else if ((capduLen >= 7U) && (capdu[4] == 0U)) {
+    if (!extApdu) {
+      rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_LEN);
+      return rLen;
+    }
+    if (capduLen == 7U) {
+      le = (((uint32_t)capdu[5] << 8U) | capdu[6]);
+      le = ((le == 0U) ? 65536U : le);
+    } else {
+      lc   = (uint16_t)(((uint16_t)capdu[5] << 8U) | capdu[6]);
+      data = &capdu[7];
+      if ((capduLen != (7U + (uint32_t)lc)) && (capduLen != (9U + (uint32_t)lc))) {
+        rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_LEN);
+        return rLen;
+      }
+      if (capduLen > (7U + (uint32_t)lc)) {
+        le = (((uint32_t)capdu[7U + lc] << 8U) | capdu[8U + lc]);
+        le = ((le == 0U) ? 65536U : le);
+      }
+    }
+  } else if (capduLen > 5U) {
+    lc   = capdu[4];
+    data = &capdu[5];
+    if (capduLen < (5U + lc)) {
+      rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_LEN);
+      return rLen;
+    }
+    if (capduLen > (5U + lc)) {
+      le = ((capdu[5U + lc] == 0U) ? 256U : capdu[5U + lc]);
+    }
+  } else {
+    /* Case 1 */
+  }
+
+  file    = ((fileSelected == RFAL_HOST_T4T_FILE_CC) ? ccFile : ndefFile);
+  fileLen = ((fileSelected == RFAL_HOST_T4T_FILE_CC) ? (uint16_t)sizeof(ccFile) : ndefFileLen);
+
+  switch (capdu[1]) {
+    case RFAL_HOST_T4T_INS_SELECT:
+      if (capdu[2] == 0x04U) {
+        appSelected  = ((lc == sizeof(gRfalHostT4TAid)) && (ST_BYTECMP(data, gRfalHostT4TAid, sizeof(gRfalHostT4TAid)) == 0));
+        fileSelected = RFAL_HOST_T4T_FILE_NONE;
+        rfalHostSetSW(rapdu, &rLen, (appSelected ? RFAL_HOST_T4T_SW_OK : RFAL_HOST_T4T_SW_NOT_FOUND));
+      } else if ((capdu[2] == 0x00U) && appSelected && (lc == 2U)) {
+        off = (((uint32_t)data[0] << 8U) | data[1]);
+        if (off == RFAL_HOST_T4T_CC_FID) {
+          fileSelected = RFAL_HOST_T4T_FILE_CC;
+        } else if (off == RFAL_HOST_T4T_NDEF_FID) {
+          fileSelected = RFAL_HOST_T4T_FILE_NDEF;
+        } else {
+          fileSelected = RFAL_HOST_T4T_FILE_NONE;
+        }
+        rfalHostSetSW(rapdu, &rLen, ((fileSelected != RFAL_HOST_T4T_FILE_NONE) ? RFAL_HOST_T4T_SW_OK : RFAL_HOST_T4T_SW_NOT_FOUND));
+      } else {
+        rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_NOT_FOUND);
+      }
+      break;
+
+    case RFAL_HOST_T4T_INS_READ:
+    case RFAL_HOST_T4T_INS_READ_ODO:
+      if (fileSelected == RFAL_HOST_T4T_FILE_NONE) {
+        rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_NOT_ALLOWED);
+        break;
+      }
+      if (capdu[1] == RFAL_HOST_T4T_INS_READ) {
+        off = (((uint32_t)capdu[2] << 8U) | capdu[3]);
+        hdr = 0;
+      } else {
+        if ((lc != 5U) || (data[0] != 0x54U) || (data[1] != 0x03U)) {
+          rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_PARAM);
+          break;
+        }
+        off = (((uint32_t)data[2] << 16U) | ((uint32_t)data[3] << 8U) | data[4]);
+        hdr = 2U;
+      }
+      if ((off > fileLen) || (le > (uint32_t)(RFAL_HOST_T4T_APDU_MAX_LEN - 2U - hdr - 1U))) {
+        rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_PARAM);
+        break;
+      }
+      n = (uint16_t)MIN((fileLen - off), (le - hdr));
+      if (hdr != 0U) {
+        rapdu[rLen++] = 0x53U;
+        rapdu[rLen++] = (uint8_t)n;
+      }
+      ST_MEMCPY(&rapdu[rLen], &file[off], n);
+      rLen += n;
+      rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_OK);
+      break;
+
+    case RFAL_HOST_T4T_INS_UPDATE:
+    case RFAL_HOST_T4T_INS_UPDATE_ODO:
+      if (fileSelected == RFAL_HOST_T4T_FILE_NONE) {
+        rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_NOT_ALLOWED);
+        break;
+      }
+      if (fileSelected == RFAL_HOST_T4T_FILE_CC) {
+        rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_SECURITY);
+        break;
+      }
+      if (capdu[1] == RFAL_HOST_T4T_INS_UPDATE) {
+        off = (((uint32_t)capdu[2] << 8U) | capdu[3]);
+      } else {
+        /* 54 03 xxyyzz 53 Ld, Ld in BER-TLV coding (1 to 3 bytes) */
+        hdr = ((lc < 7U) ? 0U : ((data[6] == 0x82U) ? 9U : ((data[6] == 0x81U) ? 8U : 7U)));
+        if ((hdr == 0U) || (lc < hdr) || (data[0] != 0x54U) || (data[1] != 0x03U) || (data[5] != 0x53U)) {
+          rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_PARAM);
+          break;
+        }
+        n = ((hdr == 9U) ? (uint16_t)(((uint16_t)data[7] << 8U) | data[8]) : data[hdr - 1U]);
+        if (n != (lc - hdr)) {
+          rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_PARAM);
+          break;
+        }
+        off   = (((uint32_t)data[2] << 16U) | ((uint32_t)data[3] << 8U) | data[4]);
+        lc   -= hdr;
+        data  = &data[hdr];
+      }
+      if ((off + lc) > fileLen) {
+        rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_PARAM);
+        break;
+      }
+      if (lc > 0U) {
+        ST_MEMCPY(&file[off], data, lc);
+        *procTime += ((((off + lc + RFAL_HOST_T4T_PAGE_LEN - 1U) / RFAL_HOST_T4T_PAGE_LEN) - (off / RFAL_HOST_T4T_PAGE_LEN)) * RFAL_HOST_T4T_WRITE_TIME);
+      }
+      rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_OK);
+      break;
+
+    default:
+      rfalHostSetSW(rapdu, &rLen, RFAL_HOST_T4T_SW_WRONG_INS);
+      break;
+  }
+
+  return rLen;
+}
+
+
+/*******************************************************************************/
+/* T3T                                                                         */
+/*******************************************************************************/
+
+/*******************************************************************************/
+RfalHostT3TTag::RfalHostT3TTag(const uint8_t *nfcid2, uint16_t nBlocks, uint8_t nbr, uint8_t nbw)
+{
+  static const uint8_t pmmDefault[RFAL_HOST_T3T_NFCID2_LEN] = { 0x00U, 0xF1U, 0x00U, 0x00U, 0x00U, 0x01U, 0x43U, 0x00U };
+  uint16_t checksum;
+  uint8_t  i;
+
+  ST_MEMCPY(this->nfcid2, nfcid2, RFAL_HOST_T3T_NFCID2_LEN);
+  ST_MEMCPY(pmm, pmmDefault, sizeof(pmm));
+
+  this->nBlocks = (uint16_t)(nBlocks + 1U);
+  this->nbr     = nbr;
+  this->nbw     = nbw;
+
+  mem = new uint8_t[(uint32_t)this->nBlocks * RFAL_HOST_T3T_BLOCK_LEN];
+  ST_MEMSET(mem, 0x00, ((uint32_t)this->nBlocks * RFAL_HOST_T3T_BLOCK_LEN));
+
+  /* Attribute Information Block */
+  mem[0]  = 0x10U;                                      /* Ver                                 */
+  mem[1]  = nbr;                                        /* Nbr                                 */
+  mem[2]  = nbw;                                        /* Nbw                                 */
+  mem[3]  = (uint8_t)(nBlocks >> 8U);                   /* Nmaxb                               */
+  mem[4]  = (uint8_t)(nBlocks & 0xFFU);
+  mem[9]  = 0x00U;                                      /* WriteF                              */
+  mem[10] = 0x01U;                                      /* RWFlag                              */
+  checksum = 0;
+  for (i = 0; i < 14U; i++) {
+    checksum += mem[i];
+  }
+  mem[14] = (uint8_t)(checksum >> 8U);
+  mem[15] = (uint8_t)(checksum & 0xFFU);
+}
+
+
+/*******************************************************************************/
+RfalHostT3TTag::~RfalHostT3TTag()
+{
+  delete[] mem;
+}
+
+
+/*******************************************************************************/
+rfalMode RfalHostT3TTag::getMode(void)
+{
+  return RFAL_MODE_POLL_NFCF;
+}
+
+
+/*******************************************************************************/
+void RfalHostT3TTag::powerOn(void)
+{
+  /* Stateless */
+}
+
+
+/*******************************************************************************/
+uint8_t *RfalHostT3TTag::getMemory(void)
+{
+  return mem;
+}
+
+
+/*******************************************************************************/
+uint32_t RfalHostT3TTag::getMemoryLen(void)
+{
+  return ((uint32_t)nBlocks * RFAL_HOST_T3T_BLOCK_LEN);
+}
+
+
+/*******************************************************************************/
+uint32_t RfalHostT3TTag::responseTime(uint8_t param, uint8_t n)
+{
+  uint32_t a;
+  uint32_t b;
+  uint32_t e;
+
+  /* Maximum Response Time: T0 x ((B + 1) x n + (A + 1)) x 4^E */
+  a = (param & 0x07U);
+  b = ((param >> 3U) & 0x07U);
+  e = ((param >> 6U) & 0x03U);
+
+  return ((RFAL_HOST_T3T_T0 * (((b + 1U) * n) + (a + 1U))) << (2U * e));
+}
+
+
+/*******************************************************************************/
+bool RfalHostT3TTag::parseBlockList(const uint8_t *req, uint16_t reqLen, uint16_t *pos, uint8_t *nBlk, uint16_t *blocks, uint8_t maxBlk, uint8_t *st2)
+{
+  uint16_t p;
+  uint16_t sc;
+  uint8_t  i;
+
+  p = RFAL_HOST_T3T_HDR_LEN;
+
+  /* Service code list: the NDEF service only */
+  if ((p >= reqLen) || (req[p] != 1U)) {
+    *st2 = RFAL_HOST_T3T_ST2_SERV_NUM;
+    return false;
+  }
+  p++;
+  if ((p + 2U) > reqLen) {
+    *st2 = RFAL_HOST_T3T_ST2_SERV_NUM;
+    return false;
+  }
+  sc = (uint16_t)(req[p] | ((uint16_t)req[p + 1U] << 8U));
+  p += 2U;
+  if ((sc != RFAL_HOST_T3T_SVC_RW) && ((sc != RFAL_HOST_T3T_SVC_RO) || (maxBlk != nbr))) {
+    *st2 = RFAL_HOST_T3T_ST2_SERV_CODE;
+    return false;
+  }
+
+  /* Block list */
+  if ((p >= reqLen) || (req[p] == 0U) || (req[p] > maxBlk)) {
+    *st2 = RFAL_HOST_T3T_ST2_BLK_NUM;
+    return false;
+  }
+  *nBlk = req[p];
+  p++;
+
+  for (i = 0; i < *nBlk; i++) {
+    if ((p + 2U) > reqLen) {
+      *st2 = RFAL_HOST_T3T_ST2_BLK_NUM;
+      return false;
+    }
+    if ((req[p] & RFAL_HOST_T3T_BLE_2BYTES) != 0U) {
+      blocks[i] = req[p + 1U];
+      p += 2U;
+    } else {
+      if ((p + 3U) > reqLen) {
+        *st2 = RFAL_HOST_T3T_ST2_BLK_NUM;
+        return false;
+      }
+      blocks[i] = (uint16_t)(req[p + 1U] | ((uint16_t)req[p + 2U] << 8U));
+      p += 3U;
+    }
+    if (blocks[i] >= nBlocks) {
+      *st2 = RFAL_HOST_T3T_ST2_BLK;
+      return false;
+    }
+  }
+
+  *pos = p;
+  return true;
+}
+
+
+/*******************************************************************************/
+bool RfalHostT3TTag::transceive(rfalHostFrameType type, const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime)
+{
+  uint16_t blocks[UINT8_MAX];
+  uint16_t pos;
+  uint16_t len;
+  uint8_t  nBlk;
+  uint8_t  st2;
+  uint8_t  i;
+  bool     ok;
+
+  if ((type != RFAL_HOST_FRAME_STD) || (reqLen < 2U) || (req[0] != reqLen)) {
+    return false;
+  }
+
+  /* SENSF_REQ */
+  if (req[1] == (uint8_t)RFAL_NFCF_CMD_POLLING) {
+    if ((reqLen != 6U) ||
+        ((req[2] != 0xFFU) && (req[2] != (uint8_t)(RFAL_HOST_T3T_SC_NDEF >> 8U))) ||
+        ((req[3] != 0xFFU) && (req[3] != (uint8_t)(RFAL_HOST_T3T_SC_NDEF & 0xFFU)))) {
+      return false;
+    }
+
+    len = 0;
+    res[len++] = 0;
+    res[len++] = (uint8_t)RFAL_NFCF_CMD_POLLING_RES;
+    ST_MEMCPY(&res[len], nfcid2, RFAL_HOST_T3T_NFCID2_LEN);
+    len += RFAL_HOST_T3T_NFCID2_LEN;
+    ST_MEMCPY(&res[len], pmm, RFAL_HOST_T3T_NFCID2_LEN);
+    len += RFAL_HOST_T3T_NFCID2_LEN;
+    if (req[4] == RFAL_HOST_T3T_RC_SC) {
+      res[len++] = (uint8_t)(RFAL_HOST_T3T_SC_NDEF >> 8U);
+      res[len++] = (uint8_t)(RFAL_HOST_T3T_SC_NDEF & 0xFFU);
+    }
+    res[0] = (uint8_t)len;
+
+    /* Answer in the first time slot */
+    *resTime = RFAL_HOST_FELICA_POLL_DELAY;
+    *resBits = (uint16_t)rfalConvBytesToBits(len);
+    return true;
+  }
+
+  if ((reqLen < RFAL_HOST_T3T_HDR_LEN) || (ST_BYTECMP(&req[2], nfcid2, RFAL_HOST_T3T_NFCID2_LEN) != 0)) {
+    return false;
+  }
+
+  len = 0;
+  res[len++] = 0;
+  res[len++] = (uint8_t)(req[1] + 1U);
+  ST_MEMCPY(&res[len], nfcid2, RFAL_HOST_T3T_NFCID2_LEN);
+  len += RFAL_HOST_T3T_NFCID2_LEN;
+
+  switch (req[1]) {
+    case RFAL_NFCF_CMD_READ_WITHOUT_ENCRYPTION:
+      ok = parseBlockList(req, reqLen, &pos, &nBlk, blocks, nbr, &st2);
+      if (!ok) {
+        res[len++] = RFAL_HOST_T3T_ST1_ERR;
+        res[len++] = st2;
+        *resTime   = responseTime(pmm[RFAL_HOST_T3T_PMM_CHECK], 0);
+        break;
+      }
+      res[len++] = 0x00U;
+      res[len++] = 0x00U;
+      res[len++] = nBlk;
+      for (i = 0; i < nBlk; i++) {
+        ST_MEMCPY(&res[len], &mem[(uint32_t)blocks[i] * RFAL_HOST_T3T_BLOCK_LEN], RFAL_HOST_T3T_BLOCK_LEN);
+        len += RFAL_HOST_T3T_BLOCK_LEN;
+      }
+      *resTime = responseTime(pmm[RFAL_HOST_T3T_PMM_CHECK], nBlk);
+      break;
+
+    case RFAL_NFCF_CMD_WRITE_WITHOUT_ENCRYPTION:
+      ok = parseBlockList(req, reqLen, &pos, &nBlk, blocks, nbw, &st2);
+      if (ok && ((pos + ((uint16_t)nBlk * RFAL_HOST_T3T_BLOCK_LEN)) != reqLen)) {
+        ok  = false;
+        st2 = RFAL_HOST_T3T_ST2_BLK_NUM;
+      }
+      if (!ok) {
+        res[len++] = RFAL_HOST_T3T_ST1_ERR;
+        res[len++] = st2;
+        *resTime   = responseTime(pmm[RFAL_HOST_T3T_PMM_UPDATE], 0);
+        break;
+      }
+      for (i = 0; i < nBlk; i++) {
+        ST_MEMCPY(&mem[(uint32_t)blocks[i] * RFAL_HOST_T3T_BLOCK_LEN], &req[pos + ((uint16_t)i * RFAL_HOST_T3T_BLOCK_LEN)], RFAL_HOST_T3T_BLOCK_LEN);
+      }
+      res[len++] = 0x00U;
+      res[len++] = 0x00U;
+      *resTime   = responseTime(pmm[RFAL_HOST_T3T_PMM_UPDATE], nBlk);
+      break;
+
+    default:
+      return false;
+  }
+
+  res[0]   = (uint8_t)len;
+  *resBits = (uint16_t)rfalConvBytesToBits(len);
+  return true;
+}
+
+
+/*******************************************************************************/
+/* T5T                                                                         */
+/*******************************************************************************/
+
+/*******************************************************************************/
+RfalHostT5TTag::RfalHostT5TTag(const uint8_t *uid, uint8_t blockLen, uint16_t nBlocks)
+{
+  uint32_t size;
+  uint32_t mlen;
+  uint8_t  ccLen;
+
+  ST_MEMCPY(this->uid, uid, RFAL_HOST_T5T_UID_LEN);
+  this->blockLen = blockLen;
+  this->nBlocks  = nBlocks;
+
+  size = ((uint32_t)blockLen * nBlocks);
+  mem  = new uint8_t[size];
+  ST_MEMSET(mem, 0x00, size);
+
+  /* Capability Container: 4 bytes if the size fits MLEN on 1 byte, 8 bytes otherwise */
+  if ((size / 8U) <= 0xFFU) {
+    ccLen  = 4U;
+    mem[0] = RFAL_HOST_T5T_CC_MAGIC_1B;
+    mem[1] = RFAL_HOST_T5T_CC_VERSION;
+    mem[2] = (uint8_t)(size / 8U);
+    mem[3] = RFAL_HOST_T5T_CC_MBREAD;
+  } else {
+    ccLen  = 8U;
+    mlen   = ((size / 8U) - 1U);
+    mem[0] = RFAL_HOST_T5T_CC_MAGIC_2B;
+    mem[1] = RFAL_HOST_T5T_CC_VERSION;
+    mem[2] = 0x00U;
+    mem[3] = RFAL_HOST_T5T_CC_MBREAD;
+    mem[6] = (uint8_t)(mlen >> 8U);
+    mem[7] = (uint8_t)(mlen & 0xFFU);
+  }
+  ST_MEMCPY(&mem[ccLen], gRfalHostNdefEmptyTlv, sizeof(gRfalHostNdefEmptyTlv));
+
+  mbMode       = false;
+  mbHostTime   = 0;
+  mbI2cTime    = 0;
+  mbEcho       = false;
+  mbHostLog    = NULL;
+  mbHostLogLen = 0;
+
+  powerOn();
+}
+
+
+/*******************************************************************************/
+RfalHostT5TTag::~RfalHostT5TTag()
+{
+  delete[] mem;
+  delete[] mbHostLog;
+}
+
+
+/*******************************************************************************/
+rfalMode RfalHostT5TTag::getMode(void)
+{
+  return RFAL_MODE_POLL_NFCV;
+}
+
+
+/*******************************************************************************/
+void RfalHostT5TTag::powerOn(void)
+{
+  state      = RFAL_HOST_T5T_STATE_READY;
+  invPending = false;
+  invSlot    = 0;
+  mySlot     = 0;
+  pendingLen = 0;
+
+  /* MB_CTRL_Dyn is reset with the RF field: Mailbox disabled and empty */
+  mbCtrl        = 0;
+  mbLen         = 0;
+  mbHostPending = false;
+  mbHostAt      = 0;
+}
+
+
+/*******************************************************************************/
+uint8_t *RfalHostT5TTag::getMemory(void)
+{
+  return mem;
+}
+
+
+/*******************************************************************************/
+uint32_t RfalHostT5TTag::getMemoryLen(void)
+{
+  return ((uint32_t)blockLen * nBlocks);
+}
+
+
+/*******************************************************************************/
+void RfalHostT5TTag::mbConfigure(uint32_t hostTime, uint32_t i2cTime, bool echo)
+{
+  if (mbHostLog == NULL) {
+    mbHostLog = new uint8_t[RFAL_HOST_T5T_MB_HOST_LOG_LEN];
+  }
+
+  mbMode       = true;
+  mbHostTime   = hostTime;
+  mbI2cTime    = MIN(i2cTime, hostTime);
+  mbEcho       = echo;
+  mbHostLogLen = 0;
+}
+
+
+/*******************************************************************************/
+const uint8_t *RfalHostT5TTag::mbGetHostData(uint32_t *len)
+{
+  *len = mbHostLogLen;
+  return mbHostLog;
+}
+
+
+/*******************************************************************************/
+void RfalHostT5TTag::mbHostUpdate(void)
+{
+  uint32_t cpy;
+
+  if (!mbHostPending || (rfalHostGetTime() < mbHostAt)) {
+    return;
+  }
+
+  /* Host reads the message put by the reader, then puts it back in echo mode */
+  if (mbHostLogLen < RFAL_HOST_T5T_MB_HOST_LOG_LEN) {
+    cpy = MIN((uint32_t)mbLen, (RFAL_HOST_T5T_MB_HOST_LOG_LEN - mbHostLogLen));
+    ST_MEMCPY(&mbHostLog[mbHostLogLen], mb, cpy);
+  }
+  mbHostLogLen  += mbLen;
+  mbHostPending  = false;
+  mbCtrl        &= (uint8_t)~RFAL_ST25DV_MB_CTRL_RF_PUT_MSG;
+
+  if (mbEcho) {
+    mbCtrl |= RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG;
+  } else {
+    mbLen = 0;
+  }
+}
+
+
+/*******************************************************************************/
+uint16_t RfalHostT5TTag::mbCommand(uint8_t cmd, const uint8_t *p, uint16_t pLen, uint8_t *res)
+{
+  uint16_t ptr;
+  uint16_t cnt;
+
+  switch (cmd) {
+    case RFAL_NFCV_CMD_READ_DYN_CONFIGURATION:
+    case RFAL_NFCV_CMD_FAST_READ_DYN_CONFIGURATION:
+      if ((pLen != 1U) || (p[0] != RFAL_ST25DV_MB_CTRL_DYN)) {
+        return error((uint8_t)RFAL_NFCV_ERROR_OPTION_NOT_SUPPORTED, res);
+      }
+      res[0] = 0x00U;
+      res[1] = mbCtrl;
+      return 2U;
+
+    case RFAL_NFCV_CMD_WRITE_DYN_CONFIGURATION:
+    case RFAL_NFCV_CMD_FAST_WRITE_DYN_CONFIGURATION:
+      if ((pLen != 2U) || (p[0] != RFAL_ST25DV_MB_CTRL_DYN)) {
+        return error((uint8_t)RFAL_NFCV_ERROR_OPTION_NOT_SUPPORTED, res);
+      }
+      if (!mbMode) {
+        return error((uint8_t)RFAL_NFCV_ERROR_BLOCK_LOCKED, res);
+      }
+      if ((p[1] & RFAL_ST25DV_MB_CTRL_MB_EN) == 0U) {
+        /* Disabling the Mailbox empties it */
+        mbCtrl        = 0;
+        mbLen         = 0;
+        mbHostPending = false;
+      } else {
+        mbCtrl |= RFAL_HOST_T5T_MB_CTRL_RW;
+      }
+      res[0] = 0x00U;
+      return 1U;
+
+    case RFAL_NFCV_CMD_WRITE_MESSAGE:
+    case RFAL_NFCV_CMD_FAST_WRITE_MESSAGE:
+      if ((pLen < 1U) || (pLen != ((uint16_t)p[0] + 2U))) {
+        return error((uint8_t)RFAL_NFCV_ERROR_OPTION_NOT_SUPPORTED, res);
+      }
+      if (((mbCtrl & RFAL_ST25DV_MB_CTRL_MB_EN) == 0U) || ((mbCtrl & (RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG | RFAL_ST25DV_MB_CTRL_RF_PUT_MSG)) != 0U)) {
+        return error((uint8_t)RFAL_NFCV_ERROR_UNKNOWN, res);
+      }
+      mbLen = (uint16_t)(pLen - 1U);
+      ST_MEMCPY(mb, &p[1], mbLen);
+      mbCtrl        |= RFAL_ST25DV_MB_CTRL_RF_PUT_MSG;
+      mbHostPending  = true;
+      mbHostAt       = (rfalHostGetTime() + mbHostTime);
+      res[0] = 0x00U;
+      return 1U;
+
+    case RFAL_NFCV_CMD_READ_MESSAGE_LENGTH:
+    case RFAL_NFCV_CMD_FAST_READ_MESSAGE_LENGTH:
+      if ((mbCtrl & (RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG | RFAL_ST25DV_MB_CTRL_RF_PUT_MSG)) == 0U) {
+        return error((uint8_t)RFAL_NFCV_ERROR_UNKNOWN, res);
+      }
+      res[0] = 0x00U;
+      res[1] = (uint8_t)(mbLen - 1U);
+      return 2U;
+
+    case RFAL_NFCV_CMD_READ_MESSAGE:
+    case RFAL_NFCV_CMD_FAST_READ_MESSAGE:
+      /* Only the message put by the host can be read back over RF */
+      if ((pLen != 2U) || ((mbCtrl & RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG) == 0U) || ((uint16_t)p[0] >= mbLen)) {
+        return error((uint8_t)RFAL_NFCV_ERROR_UNKNOWN, res);
+      }
+      ptr = p[0];
+      cnt = ((p[1] == 0U) ? (uint16_t)(mbLen - ptr) : ((uint16_t)p[1] + 1U));
+      if ((ptr + cnt) > mbLen) {
+        return error((uint8_t)RFAL_NFCV_ERROR_UNKNOWN, res);
+      }
+      res[0] = 0x00U;
+      ST_MEMCPY(&res[1], &mb[ptr], cnt);
+
+      /* Reading the last byte frees the Mailbox */
+      if ((ptr + cnt) == mbLen) {
+        mbCtrl &= (uint8_t)~RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG;
+        mbLen   = 0;
+      }
+      return (uint16_t)(cnt + 1U);
+
+    default:
+      return error((uint8_t)RFAL_NFCV_ERROR_CMD_NOT_SUPPORTED, res);
+  }
+}
+
+
+/*******************************************************************************/
+uint16_t RfalHostT5TTag::error(uint8_t code, uint8_t *res)
+{
+  res[0] = (uint8_t)RFAL_NFCV_RES_FLAG_ERROR;
+  res[1] = code;
+  return 2U;
+}
+
+
+/*******************************************************************************/
+bool RfalHostT5TTag::inventory(const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime)
+{
+  uint16_t pos;
+  uint8_t  maskLen;
+  uint8_t  i;
+  uint8_t  bit;
+
+  if (state == RFAL_HOST_T5T_STATE_QUIET) {
+    return false;
+  }
+
+  pos = 2;
+  if ((req[0] & (uint8_t)RFAL_NFCV_REQ_FLAG_AFI) != 0U) {
+    pos++;
+  }
+  if (pos >= reqLen) {
+    return false;
+  }
+  maskLen = req[pos];
+  pos++;
+  if ((maskLen > 64U) || ((pos + rfalConvBitsToBytes(maskLen)) > reqLen)) {
+    return false;
+  }
+
+  /* Mask is compared with the UID LSB first */
+  for (i = 0; i < maskLen; i++) {
+    bit = (uint8_t)(1U << (i % 8U));
+    if ((req[pos + (i / 8U)] & bit) != (uid[i / 8U] & bit)) {
+      return false;
+    }
+  }
+
+  invSlot    = 0;
+  invPending = false;
+  mySlot     = 0;
+  if (((req[0] & (uint8_t)RFAL_NFCV_REQ_FLAG_NB_SLOTS) == 0U) && (maskLen <= 60U)) {
+    for (i = 0; i < 4U; i++) {
+      bit     = (uint8_t)(maskLen + i);
+      mySlot |= (uint8_t)(((uid[bit / 8U] >> (bit % 8U)) & 1U) << i);
+    }
+  }
+
+  if (mySlot != invSlot) {
+    invPending = true;
+    return false;
+  }
+
+  res[0] = 0x00U;
+  res[1] = RFAL_HOST_T5T_DSFID;
+  ST_MEMCPY(&res[2], uid, RFAL_HOST_T5T_UID_LEN);
+  *resBits = (uint16_t)rfalConvBytesToBits(2U + RFAL_HOST_T5T_UID_LEN);
+  *resTime = RFAL_HOST_T5T_T1;
+  return true;
+}
+
+
+/*******************************************************************************/
+bool RfalHostT5TTag::transceive(rfalHostFrameType type, const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime)
+{
+  uint16_t len;
+  uint16_t pos;
+  uint8_t  flags;
+  uint8_t  cmd;
+  bool     respond;
+
+  *resTime = RFAL_HOST_T5T_T1;
+
+  /* EOF: next inventory slot, or response to a request with Option flag */
+  if (type == RFAL_HOST_FRAME_EOF) {
+    if (invPending) {
+      invSlot++;
+      if (invSlot == mySlot) {
+        invPending = false;
+        res[0] = 0x00U;
+        res[1] = RFAL_HOST_T5T_DSFID;
+        ST_MEMCPY(&res[2], uid, RFAL_HOST_T5T_UID_LEN);
+        *resBits = (uint16_t)rfalConvBytesToBits(2U + RFAL_HOST_T5T_UID_LEN);
+        return true;
+      }
+      invPending = (invSlot < (RFAL_HOST_T5T_SLOTS - 1U));
+      return false;
+    }
+    if (pendingLen > 0U) {
+      ST_MEMCPY(res, pendingRes, pendingLen);
+      *resBits   = (uint16_t)rfalConvBytesToBits(pendingLen);
+      pendingLen = 0;
+      return true;
+    }
+    return false;
+  }
+
+  if ((type != RFAL_HOST_FRAME_STD) || (reqLen < 2U)) {
+    return false;
+  }
+
+  flags = req[0];
+  cmd   = req[1];
+
+  if ((flags & (uint8_t)RFAL_NFCV_REQ_FLAG_INVENTORY) != 0U) {
+    return ((cmd == (uint8_t)RFAL_NFCV_CMD_INVENTORY) && inventory(req, reqLen, res, resBits, resTime));
+  }
+
+  invPending = false;
+  pendingLen = 0;
+
+  /* Custom commands carry the IC manufacturer code */
+  pos = 2;
+  if (cmd >= (uint8_t)RFAL_NFCV_CMD_READ_CONFIGURATION) {
+    if ((reqLen < 3U) || (req[2] != RFAL_HOST_T5T_IC_MFG_CODE)) {
+      return false;
+    }
+    pos++;
+  }
+
+  if ((flags & (uint8_t)RFAL_NFCV_REQ_FLAG_ADDRESS) != 0U) {
+    if (((pos + RFAL_HOST_T5T_UID_LEN) > reqLen) || (ST_BYTECMP(&req[pos], uid, RFAL_HOST_T5T_UID_LEN) != 0)) {
+      /* Selecting another VICC deselects this one */
+      if ((cmd == (uint8_t)RFAL_NFCV_CMD_SELECT) && (state == RFAL_HOST_T5T_STATE_SELECTED)) {
+        state = RFAL_HOST_T5T_STATE_READY;
+      }
+      return false;
+    }
+    pos += RFAL_HOST_T5T_UID_LEN;
+  } else if ((flags & (uint8_t)RFAL_NFCV_REQ_FLAG_SELECT) != 0U) {
+    if (state != RFAL_HOST_T5T_STATE_SELECTED) {
+      return false;
+    }
+  } else if (state == RFAL_HOST_T5T_STATE_QUIET) {
+    return false;
+  } else {
+    /* Non addressed mode */
+  }
+
+  /* Silent while the host accesses the Mailbox over I2C */
+  mbHostUpdate();
+  if (mbHostPending && ((rfalHostGetTime() + mbI2cTime) >= mbHostAt)) {
+    return false;
+  }
+
+  respond = true;
+  len     = command(flags, cmd, &req[pos], (uint16_t)(reqLen - pos), res, resTime, &respond);
+  if (!respond || (len == 0U)) {
+    return false;
+  }
+
+  *resBits = (uint16_t)rfalConvBytesToBits(len);
+  return true;
+}
+
+
+/*******************************************************************************/
+uint16_t RfalHostT5TTag::command(uint8_t flags, uint8_t cmd, const uint8_t *p, uint16_t pLen, uint8_t *res, uint32_t *resTime, bool *respond)
+{
+  uint32_t first;
+  uint32_t cnt;
+  uint32_t i;
+  uint16_t len;
+  uint8_t  info;
+  bool     option;
+  bool     ext;
+
+  option   = ((flags & (uint8_t)RFAL_NFCV_REQ_FLAG_OPTION) != 0U);
+  *resTime = RFAL_HOST_T5T_T1;
+  len      = 0;
+
+  switch (cmd) {
+    case RFAL_NFCV_CMD_SLPV:
+      if ((flags & (uint8_t)RFAL_NFCV_REQ_FLAG_ADDRESS) != 0U) {
+        state = RFAL_HOST_T5T_STATE_QUIET;
+      }
+      *respond = false;
+      return 0;
+
+    case RFAL_NFCV_CMD_SELECT:
+      state  = RFAL_HOST_T5T_STATE_SELECTED;
+      res[0] = 0x00U;
+      return 1U;
+
+    case RFAL_NFCV_CMD_RESET_TO_READY:
+      state  = RFAL_HOST_T5T_STATE_READY;
+      res[0] = 0x00U;
+      return 1U;
+
+    case RFAL_NFCV_CMD_READ_SINGLE_BLOCK:
+    case RFAL_NFCV_CMD_READ_MULTIPLE_BLOCKS:
+    case RFAL_NFCV_CMD_EXTENDED_READ_SINGLE_BLOCK:
+    case RFAL_NFCV_CMD_EXTENDED_READ_MULTIPLE_BLOCK:
+    case RFAL_NFCV_CMD_FAST_READ_SINGLE_BLOCK:
+    case RFAL_NFCV_CMD_FAST_READ_MULTIPLE_BLOCKS:
+    case RFAL_NFCV_CMD_FAST_EXTENDED_READ_SINGLE_BLOCK:
+    case RFAL_NFCV_CMD_FAST_EXTENDED_READ_MULTIPLE_BLOCKS:
+      ext = ((cmd == (uint8_t)RFAL_NFCV_CMD_EXTENDED_READ_SINGLE_BLOCK) || (cmd == (uint8_t)RFAL_NFCV_CMD_EXTENDED_READ_MULTIPLE_BLOCK) ||
+             (cmd == (uint8_t)RFAL_NFCV_CMD_FAST_EXTENDED_READ_SINGLE_BLOCK) || (cmd == (uint8_t)RFAL_NFCV_CMD_FAST_EXTENDED_READ_MULTIPLE_BLOCKS));
+      if (pLen < (ext ? 2U : 1U)) {
+        return error((uint8_t)RFAL_NFCV_ERROR_CMD_NOT_RECOGNIZED, res);
+      }
+      first = (ext ? (uint32_t)(p[0] | ((uint32_t)p[1] << 8U)) : p[0]);
+      cnt   = 1U;
+      if ((cmd == (uint8_t)RFAL_NFCV_CMD_READ_MULTIPLE_BLOCKS) || (cmd == (uint8_t)RFAL_NFCV_CMD_FAST_READ_MULTIPLE_BLOCKS)) {
+        if (pLen < 2U) {
+          return error((uint8_t)RFAL_NFCV_ERROR_CMD_NOT_RECOGNIZED, res);
+        }
+        cnt = ((uint32_t)p[1] + 1U);
+      } else if ((cmd == (uint8_t)RFAL_NFCV_CMD_EXTENDED_READ_MULTIPLE_BLOCK) || (cmd == (uint8_t)RFAL_NFCV_CMD_FAST_EXTENDED_READ_MULTIPLE_BLOCKS)) {
+        if (pLen < 4U) {
+          return error((uint8_t)RFAL_NFCV_ERROR_CMD_NOT_RECOGNIZED, res);
+        }
+        cnt = ((uint32_t)(p[2] | ((uint32_t)p[3] << 8U)) + 1U);
+      } else {
+        /* Single block */
+      }
+
+      if (((first + cnt) > nBlocks) || ((1U + (cnt * ((option ? 1U : 0U) + blockLen))) > RFAL_HOST_FRAME_MAX_LEN)) {
+        return error((uint8_t)RFAL_NFCV_ERROR_BLOCK_NOT_AVALIABLE, res);
+      }
+
+      res[len++] = 0x00U;
+      for (i = 0; i < cnt; i++) {
+        if (option) {
+          res[len++] = 0x00U;                           /* Block security status               */
+        }
+        ST_MEMCPY(&res[len], &mem[(first + i) * blockLen], blockLen);
+        len += blockLen;
+      }
+      return len;
+
+    case RFAL_NFCV_CMD_WRITE_SINGLE_BLOCK:
+    case RFAL_NFCV_CMD_WRITE_MULTIPLE_BLOCKS:
+    case RFAL_NFCV_CMD_EXTENDED_WRITE_SINGLE_BLOCK:
+    case RFAL_NFCV_CMD_EXTENDED_WRITE_MULTIPLE_BLOCK:
+      ext   = ((cmd == (uint8_t)RFAL_NFCV_CMD_EXTENDED_WRITE_SINGLE_BLOCK) || (cmd == (uint8_t)RFAL_NFCV_CMD_EXTENDED_WRITE_MULTIPLE_BLOCK));
+      len   = (ext ? 2U : 1U);
+      if (pLen < len) {
+        return error((uint8_t)RFAL_NFCV_ERROR_CMD_NOT_RECOGNIZED, res);
+      }
+      first = (ext ? (uint32_t)(p[0] | ((uint32_t)p[1] << 8U)) : p[0]);
+      cnt   = 1U;
+      if (cmd == (uint8_t)RFAL_NFCV_CMD_WRITE_MULTIPLE_BLOCKS) {
+        cnt = ((uint32_t)p[1] + 1U);
+        len++;
+      } else if (cmd == (uint8_t)RFAL_NFCV_CMD_EXTENDED_WRITE_MULTIPLE_BLOCK) {
+        cnt  = ((uint32_t)(p[2] | ((uint32_t)p[3] << 8U)) + 1U);
+        len += 2U;
+      } else {
+        /* Single block */
+      }
+
+      if ((cnt > RFAL_HOST_T5T_WR_MULTI_MAX) || (pLen != (len + (cnt * blockLen)))) {
+        return error((uint8_t)RFAL_NFCV_ERROR_CMD_NOT_RECOGNIZED, res);
+      }
+      if ((first + cnt) > nBlocks) {
+        return error((uint8_t)RFAL_NFCV_ERROR_BLOCK_NOT_AVALIABLE, res);
+      }
+
+      ST_MEMCPY(&mem[first * blockLen], &p[len], (cnt * blockLen));
+      *resTime = (RFAL_HOST_T5T_T1 + (cnt * RFAL_HOST_T5T_WRITE_TIME));
+
+      /* Option flag: the response is sent upon EOF */
+      if (option) {
+        pendingRes[0] = 0x00U;
+        pendingLen    = 1U;
+        *respond      = false;
+        return 0;
+      }
+      res[0] = 0x00U;
+      return 1U;
+
+    case RFAL_NFCV_CMD_GET_SYS_INFO:
+    case RFAL_NFCV_CMD_EXTENDED_GET_SYS_INFO:
+      ext = (cmd == (uint8_t)RFAL_NFCV_CMD_EXTENDED_GET_SYS_INFO);
+      if (ext) {
+        if (pLen < 1U) {
+          return error((uint8_t)RFAL_NFCV_ERROR_CMD_NOT_RECOGNIZED, res);
+        }
+        info = (uint8_t)(p[0] & (RFAL_HOST_T5T_INFO_DSFID | RFAL_HOST_T5T_INFO_AFI | RFAL_HOST_T5T_INFO_MEM | RFAL_HOST_T5T_INFO_IC | RFAL_HOST_T5T_INFO_CMDLIST));
+      } else {
+        info = (RFAL_HOST_T5T_INFO_DSFID | RFAL_HOST_T5T_INFO_AFI | RFAL_HOST_T5T_INFO_MEM | RFAL_HOST_T5T_INFO_IC);
+        /* Memory size does not fit: reported with the Protocol Extension flag only */
+        if ((nBlocks > RFAL_HOST_T5T_MAX_BLOCK_1B) && ((flags & (uint8_t)RFAL_NFCV_REQ_FLAG_PROTOCOL_EXT) == 0U)) {
+          info &= (uint8_t)~RFAL_HOST_T5T_INFO_MEM;
+        }
+      }
+
+      res[len++] = 0x00U;
+      res[len++] = info;
+      ST_MEMCPY(&res[len], uid, RFAL_HOST_T5T_UID_LEN);
+      len += RFAL_HOST_T5T_UID_LEN;
+      if ((info & RFAL_HOST_T5T_INFO_DSFID) != 0U) {
+        res[len++] = RFAL_HOST_T5T_DSFID;
+      }
+      if ((info & RFAL_HOST_T5T_INFO_AFI) != 0U) {
+        res[len++] = RFAL_HOST_T5T_AFI;
+      }
+      if ((info & RFAL_HOST_T5T_INFO_MEM) != 0U) {
+        res[len++] = (uint8_t)((nBlocks - 1U) & 0xFFU);
+        if (ext || ((flags & (uint8_t)RFAL_NFCV_REQ_FLAG_PROTOCOL_EXT) != 0U)) {
+          res[len++] = (uint8_t)((nBlocks - 1U) >> 8U);
+        }
+        res[len++] = (uint8_t)(blockLen - 1U);
+      }
+      if ((info & RFAL_HOST_T5T_INFO_IC) != 0U) {
+        res[len++] = RFAL_HOST_T5T_IC_REF;
+      }
+      if ((info & RFAL_HOST_T5T_INFO_CMDLIST) != 0U) {
+        res[len++] = RFAL_HOST_T5T_CMDLIST_0;
+        res[len++] = RFAL_HOST_T5T_CMDLIST_1;
+        res[len++] = RFAL_HOST_T5T_CMDLIST_2;
+        res[len++] = RFAL_HOST_T5T_CMDLIST_3;
+      }
+      return len;
+
+    case RFAL_NFCV_CMD_READ_DYN_CONFIGURATION:
+    case RFAL_NFCV_CMD_FAST_READ_DYN_CONFIGURATION:
+    case RFAL_NFCV_CMD_WRITE_DYN_CONFIGURATION:
+    case RFAL_NFCV_CMD_FAST_WRITE_DYN_CONFIGURATION:
+    case RFAL_NFCV_CMD_WRITE_MESSAGE:
+    case RFAL_NFCV_CMD_FAST_WRITE_MESSAGE:
+    case RFAL_NFCV_CMD_READ_MESSAGE_LENGTH:
+    case RFAL_NFCV_CMD_FAST_READ_MESSAGE_LENGTH:
+    case RFAL_NFCV_CMD_READ_MESSAGE:
+    case RFAL_NFCV_CMD_FAST_READ_MESSAGE:
+      return mbCommand(cmd, p, pLen, res);
+
+    default:
+      return error((uint8_t)RFAL_NFCV_ERROR_CMD_NOT_SUPPORTED, res);
+  }
+}
+
+
+/*
+******************************************************************************
+* LOCAL FUNCTIONS
+******************************************************************************
+*/
+
+/*******************************************************************************/
+static void rfalHostSetSW(uint8_t *buf, uint16_t *len, uint16_t sw)
+{
+  buf[(*len)++] = (uint8_t)(sw >> 8U);
+  buf[(*len)++] = (uint8_t)(sw & 0xFFU);
+}
@@ -0,0 +1,351 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT 2021 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MIX MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/mix_myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+/*! \file
+ *
+ *  \author SRA
+ *
+ *  \brief RFAL host tag models
+ *
+ *  Tag models to be placed in the field of the host RF front-end
+ *  (rfal_rf_host.h), one per NFC Forum Tag Type:
+ *   - T2T : NTAG21x like, with GET_VERSION, FAST_READ and SECTOR_SELECT
+ *   - T3T : FeliCa Lite-S like, with configurable Nbr/Nbw
+ *   - T4T : ISO-DEP tag hosting the NDEF Tag Application (mapping v2.0)
+ *   - T5T : ST25DVxxK like, with extended and fast commands and the
+ *           Fast Transfer Mode Mailbox (see mbConfigure())
+ *
+ *  Each model answers the frames of its technology as the real tag would,
+ *  including its processing time, and keeps the memory content across
+ *  field resets so that a written message can be read back.
+ *  A freshly created tag is formatted (CC and empty NDEF message).
+ *
+ *
+ * \addtogroup RFAL
+ * @{
+ *
+ * \addtogroup RFAL-HAL
+ * @{
+ *
+ * \addtogroup Host
+ * @{
+ *
+ */
+
+
+#ifndef RFAL_HOST_TAGS_H
+#define RFAL_HOST_TAGS_H
+
+/*
+******************************************************************************
+* INCLUDES
+******************************************************************************
+*/
+#include "rfal_rf_host.h"
+
+/*
+******************************************************************************
+* GLOBAL DEFINES
+******************************************************************************
+*/
+
+#define RFAL_HOST_NFCA_UID_MAX_LEN        10U       /*!< NFC-A triple size UID length                              */
+#define RFAL_HOST_NFCA_FDT                1236U     /*!< NFC-A FDT, last bit 1: (n * 128 + 84) / fc, n = 9          */
+
+#define RFAL_HOST_T2T_PAGE_LEN            4U        /*!< T2T page length                                           */
+#define RFAL_HOST_T2T_SECTOR_PAGES        256U      /*!< T2T number of pages per sector                            */
+#define RFAL_HOST_T2T_VERSION_LEN         8U        /*!< T2T GET_VERSION response length                           */
+#define RFAL_HOST_T2T_WRITE_TIME          rfalConvUsTo1fc(4100U)   /*!< T2T EEPROM page write time (NTAG tWRITE) */
+
+#define RFAL_HOST_T3T_BLOCK_LEN           16U       /*!< T3T block length                                          */
+#define RFAL_HOST_T3T_NFCID2_LEN          8U        /*!< T3T NFCID2 length                                         */
+#define RFAL_HOST_T3T_NBR_DEFAULT         4U        /*!< T3T default Nbr (FeliCa Lite-S)                           */
+#define RFAL_HOST_T3T_NBW_DEFAULT         1U        /*!< T3T default Nbw (FeliCa Lite-S)                           */
+
+#define RFAL_HOST_T4T_FILE_MAX_LEN        0x7FFFU   /*!< T4T maximum NDEF file size emulated                       */
+#define RFAL_HOST_T4T_APDU_MAX_LEN        2048U     /*!< T4T maximum C-APDU/R-APDU length handled                  */
+#define RFAL_HOST_T4T_MLE                 0x00F6U   /*!< T4T default MLe advertised in the CC file                 */
+#define RFAL_HOST_T4T_MLC                 0x00F6U   /*!< T4T default MLc advertised in the CC file                 */
+#define RFAL_HOST_T4T_FWI                 7U        /*!< T4T FWI advertised in the ATS                             */
+#define RFAL_HOST_T4T_PROC_TIME           rfalConvUsTo1fc(500U)    /*!< T4T C-APDU processing time              */
+#define RFAL_HOST_T4T_WRITE_TIME          rfalConvUsTo1fc(1000U)   /*!< T4T write time per 16 bytes             */
+
+#define RFAL_HOST_T5T_UID_LEN             8U        /*!< T5T UID length                                            */
+#define RFAL_HOST_T5T_BLOCK_LEN           4U        /*!< T5T default block length                                  */
+#define RFAL_HOST_T5T_BLOCKS_DEFAULT      2048U     /*!< T5T default number of blocks (ST25DV64K)                  */
+#define RFAL_HOST_T5T_T1                  4320U     /*!< T5T response delay t1 nominal                             */
+#define RFAL_HOST_T5T_WRITE_TIME          rfalConvUsTo1fc(4000U)   /*!< T5T EEPROM block write time              */
+#define RFAL_HOST_T5T_MB_LEN              256U      /*!< T5T Fast Transfer Mode Mailbox length                     */
+#define RFAL_HOST_T5T_MB_HOST_LOG_LEN     8192U     /*!< Bytes read from the Mailbox by the host side, kept        */
+
+/*
+******************************************************************************
+* GLOBAL TYPES
+******************************************************************************
+*/
+
+/*! NFC-A listener: ISO14443-3A activation state machine */
+class RfalHostNfcaTag : public RfalHostTag {
+  public:
+    RfalHostNfcaTag(const uint8_t *uid, uint8_t uidLen, uint8_t atqa0, uint8_t atqa1, uint8_t sak);
+
+    rfalMode getMode(void);
+    void powerOn(void);
+    bool transceive(rfalHostFrameType type, const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime);
+
+  protected:
+    /*! Process a frame received in ACTIVE state */
+    virtual bool activeTransceive(const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime) = 0;
+
+    /*! Reset the upper layer state (power on, HLTA) */
+    virtual void activeReset(void) {}
+
+    /*! Move to HALT state (HLTA, ISO-DEP DESELECT) */
+    void halt(void);
+
+    /*! Leave ACTIVE state after an error, back to IDLE or HALT as before the activation */
+    void idle(void);
+
+    uint8_t  uid[RFAL_HOST_NFCA_UID_MAX_LEN];   /*!< UID                                                      */
+    uint8_t  uidLen;                            /*!< UID length                                               */
+
+  private:
+    bool getCascadeLevel(uint8_t cl, uint8_t *cln);
+
+    uint8_t  atqa[2];                           /*!< SENS_RES                                                 */
+    uint8_t  sak;                               /*!< SEL_RES of the last cascade level                        */
+    uint8_t  state;                             /*!< ISO14443-3A state                                        */
+    uint8_t  cl;                                /*!< Current cascade level                                    */
+    bool     halted;                            /*!< Tag was halted before the current activation             */
+};
+
+
+/*! T2T: NTAG21x like tag */
+class RfalHostT2TTag : public RfalHostNfcaTag {
+  public:
+    /*!
+     *****************************************************************************
+     * \brief  Create a formatted T2T
+     *
+     * \param[in]  uid7     : 7 bytes UID
+     * \param[in]  dataSize : user memory size in bytes (multiple of 8)
+     * \param[in]  version  : GET_VERSION response, NULL if not supported
+     *****************************************************************************
+     */
+    RfalHostT2TTag(const uint8_t *uid7, uint16_t dataSize, const uint8_t *version);
+    ~RfalHostT2TTag();
+
+    uint8_t *getMemory(void);
+    uint32_t getMemoryLen(void);
+
+  protected:
+    bool activeTransceive(const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime);
+    void activeReset(void);
+
+  private:
+    uint16_t sectorPages(void);
+    bool nak(uint8_t *res, uint16_t *resBits, uint32_t *resTime);
+    bool ack(uint8_t *res, uint16_t *resBits, uint32_t *resTime, uint32_t t);
+
+    uint8_t *mem;                               /*!< Memory content                                           */
+    uint32_t pages;                             /*!< Number of pages                                          */
+    uint8_t  sector;                            /*!< Current sector                                           */
+    bool     secSelPending;                     /*!< SECTOR_SELECT packet 1 acknowledged                      */
+    bool     hasVersion;                        /*!< GET_VERSION supported                                    */
+    uint8_t  version[RFAL_HOST_T2T_VERSION_LEN];/*!< GET_VERSION response                                     */
+};
+
+
+/*! T4T: ISO-DEP tag hosting the NDEF Tag Application */
+class RfalHostT4TTag : public RfalHostNfcaTag {
+  public:
+    /*!
+     *****************************************************************************
+     * \brief  Create a formatted T4T
+     *
+     * \param[in]  uid7     : 7 bytes UID
+     * \param[in]  fileSize : NDEF file size in bytes, NLEN included
+     * \param[in]  mLe      : MLe advertised in the CC file
+     * \param[in]  mLc      : MLc advertised in the CC file
+     *                        extended APDUs are only accepted when either exceeds
+     *                        the short field coding range
+     *****************************************************************************
+     */
+    RfalHostT4TTag(const uint8_t *uid7, uint16_t fileSize, uint16_t mLe, uint16_t mLc);
+    ~RfalHostT4TTag();
+
+    uint8_t *getMemory(void);
+    uint32_t getMemoryLen(void);
+
+  protected:
+    bool activeTransceive(const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime);
+    void activeReset(void);
+
+  private:
+    uint16_t processApdu(const uint8_t *capdu, uint16_t capduLen, uint8_t *rapdu, uint32_t *procTime);
+    uint16_t sendChunk(uint8_t bn, uint8_t *res);
+
+    uint8_t  *ndefFile;                         /*!< NDEF file content                                        */
+    uint16_t  ndefFileLen;                      /*!< NDEF file size                                           */
+    uint8_t   ccFile[15];                       /*!< CC file content                                          */
+    bool      extApdu;                          /*!< Extended Lc/Le field coding supported                    */
+    bool      isoDep;                           /*!< ISO-DEP activated (RATS received)                        */
+    uint16_t  fsd;                              /*!< FSD from RATS                                            */
+    bool      appSelected;                      /*!< NDEF Tag Application selected                            */
+    uint8_t   fileSelected;                     /*!< Selected file: 0 none, 1 CC, 2 NDEF                      */
+    uint8_t   cid;                              /*!< CID byte of the last block, if any                       */
+    bool      hasCid;                           /*!< Last block carried a CID                                 */
+    uint8_t   apdu[RFAL_HOST_T4T_APDU_MAX_LEN]; /*!< C-APDU being received                                    */
+    uint16_t  apduLen;                          /*!< C-APDU length                                            */
+    uint8_t   rapdu[RFAL_HOST_T4T_APDU_MAX_LEN];/*!< R-APDU being sent                                        */
+    uint16_t  rapduLen;                         /*!< R-APDU length                                            */
+    uint16_t  rapduOff;                         /*!< R-APDU bytes already sent                                */
+    uint16_t  lastChunk;                        /*!< Length of the last R-APDU chunk sent                     */
+    uint32_t  pendingTime;                      /*!< Remaining processing time behind a S(WTX)                */
+};
+
+
+/*! T3T: FeliCa Lite-S like tag */
+class RfalHostT3TTag : public RfalHostTag {
+  public:
+    /*!
+     *****************************************************************************
+     * \brief  Create a formatted T3T
+     *
+     * \param[in]  nfcid2  : 8 bytes NFCID2
+     * \param[in]  nBlocks : number of data blocks (AIB excluded)
+     * \param[in]  nbr     : number of blocks read at once advertised in the AIB
+     * \param[in]  nbw     : number of blocks written at once advertised in the AIB
+     *****************************************************************************
+     */
+    RfalHostT3TTag(const uint8_t *nfcid2, uint16_t nBlocks, uint8_t nbr, uint8_t nbw);
+    ~RfalHostT3TTag();
+
+    rfalMode getMode(void);
+    void powerOn(void);
+    bool transceive(rfalHostFrameType type, const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime);
+
+    uint8_t *getMemory(void);
+    uint32_t getMemoryLen(void);
+
+  private:
+    bool parseBlockList(const uint8_t *req, uint16_t reqLen, uint16_t *pos, uint8_t *nBlk, uint16_t *blocks, uint8_t maxBlk, uint8_t *st2);
+    uint32_t responseTime(uint8_t param, uint8_t n);
+
+    uint8_t  *mem;                              /*!< Memory content, block 0 is the AIB                       */
+    uint16_t  nBlocks;                          /*!< Number of blocks, AIB included                           */
+    uint8_t   nfcid2[RFAL_HOST_T3T_NFCID2_LEN]; /*!< NFCID2                                                   */
+    uint8_t   pmm[RFAL_HOST_T3T_NFCID2_LEN];    /*!< PMm                                                      */
+    uint8_t   nbr;                              /*!< Maximum blocks per CHECK                                 */
+    uint8_t   nbw;                              /*!< Maximum blocks per UPDATE                                */
+};
+
+
+/*! T5T: ST25DVxxK like tag */
+class RfalHostT5TTag : public RfalHostTag {
+  public:
+    /*!
+     *****************************************************************************
+     * \brief  Create a formatted T5T
+     *
+     * \param[in]  uid      : 8 bytes UID, LSB first
+     * \param[in]  blockLen : block length in bytes
+     * \param[in]  nBlocks  : number of blocks
+     *****************************************************************************
+     */
+    RfalHostT5TTag(const uint8_t *uid, uint8_t blockLen, uint16_t nBlocks);
+    ~RfalHostT5TTag();
+
+    rfalMode getMode(void);
+    void powerOn(void);
+    bool transceive(rfalHostFrameType type, const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime);
+
+    uint8_t *getMemory(void);
+    uint32_t getMemoryLen(void);
+
+    /*!
+     *****************************************************************************
+     * \brief  Configure the Fast Transfer Mode Mailbox (MB_MODE)
+     *
+     * The reader enables it by setting MB_EN in MB_CTRL_Dyn.
+     * The host (I2C) side reads each message put by the reader hostTime
+     * after it was put and, in echo mode, puts the same bytes back for the
+     * reader. The tag does not answer RF requests during the last i2cTime
+     * of hostTime (Mailbox accessed over I2C).
+     *
+     * \param[in]  hostTime : host response time in 1/fc
+     * \param[in]  i2cTime  : host Mailbox access time in 1/fc
+     * \param[in]  echo     : put every message read back for the reader
+     *****************************************************************************
+     */
+    void mbConfigure(uint32_t hostTime, uint32_t i2cTime, bool echo);
+
+    /*!
+     *****************************************************************************
+     * \brief  Get the bytes read from the Mailbox by the host side
+     *
+     * \param[out] len      : number of bytes read since mbConfigure(), the
+     *                        first RFAL_HOST_T5T_MB_HOST_LOG_LEN are returned
+     *
+     * \return the bytes read, NULL if the Mailbox is not configured
+     *****************************************************************************
+     */
+    const uint8_t *mbGetHostData(uint32_t *len);
+
+  private:
+    bool inventory(const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime);
+    uint16_t command(uint8_t flags, uint8_t cmd, const uint8_t *p, uint16_t pLen, uint8_t *res, uint32_t *resTime, bool *respond);
+    uint16_t error(uint8_t code, uint8_t *res);
+    uint16_t mbCommand(uint8_t cmd, const uint8_t *p, uint16_t pLen, uint8_t *res);
+    void mbHostUpdate(void);
+
+    uint8_t  *mem;                              /*!< Memory content                                           */
+    uint16_t  nBlocks;                          /*!< Number of blocks                                         */
+    uint8_t   blockLen;                         /*!< Block length                                             */
+    uint8_t   uid[RFAL_HOST_T5T_UID_LEN];       /*!< UID, LSB first                                           */
+    uint8_t   state;                            /*!< ISO15693 state                                           */
+    bool      invPending;                       /*!< Inventory response pending on a later slot               */
+    uint8_t   invSlot;                          /*!< Current inventory slot                                   */
+    uint8_t   mySlot;                           /*!< Inventory slot of this tag                               */
+    uint8_t   pendingRes[2];                    /*!< Response to a request with Option flag, sent on EOF      */
+    uint8_t   pendingLen;                       /*!< Length of the pending response                           */
+    bool      mbMode;                           /*!< Mailbox configured (MB_MODE)                             */
+    uint8_t   mbCtrl;                           /*!< MB_CTRL_Dyn register                                     */
+    uint8_t   mb[RFAL_HOST_T5T_MB_LEN];         /*!< Mailbox content                                          */
+    uint16_t  mbLen;                            /*!< Length of the message in the Mailbox                     */
+    uint32_t  mbHostTime;                       /*!< Host response time in 1/fc                               */
+    uint32_t  mbI2cTime;                        /*!< Host Mailbox access time in 1/fc                         */
+    bool      mbEcho;                           /*!< Host puts every message read back                        */
+    bool      mbHostPending;                    /*!< Host to read the message put by the reader               */
+    uint64_t  mbHostAt;                         /*!< Time at which the host reads it                          */
+    uint8_t  *mbHostLog;                        /*!< Bytes read by the host                                   */
+    uint32_t  mbHostLogLen;                     /*!< Number of bytes read by the host                         */
+};
+
+#endif /* RFAL_HOST_TAGS_H */
+
+/**
+  * @}
+  *
+  * @}
+  *
+  * @}
+  */
@@ -0,0 +1,1116 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT 2021 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MIX MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/mix_myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+/*! \file
+ *
+ *  \author SRA
+ *
+ *  \brief RFAL host RF front-end
+ *
+ */
+
+/*
+******************************************************************************
+* INCLUDES
+******************************************************************************
+*/
+#include "rfal_rf_host.h"
+#include "nfc_utils.h"
+
+/*
+******************************************************************************
+* LOCAL DEFINES
+******************************************************************************
+*/
+
+#define RFAL_HOST_NFCA_SOF_EOF_BITS       2U        /*!< NFC-A Start and End of communication bits                  */
+#define RFAL_HOST_NFCA_SHORTFRAME_BITS    7U        /*!< NFC-A short frame length in bits                           */
+#define RFAL_HOST_NFCA_SDD_BUF_LEN        7U        /*!< NFC-A SDD buffer length: SEL, NVB, 4 bytes CLn and BCC     */
+#define RFAL_HOST_NFCB_SOF_EOF_BITS       20U       /*!< NFC-B SoF and EoF length in etu                            */
+#define RFAL_HOST_NFCB_BITS_PER_BYTE      10U       /*!< NFC-B character length in etu (start + 8 + stop)           */
+#define RFAL_HOST_NFCF_PREAMBLE_BITS      48U       /*!< NFC-F preamble length in bits                              */
+#define RFAL_HOST_NFCF_SYNC_BITS          16U       /*!< NFC-F sync code length in bits                             */
+#define RFAL_HOST_NFCV_VCD_SOF            1024U     /*!< NFC-V VCD SOF duration in 1/fc (1 out of 4)                */
+#define RFAL_HOST_NFCV_VCD_EOF            512U      /*!< NFC-V VCD EOF duration in 1/fc                             */
+#define RFAL_HOST_NFCV_VICC_SOF_EOF_BITS  8U        /*!< NFC-V VICC SOF and EOF duration in bit periods             */
+
+#define RFAL_HOST_NFCF_POLL_REQ_LEN       6U        /*!< SENSF_REQ length including LEN                             */
+#define RFAL_HOST_NFCF_CMD_POLLING        0x00U     /*!< SENSF_REQ command code                                     */
+
+
+/*
+******************************************************************************
+* LOCAL VARIABLES
+******************************************************************************
+*/
+
+static uint64_t gRfalHostClock;                     /*!< Virtual clock in 1/fc                                      */
+
+
+/*
+******************************************************************************
+* LOCAL FUNCTION PROTOTYPES
+******************************************************************************
+*/
+
+static uint32_t rfalHostBitTime(rfalBitRate br);
+
+
+/*
+******************************************************************************
+* GLOBAL FUNCTIONS
+******************************************************************************
+*/
+
+/*******************************************************************************/
+uint64_t rfalHostGetTime(void)
+{
+  return gRfalHostClock;
+}
+
+
+/*******************************************************************************/
+void rfalHostAdvanceTime(uint64_t t)
+{
+  gRfalHostClock += t;
+}
+
+
+/*******************************************************************************/
+uint32_t millis(void)
+{
+  /* Each call costs some CPU time, so that busy waits on millis() progress */
+  gRfalHostClock += RFAL_HOST_CPU_TICK;
+  return (uint32_t)(gRfalHostClock / RFAL_1MS_IN_1FC);
+}
+
+
+/*******************************************************************************/
+void delay(uint32_t ms)
+{
+  gRfalHostClock += ((uint64_t)ms * RFAL_1MS_IN_1FC);
+}
+
+
+/*******************************************************************************/
+RfalRfHostClass::RfalRfHostClass(void)
+{
+  ST_MEMSET(&gRFAL, 0x00, sizeof(gRFAL));
+
+  gRFAL.state      = RFAL_STATE_IDLE;
+  gRFAL.mode       = RFAL_MODE_NONE;
+  gRFAL.txrxStatus = ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalInitialize(void)
+{
+  RfalHostTag *tag;
+
+  /* Keep the tag in the field across re-initializations */
+  tag = gRFAL.tag;
+  ST_MEMSET(&gRFAL, 0x00, sizeof(gRFAL));
+  gRFAL.tag = tag;
+
+  gRFAL.state      = RFAL_STATE_INIT;
+  gRFAL.mode       = RFAL_MODE_NONE;
+  gRFAL.txBR       = RFAL_BR_106;
+  gRFAL.rxBR       = RFAL_BR_106;
+  gRFAL.eHandling  = RFAL_ERRORHANDLING_NONE;
+  gRFAL.txrxStatus = ERR_NONE;
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalCalibrate(void)
+{
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalAdjustRegulators(uint16_t *result)
+{
+  if (result != NULL) {
+    *result = 0;
+  }
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalSetUpperLayerCallback(rfalUpperLayerCallback pFunc)
+{
+  gRFAL.upperLayer = pFunc;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalSetPreTxRxCallback(rfalPreTxRxCallback pFunc)
+{
+  gRFAL.preTxRx = pFunc;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalSetPostTxRxCallback(rfalPostTxRxCallback pFunc)
+{
+  gRFAL.postTxRx = pFunc;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalDeinitialize(void)
+{
+  gRFAL.field = false;
+  gRFAL.state = RFAL_STATE_IDLE;
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalSetMode(rfalMode mode, rfalBitRate txBR, rfalBitRate rxBR)
+{
+  if (gRFAL.state == RFAL_STATE_IDLE) {
+    return ERR_WRONG_STATE;
+  }
+
+  if ((txBR == RFAL_BR_KEEP) || (rxBR == RFAL_BR_KEEP)) {
+    return ERR_PARAM;
+  }
+
+  /* Listen mode is not emulated */
+  if (rfalIsModePassiveListen(mode) || (mode == RFAL_MODE_LISTEN_ACTIVE_P2P)) {
+    return ERR_NOTSUPP;
+  }
+
+  gRFAL.mode  = mode;
+  gRFAL.txBR  = txBR;
+  gRFAL.rxBR  = rxBR;
+  gRFAL.state = RFAL_STATE_MODE_SET;
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+rfalMode RfalRfHostClass::rfalGetMode(void)
+{
+  return gRFAL.mode;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalSetBitRate(rfalBitRate txBR, rfalBitRate rxBR)
+{
+  if (gRFAL.state < RFAL_STATE_MODE_SET) {
+    return ERR_WRONG_STATE;
+  }
+
+  if (txBR != RFAL_BR_KEEP) {
+    gRFAL.txBR = txBR;
+  }
+  if (rxBR != RFAL_BR_KEEP) {
+    gRFAL.rxBR = rxBR;
+  }
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalGetBitRate(rfalBitRate *txBR, rfalBitRate *rxBR)
+{
+  if ((gRFAL.state < RFAL_STATE_MODE_SET) || (gRFAL.mode == RFAL_MODE_NONE)) {
+    return ERR_WRONG_STATE;
+  }
+
+  if (txBR != NULL) {
+    *txBR = gRFAL.txBR;
+  }
+  if (rxBR != NULL) {
+    *rxBR = gRFAL.rxBR;
+  }
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalSetErrorHandling(rfalEHandling eHandling)
+{
+  gRFAL.eHandling = eHandling;
+}
+
+
+/*******************************************************************************/
+rfalEHandling RfalRfHostClass::rfalGetErrorHandling(void)
+{
+  return gRFAL.eHandling;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalSetObsvMode(uint8_t txMode, uint8_t rxMode)
+{
+  gRFAL.obsvTx = txMode;
+  gRFAL.obsvRx = rxMode;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalGetObsvMode(uint8_t *txMode, uint8_t *rxMode)
+{
+  if (txMode != NULL) {
+    *txMode = gRFAL.obsvTx;
+  }
+  if (rxMode != NULL) {
+    *rxMode = gRFAL.obsvRx;
+  }
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalDisableObsvMode(void)
+{
+  gRFAL.obsvTx = 0;
+  gRFAL.obsvRx = 0;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalSetFDTPoll(uint32_t FDTPoll)
+{
+  gRFAL.FDTPoll = FDTPoll;
+}
+
+
+/*******************************************************************************/
+uint32_t RfalRfHostClass::rfalGetFDTPoll(void)
+{
+  return gRFAL.FDTPoll;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalSetFDTListen(uint32_t FDTListen)
+{
+  gRFAL.FDTListen = FDTListen;
+}
+
+
+/*******************************************************************************/
+uint32_t RfalRfHostClass::rfalGetFDTListen(void)
+{
+  return gRFAL.FDTListen;
+}
+
+
+/*******************************************************************************/
+uint32_t RfalRfHostClass::rfalGetGT(void)
+{
+  return gRFAL.GT;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalSetGT(uint32_t GT)
+{
+  gRFAL.GT = GT;
+}
+
+
+/*******************************************************************************/
+bool RfalRfHostClass::rfalIsGTExpired(void)
+{
+  /* Callers busy wait on the GT, let the time run */
+  gRfalHostClock += RFAL_HOST_CPU_TICK;
+  return (gRfalHostClock >= gRFAL.GTEnd);
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalFieldOnAndStartGT(void)
+{
+  if (gRFAL.state < RFAL_STATE_INIT) {
+    return ERR_WRONG_STATE;
+  }
+
+  if (!gRFAL.field) {
+    gRFAL.field = true;
+    if (gRFAL.tag != NULL) {
+      gRFAL.tag->powerOn();
+    }
+  }
+
+  gRFAL.GTEnd     = (gRfalHostClock + gRFAL.GT);
+  gRFAL.lastRxEnd = 0;
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalFieldOff(void)
+{
+  gRFAL.field = false;
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalStartTransceive(const rfalTransceiveContext *ctx)
+{
+  ReturnCode ret;
+  uint16_t   txLen;
+  uint16_t   txBits;
+  uint16_t   hdrLen;
+
+  if (ctx == NULL) {
+    return ERR_PARAM;
+  }
+
+  if ((gRFAL.state < RFAL_STATE_MODE_SET) || (gRFAL.mode == RFAL_MODE_NONE)) {
+    return ERR_WRONG_STATE;
+  }
+
+  if (gRFAL.preTxRx != NULL) {
+    gRFAL.preTxRx();
+  }
+
+  /* Build the frame as seen by the tag: without CRC and, on NFC-F, with the LEN byte */
+  txBits = ctx->txBufLen;
+  if (((ctx->flags & (uint32_t)RFAL_TXRX_FLAGS_CRC_TX_MANUAL) != 0U) && (txBits >= rfalConvBytesToBits(RFAL_CRC_LEN))) {
+    txBits -= (uint16_t)rfalConvBytesToBits(RFAL_CRC_LEN);
+  }
+
+  txLen  = rfalConvBitsToBytes(txBits);
+  hdrLen = ((gRFAL.mode == RFAL_MODE_POLL_NFCF) && (txLen > 0U)) ? 1U : 0U;
+
+  if ((txLen + hdrLen) > RFAL_HOST_FRAME_MAX_LEN) {
+    return ERR_NOMEM;
+  }
+
+  if (hdrLen != 0U) {
+    gRFAL.txFrame[0] = (uint8_t)(txLen + hdrLen);
+    txBits += (uint16_t)rfalConvBytesToBits(hdrLen);
+  }
+  if ((txLen > 0U) && (ctx->txBuf != NULL)) {
+    ST_MEMCPY(&gRFAL.txFrame[hdrLen], ctx->txBuf, txLen);
+  }
+
+  gRFAL.state = RFAL_STATE_TXRX;
+  ret = rfalHostExchange(RFAL_HOST_FRAME_STD, gRFAL.txFrame, txBits, ctx->fwt);
+
+  /* The response reaches the caller's buffer on the next status poll, as the FIFO
+   * of a real front-end would: the caller may still use the buffer meanwhile      */
+  gRFAL.txrxStatus = ret;
+  gRFAL.txrxCtx    = *ctx;
+  gRFAL.rxPending  = true;
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalHostCompleteTransceive(void)
+{
+  const rfalTransceiveContext *ctx;
+  ReturnCode                   ret;
+  uint16_t                     rcvd;
+
+  if (!gRFAL.rxPending) {
+    return;
+  }
+  gRFAL.rxPending = false;
+
+  ctx  = &gRFAL.txrxCtx;
+  ret  = gRFAL.txrxStatus;
+  rcvd = 0;
+  if ((ret == ERR_NONE) || (ret == ERR_INCOMPLETE_BYTE)) {
+    rcvd = rfalHostCopyRx(ctx->rxBuf, rfalConvBitsToBytes(ctx->rxBufLen), ((ctx->flags & (uint32_t)RFAL_TXRX_FLAGS_CRC_RX_KEEP) != 0U), &ret);
+  }
+
+  if (ctx->rxRcvdLen != NULL) {
+    *ctx->rxRcvdLen = rcvd;
+  }
+
+  gRFAL.txrxStatus = ret;
+  gRFAL.state      = RFAL_STATE_MODE_SET;
+
+  if (gRFAL.postTxRx != NULL) {
+    gRFAL.postTxRx();
+  }
+}
+
+
+/*******************************************************************************/
+rfalTransceiveState RfalRfHostClass::rfalGetTransceiveState(void)
+{
+  return RFAL_TXRX_STATE_IDLE;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalGetTransceiveStatus(void)
+{
+  gRfalHostClock += RFAL_HOST_CPU_TICK;
+  rfalHostCompleteTransceive();
+  return gRFAL.txrxStatus;
+}
+
+
+/*******************************************************************************/
+bool RfalRfHostClass::rfalIsTransceiveInTx(void)
+{
+  return false;
+}
+
+
+/*******************************************************************************/
+bool RfalRfHostClass::rfalIsTransceiveInRx(void)
+{
+  return false;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalGetTransceiveRSSI(uint16_t *rssi)
+{
+  if (rssi != NULL) {
+    *rssi = 0;
+  }
+  return ERR_NOTSUPP;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalWorker(void)
+{
+  gRfalHostClock += RFAL_HOST_CPU_TICK;
+  rfalHostCompleteTransceive();
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalISO14443ATransceiveShortFrame(rfal14443AShortFrameCmd txCmd, uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *rxRcvdLen, uint32_t fwt)
+{
+  ReturnCode ret;
+  uint16_t   rcvd;
+
+  if ((rxBuf == NULL) || (rxRcvdLen == NULL) || (fwt == RFAL_FWT_NONE)) {
+    return ERR_PARAM;
+  }
+
+  if ((gRFAL.state < RFAL_STATE_MODE_SET) || ((gRFAL.mode != RFAL_MODE_POLL_NFCA) && (gRFAL.mode != RFAL_MODE_POLL_NFCA_T1T))) {
+    return ERR_WRONG_STATE;
+  }
+
+  gRFAL.txFrame[0] = (uint8_t)txCmd;
+  ret = rfalHostExchange(RFAL_HOST_FRAME_SHORT, gRFAL.txFrame, RFAL_HOST_NFCA_SHORTFRAME_BITS, fwt);
+
+  rcvd = 0;
+  if ((ret == ERR_NONE) || (ret == ERR_INCOMPLETE_BYTE)) {
+    rcvd = rfalHostCopyRx(rxBuf, rfalConvBitsToBytes(rxBufLen), false, &ret);
+  }
+  *rxRcvdLen = rcvd;
+
+  return ret;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalISO14443ATransceiveAnticollisionFrame(uint8_t *buf, uint8_t *bytesToSend, uint8_t *bitsToSend, uint16_t *rxLength, uint32_t fwt)
+{
+  ReturnCode ret;
+  uint16_t   txBits;
+  uint16_t   rcvd;
+
+  if ((buf == NULL) || (bytesToSend == NULL) || (bitsToSend == NULL) || (rxLength == NULL)) {
+    return ERR_PARAM;
+  }
+
+  if ((gRFAL.state < RFAL_STATE_MODE_SET) || (gRFAL.mode != RFAL_MODE_POLL_NFCA)) {
+    return ERR_WRONG_STATE;
+  }
+
+  /* SDD_REQ: SEL, NVB and the known part of the UID, the response is placed right after it */
+  txBits = (uint16_t)(rfalConvBytesToBits(*bytesToSend) + *bitsToSend);
+  ret    = rfalHostExchange(RFAL_HOST_FRAME_SDD, buf, txBits, fwt);
+
+  rcvd = 0;
+  if ((ret == ERR_NONE) || (ret == ERR_INCOMPLETE_BYTE)) {
+    rcvd = rfalHostCopyRx(&buf[*bytesToSend], (uint16_t)(RFAL_HOST_NFCA_SDD_BUF_LEN - *bytesToSend), false, &ret);
+  }
+  *rxLength = rcvd;
+
+  return ret;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalFeliCaPoll(rfalFeliCaPollSlots slots, uint16_t sysCode, uint8_t reqCode, rfalFeliCaPollRes *pollResList, uint8_t pollResListSize, uint8_t *devicesDetected, uint8_t *collisionsDetected)
+{
+  ReturnCode ret;
+  uint32_t   window;
+  uint16_t   rcvd;
+  uint8_t    devCnt;
+
+  if ((pollResList == NULL) || (pollResListSize == 0U)) {
+    return ERR_PARAM;
+  }
+
+  if ((gRFAL.state < RFAL_STATE_MODE_SET) || (gRFAL.mode != RFAL_MODE_POLL_NFCF)) {
+    return ERR_WRONG_STATE;
+  }
+
+  gRFAL.txFrame[0] = RFAL_HOST_NFCF_POLL_REQ_LEN;
+  gRFAL.txFrame[1] = RFAL_HOST_NFCF_CMD_POLLING;
+  gRFAL.txFrame[2] = (uint8_t)(sysCode >> 8U);
+  gRFAL.txFrame[3] = (uint8_t)(sysCode & 0xFFU);
+  gRFAL.txFrame[4] = reqCode;
+  gRFAL.txFrame[5] = (uint8_t)slots;
+
+  /* The poller listens for the whole set of time slots regardless of responses */
+  window = (RFAL_HOST_FELICA_POLL_DELAY + (((uint32_t)slots + 1U) * RFAL_HOST_FELICA_POLL_SLOT));
+  ret    = rfalHostExchange(RFAL_HOST_FRAME_STD, gRFAL.txFrame, (uint16_t)rfalConvBytesToBits(RFAL_HOST_NFCF_POLL_REQ_LEN), window);
+
+  devCnt = 0;
+  if (ret == ERR_NONE) {
+    rcvd = rfalHostCopyRx(pollResList[0], sizeof(rfalFeliCaPollRes), false, &ret);
+    if ((ret == ERR_NONE) && (rcvd > 0U)) {
+      devCnt = 1;
+    }
+  }
+
+  if (gRfalHostClock < (gRFAL.txEnd + window)) {
+    gRfalHostClock  = (gRFAL.txEnd + window);
+    gRFAL.lastRxEnd = gRfalHostClock;
+  }
+
+  if (devicesDetected != NULL) {
+    *devicesDetected = devCnt;
+  }
+  if (collisionsDetected != NULL) {
+    *collisionsDetected = 0;
+  }
+
+  return ((devCnt > 0U) ? ERR_NONE : ERR_TIMEOUT);
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalISO15693TransceiveAnticollisionFrame(uint8_t *txBuf, uint8_t txBufLen, uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen)
+{
+  ReturnCode ret;
+  uint16_t   rcvd;
+
+  if ((txBuf == NULL) || (rxBuf == NULL) || (actLen == NULL)) {
+    return ERR_PARAM;
+  }
+
+  if ((gRFAL.state < RFAL_STATE_MODE_SET) || (gRFAL.mode != RFAL_MODE_POLL_NFCV)) {
+    return ERR_WRONG_STATE;
+  }
+
+  ret = rfalHostExchange(RFAL_HOST_FRAME_STD, txBuf, (uint16_t)rfalConvBytesToBits(txBufLen), RFAL_HOST_NFCV_FWT_ANTICOL);
+
+  rcvd = 0;
+  if ((ret == ERR_NONE) || (ret == ERR_INCOMPLETE_BYTE)) {
+    /* Length reported as received, including the CRC */
+    rcvd = (uint16_t)(gRFAL.rxFrameBits + rfalConvBytesToBits(RFAL_CRC_LEN));
+    rfalHostCopyRx(rxBuf, rxBufLen, false, &ret);
+    if (ret == ERR_NOMEM) {
+      ret = ERR_NONE;
+    }
+  }
+  *actLen = rcvd;
+
+  return ret;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalISO15693TransceiveEOFAnticollision(uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen)
+{
+  ReturnCode ret;
+  uint16_t   rcvd;
+
+  if ((rxBuf == NULL) || (actLen == NULL)) {
+    return ERR_PARAM;
+  }
+
+  if ((gRFAL.state < RFAL_STATE_MODE_SET) || (gRFAL.mode != RFAL_MODE_POLL_NFCV)) {
+    return ERR_WRONG_STATE;
+  }
+
+  ret = rfalHostExchange(RFAL_HOST_FRAME_EOF, gRFAL.txFrame, 0, RFAL_HOST_NFCV_FWT_ANTICOL);
+
+  rcvd = 0;
+  if ((ret == ERR_NONE) || (ret == ERR_INCOMPLETE_BYTE)) {
+    rcvd = (uint16_t)(gRFAL.rxFrameBits + rfalConvBytesToBits(RFAL_CRC_LEN));
+    rfalHostCopyRx(rxBuf, rxBufLen, false, &ret);
+    if (ret == ERR_NOMEM) {
+      ret = ERR_NONE;
+    }
+  }
+  *actLen = rcvd;
+
+  return ret;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalISO15693TransceiveEOF(uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen)
+{
+  ReturnCode ret;
+  uint16_t   rcvd;
+
+  if ((rxBuf == NULL) || (actLen == NULL)) {
+    return ERR_PARAM;
+  }
+
+  if ((gRFAL.state < RFAL_STATE_MODE_SET) || (gRFAL.mode != RFAL_MODE_POLL_NFCV)) {
+    return ERR_WRONG_STATE;
+  }
+
+  ret = rfalHostExchange(RFAL_HOST_FRAME_EOF, gRFAL.txFrame, 0, RFAL_HOST_NFCV_FWT_EOF);
+
+  rcvd = 0;
+  if ((ret == ERR_NONE) || (ret == ERR_INCOMPLETE_BYTE)) {
+    rcvd = rfalHostCopyRx(rxBuf, rxBufLen, false, &ret);
+  }
+  *actLen = rfalConvBitsToBytes(rcvd);
+
+  return ret;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalTransceiveBlockingTx(uint8_t *txBuf, uint16_t txBufLen, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *actLen, uint32_t flags, uint32_t fwt)
+{
+  rfalTransceiveContext ctx;
+
+  rfalCreateByteFlagsTxRxContext(ctx, txBuf, txBufLen, rxBuf, rxBufLen, actLen, flags, fwt);
+  return rfalStartTransceive(&ctx);
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalTransceiveBlockingRx(void)
+{
+  rfalHostCompleteTransceive();
+  return gRFAL.txrxStatus;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalTransceiveBlockingTxRx(uint8_t *txBuf, uint16_t txBufLen, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *actLen, uint32_t flags, uint32_t fwt)
+{
+  ReturnCode ret;
+
+  EXIT_ON_ERR(ret, rfalTransceiveBlockingTx(txBuf, txBufLen, rxBuf, rxBufLen, actLen, flags, fwt));
+  ret = rfalTransceiveBlockingRx();
+
+  /* Convert received bits to bytes */
+  if (actLen != NULL) {
+    *actLen = rfalConvBitsToBytes(*actLen);
+  }
+
+  return ret;
+}
+
+
+/*******************************************************************************/
+bool RfalRfHostClass::rfalIsExtFieldOn(void)
+{
+  return false;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalListenStart(uint32_t lmMask, const rfalLmConfPA *confA, const rfalLmConfPB *confB, const rfalLmConfPF *confF, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rxLen)
+{
+  NO_WARNING(lmMask);
+  NO_WARNING(confA);
+  NO_WARNING(confB);
+  NO_WARNING(confF);
+  NO_WARNING(rxBuf);
+  NO_WARNING(rxBufLen);
+  NO_WARNING(rxLen);
+
+  return ERR_NOTSUPP;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalListenSleepStart(rfalLmState sleepSt, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rxLen)
+{
+  NO_WARNING(sleepSt);
+  NO_WARNING(rxBuf);
+  NO_WARNING(rxBufLen);
+  NO_WARNING(rxLen);
+
+  return ERR_NOTSUPP;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalListenStop(void)
+{
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+rfalLmState RfalRfHostClass::rfalListenGetState(bool *dataFlag, rfalBitRate *lastBR)
+{
+  if (dataFlag != NULL) {
+    *dataFlag = false;
+  }
+  if (lastBR != NULL) {
+    *lastBR = RFAL_BR_KEEP;
+  }
+  return RFAL_LM_STATE_NOT_INIT;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalListenSetState(rfalLmState newSt)
+{
+  NO_WARNING(newSt);
+  return ERR_NOTSUPP;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalWakeUpModeStart(const rfalWakeUpConfig *config)
+{
+  uint8_t period;
+
+  if (config == NULL) {
+    return ERR_PARAM;
+  }
+
+  /* Wake-Up timer: 10ms steps up to 80ms, 100ms steps from 100ms onwards */
+  period = (uint8_t)config->period;
+  if (period < (uint8_t)RFAL_WUM_PERIOD_100MS) {
+    gRFAL.wumPeriod = rfalConvMsTo1fc(((uint32_t)period + 1U) * 10U);
+  } else {
+    gRFAL.wumPeriod = rfalConvMsTo1fc(((uint32_t)period - (uint32_t)RFAL_WUM_PERIOD_100MS + 1U) * 100U);
+  }
+
+  gRFAL.field      = false;
+  gRFAL.wumEnabled = true;
+  gRFAL.state      = RFAL_STATE_WUM;
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+bool RfalRfHostClass::rfalWakeUpModeHasWoke(void)
+{
+  if (!gRFAL.wumEnabled) {
+    return false;
+  }
+
+  /* One measurement per period, a tag in the field is always detected */
+  gRfalHostClock += gRFAL.wumPeriod;
+  return (gRFAL.tag != NULL);
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalWakeUpModeStop(void)
+{
+  if (!gRFAL.wumEnabled) {
+    return ERR_WRONG_STATE;
+  }
+
+  gRFAL.wumEnabled = false;
+  gRFAL.state      = RFAL_STATE_MODE_SET;
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalHostSetTag(RfalHostTag *tag)
+{
+  gRFAL.tag = tag;
+
+  if ((tag != NULL) && gRFAL.field) {
+    tag->powerOn();
+  }
+}
+
+
+/*******************************************************************************/
+RfalHostTag *RfalRfHostClass::rfalHostGetTag(void)
+{
+  return gRFAL.tag;
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalHostGetStats(rfalHostStats *stats)
+{
+  if (stats != NULL) {
+    ST_MEMCPY(stats, &gRFAL.stats, sizeof(rfalHostStats));
+  }
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalHostClearStats(void)
+{
+  ST_MEMSET(&gRFAL.stats, 0x00, sizeof(rfalHostStats));
+}
+
+
+/*
+******************************************************************************
+* LOCAL FUNCTIONS
+******************************************************************************
+*/
+
+/*******************************************************************************/
+ReturnCode RfalRfHostClass::rfalHostExchange(rfalHostFrameType type, const uint8_t *txBuf, uint16_t txBits, uint32_t fwt)
+{
+  uint64_t start;
+  uint32_t resTime;
+  uint16_t resBits;
+  bool     resp;
+
+  gRFAL.rxFrameBits = 0;
+  gRFAL.rxFrameCrc  = false;
+
+  /* Nothing to transmit: a reception only is not emulated */
+  if ((type != RFAL_HOST_FRAME_EOF) && (txBits == 0U)) {
+    return ERR_TIMEOUT;
+  }
+
+  /* Respect the GT and the FDT Poll since the last frame */
+  start = gRfalHostClock;
+  if (start < gRFAL.GTEnd) {
+    start = gRFAL.GTEnd;
+  }
+  if ((gRFAL.lastRxEnd != 0U) && (start < (gRFAL.lastRxEnd + gRFAL.FDTPoll))) {
+    start = (gRFAL.lastRxEnd + gRFAL.FDTPoll);
+  }
+  gRfalHostClock = start;
+
+  /* Transmission */
+  gRfalHostClock += rfalHostTxTime(type, txBits);
+  gRFAL.txEnd     = gRfalHostClock;
+
+  gRFAL.stats.frames++;
+  gRFAL.stats.txTime  += (gRFAL.txEnd - start);
+  gRFAL.stats.txBytes += (uint32_t)(rfalConvBitsToBytes(txBits) + ((type == RFAL_HOST_FRAME_STD) ? RFAL_CRC_LEN : 0U));
+
+  /* Tag processing */
+  resp    = false;
+  resBits = 0;
+  resTime = 0;
+  if (gRFAL.field && (gRFAL.tag != NULL) && (gRFAL.tag->getMode() == gRFAL.mode)) {
+    resp = gRFAL.tag->transceive(type, txBuf, rfalConvBitsToBytes(txBits), gRFAL.rxFrame, &resBits, &resTime);
+  }
+
+  if (resp && (resBits > 0U) && (resBits <= rfalConvBytesToBits(RFAL_HOST_FRAME_MAX_LEN)) && ((fwt == RFAL_FWT_NONE) || (resTime <= fwt))) {
+    /* Only standard frames made of full bytes carry a CRC */
+    gRFAL.rxFrameBits = resBits;
+    gRFAL.rxFrameCrc  = ((type == RFAL_HOST_FRAME_STD) || (type == RFAL_HOST_FRAME_EOF)) && ((resBits % RFAL_BITS_IN_BYTE) == 0U);
+
+    gRfalHostClock += resTime;
+    start           = gRfalHostClock;
+    gRfalHostClock += rfalHostRxTime(resBits, gRFAL.rxFrameCrc);
+
+    gRFAL.stats.responses++;
+    gRFAL.stats.rxTime  += (gRfalHostClock - start);
+    gRFAL.stats.rxBytes += (uint32_t)(rfalConvBitsToBytes(resBits) + (gRFAL.rxFrameCrc ? RFAL_CRC_LEN : 0U));
+    gRFAL.lastRxEnd      = gRfalHostClock;
+
+    return (((resBits % RFAL_BITS_IN_BYTE) != 0U) ? ERR_INCOMPLETE_BYTE : ERR_NONE);
+  }
+
+  /* No response within FWT */
+  if (fwt != RFAL_FWT_NONE) {
+    gRfalHostClock += fwt;
+  }
+  gRFAL.stats.timeouts++;
+  gRFAL.lastRxEnd = gRfalHostClock;
+
+  return ERR_TIMEOUT;
+}
+
+
+/*******************************************************************************/
+uint16_t RfalRfHostClass::rfalHostCopyRx(uint8_t *rxBuf, uint16_t rxBufLen, bool keepCrc, ReturnCode *ret)
+{
+  uint16_t len;
+  uint16_t cpyLen;
+  uint16_t bits;
+
+  len  = rfalConvBitsToBytes(gRFAL.rxFrameBits);
+  bits = gRFAL.rxFrameBits;
+
+  if (keepCrc && gRFAL.rxFrameCrc) {
+    rfalHostCalcCrc(gRFAL.rxFrame, len, &gRFAL.rxFrame[len]);
+    len  += RFAL_CRC_LEN;
+    bits += (uint16_t)rfalConvBytesToBits(RFAL_CRC_LEN);
+  }
+
+  cpyLen = MIN(len, rxBufLen);
+  if ((rxBuf != NULL) && (cpyLen > 0U)) {
+    ST_MEMCPY(rxBuf, gRFAL.rxFrame, cpyLen);
+  }
+
+  if (cpyLen < len) {
+    *ret = ERR_NOMEM;
+    bits = (uint16_t)rfalConvBytesToBits(cpyLen);
+  }
+
+  return bits;
+}
+
+
+/*******************************************************************************/
+uint32_t RfalRfHostClass::rfalHostTxTime(rfalHostFrameType type, uint16_t bits)
+{
+  uint32_t nBits;
+
+  nBits = (uint32_t)bits + ((type == RFAL_HOST_FRAME_STD) ? rfalConvBytesToBits(RFAL_CRC_LEN) : 0U);
+
+  switch (gRFAL.mode) {
+    case RFAL_MODE_POLL_NFCA:
+    case RFAL_MODE_POLL_NFCA_T1T:
+      /* Start bit, data with one parity bit per byte, end of communication */
+      return ((RFAL_HOST_NFCA_SOF_EOF_BITS + nBits + (nBits / RFAL_BITS_IN_BYTE)) * rfalHostBitTime(gRFAL.txBR));
+
+    case RFAL_MODE_POLL_NFCB:
+    case RFAL_MODE_POLL_B_PRIME:
+    case RFAL_MODE_POLL_B_CTS:
+      return ((RFAL_HOST_NFCB_SOF_EOF_BITS + ((nBits / RFAL_BITS_IN_BYTE) * RFAL_HOST_NFCB_BITS_PER_BYTE)) * rfalHostBitTime(gRFAL.txBR));
+
+    case RFAL_MODE_POLL_NFCF:
+      return ((RFAL_HOST_NFCF_PREAMBLE_BITS + RFAL_HOST_NFCF_SYNC_BITS + nBits) * rfalHostBitTime(gRFAL.txBR));
+
+    case RFAL_MODE_POLL_NFCV:
+    case RFAL_MODE_POLL_PICOPASS:
+      if (type == RFAL_HOST_FRAME_EOF) {
+        return RFAL_HOST_NFCV_VCD_EOF;
+      }
+      return (RFAL_HOST_NFCV_VCD_SOF + (nBits * rfalHostBitTime(gRFAL.txBR)) + RFAL_HOST_NFCV_VCD_EOF);
+
+    default:
+      return (nBits * rfalHostBitTime(gRFAL.txBR));
+  }
+}
+
+
+/*******************************************************************************/
+uint32_t RfalRfHostClass::rfalHostRxTime(uint16_t bits, bool crc)
+{
+  uint32_t nBits;
+
+  nBits = (uint32_t)bits + (crc ? rfalConvBytesToBits(RFAL_CRC_LEN) : 0U);
+
+  switch (gRFAL.mode) {
+    case RFAL_MODE_POLL_NFCA:
+    case RFAL_MODE_POLL_NFCA_T1T:
+      return ((RFAL_HOST_NFCA_SOF_EOF_BITS + nBits + (nBits / RFAL_BITS_IN_BYTE)) * rfalHostBitTime(gRFAL.rxBR));
+
+    case RFAL_MODE_POLL_NFCB:
+    case RFAL_MODE_POLL_B_PRIME:
+    case RFAL_MODE_POLL_B_CTS:
+      return ((RFAL_HOST_NFCB_SOF_EOF_BITS + ((nBits / RFAL_BITS_IN_BYTE) * RFAL_HOST_NFCB_BITS_PER_BYTE)) * rfalHostBitTime(gRFAL.rxBR));
+
+    case RFAL_MODE_POLL_NFCF:
+      return ((RFAL_HOST_NFCF_PREAMBLE_BITS + RFAL_HOST_NFCF_SYNC_BITS + nBits) * rfalHostBitTime(gRFAL.rxBR));
+
+    case RFAL_MODE_POLL_NFCV:
+    case RFAL_MODE_POLL_PICOPASS:
+      return ((RFAL_HOST_NFCV_VICC_SOF_EOF_BITS + nBits) * rfalHostBitTime(gRFAL.rxBR));
+
+    default:
+      return (nBits * rfalHostBitTime(gRFAL.rxBR));
+  }
+}
+
+
+/*******************************************************************************/
+void RfalRfHostClass::rfalHostCalcCrc(const uint8_t *buf, uint16_t len, uint8_t *crc)
+{
+  uint16_t i;
+  uint8_t  j;
+  uint16_t c;
+
+  if (gRFAL.mode == RFAL_MODE_POLL_NFCF) {
+    /* JIS X 6319-4: CRC-CCITT, MSB first, transmitted MSB first */
+    c = 0x0000U;
+    for (i = 0; i < len; i++) {
+      c ^= (uint16_t)((uint16_t)buf[i] << 8U);
+      for (j = 0; j < RFAL_BITS_IN_BYTE; j++) {
+        c = (uint16_t)(((c & 0x8000U) != 0U) ? ((c << 1U) ^ 0x1021U) : (c << 1U));
+      }
+    }
+    crc[0] = (uint8_t)(c >> 8U);
+    crc[1] = (uint8_t)(c & 0xFFU);
+    return;
+  }
+
+  /* ISO14443A: CRC_A preset 0x6363;  ISO14443B / ISO15693: preset 0xFFFF complemented */
+  c = (((gRFAL.mode == RFAL_MODE_POLL_NFCA) || (gRFAL.mode == RFAL_MODE_POLL_NFCA_T1T)) ? 0x6363U : 0xFFFFU);
+  for (i = 0; i < len; i++) {
+    c ^= buf[i];
+    for (j = 0; j < RFAL_BITS_IN_BYTE; j++) {
+      c = (uint16_t)(((c & 0x0001U) != 0U) ? ((c >> 1U) ^ 0x8408U) : (c >> 1U));
+    }
+  }
+  if ((gRFAL.mode != RFAL_MODE_POLL_NFCA) && (gRFAL.mode != RFAL_MODE_POLL_NFCA_T1T)) {
+    c = (uint16_t)~c;
+  }
+  crc[0] = (uint8_t)(c & 0xFFU);
+  crc[1] = (uint8_t)(c >> 8U);
+}
+
+
+/*******************************************************************************/
+static uint32_t rfalHostBitTime(rfalBitRate br)
+{
+  switch (br) {
+    case RFAL_BR_52p97:
+      return 256U;
+    case RFAL_BR_26p48:
+      return 512U;
+    case RFAL_BR_1p66:
+      return 8192U;
+    default:
+      if ((uint8_t)br <= (uint8_t)RFAL_BR_13560) {
+        return (128U >> (uint8_t)br);
+      }
+      return 128U;
+  }
+}
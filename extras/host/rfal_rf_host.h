@@ -0,0 +1,312 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT 2021 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MIX MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/mix_myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+/*! \file
+ *
+ *  \author SRA
+ *
+ *  \brief RFAL host RF front-end
+ *
+ *  This module provides a host implementation of RfalRfClass.
+ *  Instead of driving an ST25R device, every frame is handed to an in-memory
+ *  tag model (see rfal_host_tags.h) and its response is returned to the
+ *  upper layers as the HW would do.
+ *
+ *  All timing is virtual: the front-end keeps a deterministic clock in 1/fc
+ *  units which is charged on every exchange with the guard time, the frame
+ *  delay times, the tag processing time and the on-air time of the request
+ *  and of the response for the configured mode and rfalBitRate.
+ *  The same clock backs millis() and delay() of the host Arduino shim.
+ *
+ *  The number of frames, the bytes on air and the airtime are accumulated
+ *  and can be retrieved with rfalHostGetStats().
+ *
+ *  The exchange is performed synchronously within rfalStartTransceive(),
+ *  rfalGetTransceiveStatus() only reports its outcome.
+ *
+ *
+ * \addtogroup RFAL
+ * @{
+ *
+ * \addtogroup RFAL-HAL
+ * \brief RFAL Hardware Abstraction Layer
+ * @{
+ *
+ * \addtogroup Host
+ * \brief RFAL Host front-end
+ * @{
+ *
+ */
+
+
+#ifndef RFAL_RF_HOST_H
+#define RFAL_RF_HOST_H
+
+/*
+******************************************************************************
+* INCLUDES
+******************************************************************************
+*/
+#include "st_errno.h"
+#include "rfal_rf.h"
+
+/*
+******************************************************************************
+* GLOBAL DEFINES
+******************************************************************************
+*/
+
+#define RFAL_HOST_FRAME_MAX_LEN           2048U                      /*!< Maximum frame length exchanged with a tag model (bytes)          */
+#define RFAL_HOST_CPU_TICK                136U                       /*!< Virtual time charged on every millis() call (~10us) in 1/fc      */
+
+#define RFAL_HOST_FELICA_POLL_DELAY       32768U                     /*!< FeliCa Polling response delay: 2.417ms in 1/fc                   */
+#define RFAL_HOST_FELICA_POLL_SLOT        16384U                     /*!< FeliCa Polling time slot duration: 1.208ms in 1/fc               */
+#define RFAL_HOST_NFCV_FWT_ANTICOL        rfalConvUsTo1fc(500U)      /*!< Wait time for an INVENTORY_RES / EOF slot                        */
+#define RFAL_HOST_NFCV_FWT_EOF            rfalConvMsTo1fc(20U)       /*!< Wait time for a response after an EOF   Digital 2.0  B.5         */
+
+/*
+******************************************************************************
+* GLOBAL TYPES
+******************************************************************************
+*/
+
+/*! Type of frame sent by the front-end to a tag model */
+typedef enum {
+  RFAL_HOST_FRAME_STD       = 0,    /*!< Standard frame; CRC appended on air, not given to the tag        */
+  RFAL_HOST_FRAME_SHORT     = 1,    /*!< ISO14443A short frame (7 bits, REQA / WUPA)                      */
+  RFAL_HOST_FRAME_SDD       = 2,    /*!< ISO14443A anticollision frame (SDD_REQ, no CRC)                  */
+  RFAL_HOST_FRAME_EOF       = 3     /*!< ISO15693 EOF only (next slot / response to Option flag request)  */
+} rfalHostFrameType;
+
+
+/*! Counters accumulated by the front-end */
+typedef struct {
+  uint32_t frames;                  /*!< Frames transmitted by the poller                                 */
+  uint32_t responses;               /*!< Frames received from the listener                                */
+  uint32_t timeouts;                /*!< Frames left without response                                     */
+  uint32_t txBytes;                 /*!< Bytes transmitted on air (including CRC)                         */
+  uint32_t rxBytes;                 /*!< Bytes received on air (including CRC)                            */
+  uint64_t txTime;                  /*!< Poller modulation time in 1/fc                                   */
+  uint64_t rxTime;                  /*!< Listener modulation time in 1/fc                                 */
+} rfalHostStats;
+
+
+/*! Tag model to be placed in the field of the host front-end */
+class RfalHostTag {
+  public:
+    virtual ~RfalHostTag() {}
+
+    /*!
+     *****************************************************************************
+     * \brief  Get the technology of the tag
+     *
+     * \return the poller mode the tag answers to (e.g. RFAL_MODE_POLL_NFCA)
+     *****************************************************************************
+     */
+    virtual rfalMode getMode(void) = 0;
+
+    /*!
+     *****************************************************************************
+     * \brief  Power on
+     *
+     * Called when the field is switched on, the tag shall go to its power-on
+     * state (volatile state lost, memory kept)
+     *****************************************************************************
+     */
+    virtual void powerOn(void) = 0;
+
+    /*!
+     *****************************************************************************
+     * \brief  Process a frame
+     *
+     * \param[in]  type    : type of the frame
+     * \param[in]  req     : frame payload without CRC (NFC-F: starting with LEN)
+     * \param[in]  reqLen  : payload length in bytes
+     * \param[out] res     : response payload without CRC (RFAL_HOST_FRAME_MAX_LEN)
+     * \param[out] resBits : response length in bits
+     * \param[out] resTime : time between the end of the request and the start
+     *                       of the response in 1/fc
+     *
+     * \return true  : the tag responds
+     * \return false : the tag stays silent
+     *****************************************************************************
+     */
+    virtual bool transceive(rfalHostFrameType type, const uint8_t *req, uint16_t reqLen, uint8_t *res, uint16_t *resBits, uint32_t *resTime) = 0;
+};
+
+
+/*! Host front-end instance state */
+typedef struct {
+  rfalState             state;      /*!< Main state                                                       */
+  rfalMode              mode;       /*!< Current mode                                                     */
+  rfalBitRate           txBR;       /*!< Current Tx bit rate                                              */
+  rfalBitRate           rxBR;       /*!< Current Rx bit rate                                              */
+  rfalEHandling         eHandling;  /*!< Error handling                                                   */
+  bool                  field;      /*!< Field state                                                      */
+  uint32_t              GT;         /*!< Guard time in 1/fc                                               */
+  uint64_t              GTEnd;      /*!< Time at which the GT expires                                     */
+  uint32_t              FDTPoll;    /*!< FDT Poll in 1/fc                                                 */
+  uint32_t              FDTListen;  /*!< FDT Listen in 1/fc                                               */
+  uint64_t              txEnd;      /*!< Time at which the last transmission ended                        */
+  uint64_t              lastRxEnd;  /*!< Time at which the last exchange ended                            */
+  ReturnCode            txrxStatus; /*!< Outcome of the last transceive                                   */
+  rfalTransceiveContext txrxCtx;    /*!< Context of the transceive whose response is pending             */
+  bool                  rxPending;  /*!< Response received but not yet delivered to the caller's buffer   */
+  uint8_t               obsvTx;     /*!< Observation mode Tx                                              */
+  uint8_t               obsvRx;     /*!< Observation mode Rx                                              */
+  bool                  wumEnabled; /*!< Wake-Up mode enabled                                             */
+  uint32_t              wumPeriod;  /*!< Wake-Up mode measurement period in 1/fc                          */
+  rfalPreTxRxCallback   preTxRx;    /*!< Pre TxRx callback                                                */
+  rfalPostTxRxCallback  postTxRx;   /*!< Post TxRx callback                                               */
+  rfalUpperLayerCallback upperLayer;/*!< Upper layer callback                                             */
+  RfalHostTag          *tag;        /*!< Tag currently in the field                                       */
+  rfalHostStats         stats;      /*!< Accumulated counters                                             */
+  uint8_t               txFrame[RFAL_HOST_FRAME_MAX_LEN];                /*!< Frame sent to the tag       */
+  uint8_t               rxFrame[RFAL_HOST_FRAME_MAX_LEN + RFAL_CRC_LEN]; /*!< Frame received from the tag */
+  uint16_t              rxFrameBits;  /*!< Length of the received frame in bits (without CRC)                */
+  bool                  rxFrameCrc;   /*!< Received frame was protected by a CRC                             */
+} rfalHost;
+
+
+/*
+******************************************************************************
+* GLOBAL FUNCTION PROTOTYPES
+******************************************************************************
+*/
+
+/*! Returns the virtual time elapsed since start-up in 1/fc */
+uint64_t rfalHostGetTime(void);
+
+/*! Advances the virtual time by the given amount of 1/fc */
+void rfalHostAdvanceTime(uint64_t t);
+
+
+class RfalRfHostClass : public RfalRfClass {
+  public:
+    RfalRfHostClass(void);
+
+    /* RfalRfClass */
+    ReturnCode rfalInitialize(void);
+    ReturnCode rfalCalibrate(void);
+    ReturnCode rfalAdjustRegulators(uint16_t *result);
+    void rfalSetUpperLayerCallback(rfalUpperLayerCallback pFunc);
+    void rfalSetPreTxRxCallback(rfalPreTxRxCallback pFunc);
+    void rfalSetPostTxRxCallback(rfalPostTxRxCallback pFunc);
+    ReturnCode rfalDeinitialize(void);
+    ReturnCode rfalSetMode(rfalMode mode, rfalBitRate txBR, rfalBitRate rxBR);
+    rfalMode rfalGetMode(void);
+    ReturnCode rfalSetBitRate(rfalBitRate txBR, rfalBitRate rxBR);
+    ReturnCode rfalGetBitRate(rfalBitRate *txBR, rfalBitRate *rxBR);
+    void rfalSetErrorHandling(rfalEHandling eHandling);
+    rfalEHandling rfalGetErrorHandling(void);
+    void rfalSetObsvMode(uint8_t txMode, uint8_t rxMode);
+    void rfalGetObsvMode(uint8_t *txMode, uint8_t *rxMode);
+    void rfalDisableObsvMode(void);
+    void rfalSetFDTPoll(uint32_t FDTPoll);
+    uint32_t rfalGetFDTPoll(void);
+    void rfalSetFDTListen(uint32_t FDTListen);
+    uint32_t rfalGetFDTListen(void);
+    uint32_t rfalGetGT(void);
+    void rfalSetGT(uint32_t GT);
+    bool rfalIsGTExpired(void);
+    ReturnCode rfalFieldOnAndStartGT(void);
+    ReturnCode rfalFieldOff(void);
+    ReturnCode rfalStartTransceive(const rfalTransceiveContext *ctx);
+    rfalTransceiveState rfalGetTransceiveState(void);
+    ReturnCode rfalGetTransceiveStatus(void);
+    bool rfalIsTransceiveInTx(void);
+    bool rfalIsTransceiveInRx(void);
+    ReturnCode rfalGetTransceiveRSSI(uint16_t *rssi);
+    void rfalWorker(void);
+    ReturnCode rfalISO14443ATransceiveShortFrame(rfal14443AShortFrameCmd txCmd, uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *rxRcvdLen, uint32_t fwt);
+    ReturnCode rfalISO14443ATransceiveAnticollisionFrame(uint8_t *buf, uint8_t *bytesToSend, uint8_t *bitsToSend, uint16_t *rxLength, uint32_t fwt);
+    ReturnCode rfalFeliCaPoll(rfalFeliCaPollSlots slots, uint16_t sysCode, uint8_t reqCode, rfalFeliCaPollRes *pollResList, uint8_t pollResListSize, uint8_t *devicesDetected, uint8_t *collisionsDetected);
+    ReturnCode rfalISO15693TransceiveAnticollisionFrame(uint8_t *txBuf, uint8_t txBufLen, uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen);
+    ReturnCode rfalISO15693TransceiveEOFAnticollision(uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen);
+    ReturnCode rfalISO15693TransceiveEOF(uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen);
+    ReturnCode rfalTransceiveBlockingTx(uint8_t *txBuf, uint16_t txBufLen, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *actLen, uint32_t flags, uint32_t fwt);
+    ReturnCode rfalTransceiveBlockingRx(void);
+    ReturnCode rfalTransceiveBlockingTxRx(uint8_t *txBuf, uint16_t txBufLen, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *actLen, uint32_t flags, uint32_t fwt);
+    bool rfalIsExtFieldOn(void);
+    ReturnCode rfalListenStart(uint32_t lmMask, const rfalLmConfPA *confA, const rfalLmConfPB *confB, const rfalLmConfPF *confF, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rxLen);
+    ReturnCode rfalListenSleepStart(rfalLmState sleepSt, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rxLen);
+    ReturnCode rfalListenStop(void);
+    rfalLmState rfalListenGetState(bool *dataFlag, rfalBitRate *lastBR);
+    ReturnCode rfalListenSetState(rfalLmState newSt);
+    ReturnCode rfalWakeUpModeStart(const rfalWakeUpConfig *config);
+    bool rfalWakeUpModeHasWoke(void);
+    ReturnCode rfalWakeUpModeStop(void);
+
+
+    /*!
+     *****************************************************************************
+     * \brief  Place a tag in the field
+     *
+     * \param[in]  tag : tag model to be placed in the field, NULL removes it
+     *****************************************************************************
+     */
+    void rfalHostSetTag(RfalHostTag *tag);
+
+    /*!
+     *****************************************************************************
+     * \brief  Get the tag currently in the field
+     *
+     * \return the tag model in the field, NULL if none
+     *****************************************************************************
+     */
+    RfalHostTag *rfalHostGetTag(void);
+
+    /*!
+     *****************************************************************************
+     * \brief  Get the accumulated counters
+     *
+     * \param[out] stats : counters accumulated since the last rfalHostClearStats()
+     *****************************************************************************
+     */
+    void rfalHostGetStats(rfalHostStats *stats);
+
+    /*!
+     *****************************************************************************
+     * \brief  Clear the accumulated counters
+     *****************************************************************************
+     */
+    void rfalHostClearStats(void);
+
+  private:
+    ReturnCode rfalHostExchange(rfalHostFrameType type, const uint8_t *txBuf, uint16_t txBits, uint32_t fwt);
+    uint16_t rfalHostCopyRx(uint8_t *rxBuf, uint16_t rxBufLen, bool keepCrc, ReturnCode *ret);
+    void rfalHostCompleteTransceive(void);
+    uint32_t rfalHostTxTime(rfalHostFrameType type, uint16_t bits);
+    uint32_t rfalHostRxTime(uint16_t bits, bool crc);
+    void rfalHostCalcCrc(const uint8_t *buf, uint16_t len, uint8_t *crc);
+
+    rfalHost gRFAL;
+};
+
+#endif /* RFAL_RF_HOST_H */
+
+/**
+  * @}
+  *
+  * @}
+  *
+  * @}
+  */
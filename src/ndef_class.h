@@ -182,10 +182,19 @@ class NdefClass {
       messageLen = 0;
       messageOffset = 0;
       areaLen = 0;
+      differentialWrite = false;
+      t2tIdentify = true;
+      writeBuf = NULL;
+      writeBufLen = 0;
+      writeChunkLen = 0;
+      memset(&payloadItemCursor, 0, sizeof(ndefPayloadItemCursor));
+      ndefUidCacheInit(&t2tProfileCache, t2tProfiles, sizeof(ndefT2TProfileEntry), NDEF_T2T_PROFILE_CACHE_LEN);
+      ndefUidCacheInit(&t3tAibCache, t3tAibs, sizeof(ndefT3TAibCacheEntry), NDEF_T3T_AIB_CACHE_LEN);
+      ndefUidCacheInit(&t5tSysInfoCache, t5tSysInfos, sizeof(ndefT5TSysInfoCacheEntry), NDEF_T5T_SYSINFO_CACHE_LEN);
       memset(ccBuf, 0, ((sizeof(uint8_t)) * NDEF_CC_BUF_LEN));
       memset(&subCtx.t1t, 0, sizeof(ndefT1TContext));
-      ndefRecordPoolIndex = 0;
       memset(ndefRecordPool, 0, (sizeof(ndefRecord) * NDEF_MAX_RECORD));
+      ndefRecordArenaInit(&ndefRecordPoolArena, ndefRecordPool, NDEF_MAX_RECORD);
     }
 
     /*
@@ -295,6 +304,35 @@ class NdefClass {
     ReturnCode ndefPollerReadRawMessage(uint8_t *buf, uint32_t bufLen, uint32_t *rcvdLen);
 
 
+    /*!
+     *****************************************************************************
+     * \brief Read the next NDEF record
+     *
+     * This method reads the NDEF message incrementally: only the bytes needed
+     * for the next record are read from the tag (at least NDEF_READ_RECORD_LEN),
+     * into the decoder buffer. The caller may stop as soon as the record it
+     * looks for has been returned, the rest of the message is not read.
+     * The chunks of a chunked record are returned one by one: calling
+     * ndefMessageDecoderCompact() once a chunk is consumed, the decoder buffer
+     * only has to hold one chunk.
+     * Prior to NDEF Read procedure, a successful ndefPollerNdefDetect()
+     * has to be performed, and the decoder initialized with ndefMessageDecoderInit().
+     *
+     * \param[in,out] dec    : decoder of the message being read
+     * \param[out]    record : next record, pointing into the decoder buffer
+     *
+     * \return ERR_DONE         : all the records of the message have been read
+     * \return ERR_NOMEM        : decoder buffer too short for the next record
+     * \return ERR_WRONG_STATE  : RFAL not initialized or mode not set
+     * \return ERR_REQUEST      : read failed
+     * \return ERR_PARAM        : Invalid parameter
+     * \return ERR_PROTO        : Protocol error
+     * \return ERR_NONE         : No error
+     *****************************************************************************
+     */
+    ReturnCode ndefPollerReadRecord(ndefMessageDecoder *dec, ndefRecord *record);
+
+
     /*!
      *****************************************************************************
      * \brief Write raw NDEF message
@@ -437,6 +475,81 @@ class NdefClass {
     ReturnCode ndefPollerEndWriteMessage(uint32_t messageLen);
 
 
+    /*!
+     *****************************************************************************
+     * \brief Set Differential Write mode
+     *
+     * When enabled, the write methods compare the data to be written with the
+     * current tag content (taken from the read cache or read beforehand) and
+     * skip the blocks that already hold it (T2T, T5T). The current content is
+     * read a window at a time (T2T FAST_READ, T5T Read Multiple Blocks) and the
+     * changed blocks are still written in batches where the tag supports it.
+     * The L-field is still reset before and updated after the message data.
+     * Disabled by default.
+     *
+     * \param[in]   enable: true to enable, false to disable
+     *
+     *****************************************************************************
+     */
+    void ndefPollerSetDifferentialWrite(bool enable);
+
+
+    /*!
+     *****************************************************************************
+     * \brief Set T2T model identification
+     *
+     * When enabled, the T2T context initialization sends GET_VERSION to the
+     * tags not seen before and picks the read strategy (memory size, FAST_READ,
+     * pages per read) from the model profile. The answer, or the lack of one
+     * after NDEF_T2T_IDENTIFY_MAX_TRIES probes, is remembered per UID so that
+     * a tag is not probed again on each tap. When disabled, no command is sent
+     * at initialization: the area is sized from the CC and FAST_READ support
+     * is probed by the first bulk read.
+     * Enabled by default.
+     *
+     * \param[in]   enable: true to enable, false to disable
+     *
+     *****************************************************************************
+     */
+    void ndefPollerSetT2TIdentify(bool enable);
+
+
+    /*!
+     *****************************************************************************
+     * \brief Set the Write Message buffer
+     *
+     * When set, ndefPollerWriteMessage() serializes the records into this
+     * buffer instead of writing each record header, type, ID and payload item
+     * on its own: a message fitting in the buffer is written with a single
+     * write, a longer one is streamed in buffer-sized chunks ending on block
+     * boundaries (T2T, T3T, T5T) or on MLc multiples (T4T).
+     * The buffer must be kept until it is unset. Not set by default.
+     *
+     * \param[in]   buf    : buffer, NULL to write the records item by item
+     * \param[in]   bufLen : buffer length
+     *
+     *****************************************************************************
+     */
+    void ndefPollerSetWriteBuffer(uint8_t *buf, uint32_t bufLen);
+
+
+    /*!
+     *****************************************************************************
+     * \brief Set the chunk length of the written records
+     *
+     * When set, ndefPollerWriteMessage() writes the records whose payload is
+     * longer than chunkLen as chunked records (CF flag), as
+     * ndefMessageEncodeChunked() encodes them. The chunks are written as they
+     * are built, the record is never held in memory as a whole.
+     * Not set by default.
+     *
+     * \param[in]   chunkLen : maximum payload length of a chunk, 0 not to chunk
+     *
+     *****************************************************************************
+     */
+    void ndefPollerSetChunkLength(uint32_t chunkLen);
+
+
     /*
     ******************************************************************************
     * NDEF T2T POLLER FUNCTION PROTOTYPES
@@ -452,6 +565,8 @@ class NdefClass {
      * the activation of the ISO-DEP layer. It must be called after a successful
      * anti-collision procedure and prior to any NDEF procedures such as NDEF
      * detection procedure.
+     * The tag model is identified with GET_VERSION the first time a UID is
+     * seen, its profile (memory size, FAST_READ support) sets the read strategy.
      *
      * \param[in]   dev    : ndef Device
      *
@@ -650,6 +765,8 @@ class NdefClass {
      * \brief T2T Begin Write Message
      *
      * This method sets the L-field to 0 and sets the message offset to the proper value according to messageLen
+     * Until ndefT2TPollerEndWriteMessage(), ndefT2TPollerWriteBytes() keeps partially written
+     * blocks in RAM so that each block is written once.
      *
      * \param[in]   messageLen: message length
      *
@@ -665,7 +782,7 @@ class NdefClass {
      *****************************************************************************
      * \brief T2T End Write Message
      *
-     * This method updates the L-field value after the message has been written
+     * This method writes the pending message blocks and then updates the L-field value
      *
      * \param[in]   messageLen: message length
      *
@@ -677,6 +794,20 @@ class NdefClass {
     ReturnCode ndefT2TPollerEndWriteMessage(uint32_t messageLen);
 
 
+    /*!
+     *****************************************************************************
+     * \brief T2T Invalidate read cache
+     *
+     * This method drops the READ responses kept by the T2T read cache.
+     * Writes done through this class keep the cache up to date; it must be
+     * called when the tag memory may have been changed by other means
+     * (e.g. direct RFAL commands or another reader).
+     *
+     *****************************************************************************
+     */
+    void ndefT2TPollerInvalidateCache();
+
+
     /*
     ******************************************************************************
     * NDEF T3T POLLER FUNCTION PROTOTYPES
@@ -708,6 +839,8 @@ class NdefClass {
      * \brief T3T NDEF Detection procedure
      *
      * This method performs the T3T NDEF Detection procedure
+     * The Attribute Information Block of one of the last NDEF_T3T_AIB_CACHE_LEN tags
+     * is not read again: its cached copy is used and checked by the next data CHECK
      *
      * \param[out]  info   : ndef Information (optional parameter, NULL may be used when no NDEF Information is needed)
      *
@@ -1009,7 +1142,7 @@ class NdefClass {
      * ReadBinary command
      *
      * \param[in]   offset : file offset of where to star reading data; valid range 0000h-7FFFh
-     * \param[in]   len    : requested len (short field coding)
+     * \param[in]   len    : requested len (extended field coding above 256)
      *
      * \return ERR_WRONG_STATE  : RFAL not initialized or mode not set
      * \return ERR_REQUEST      : read failed (SW1SW2 <> 9000h)
@@ -1018,7 +1151,7 @@ class NdefClass {
      * \return ERR_NONE         : No error
      *****************************************************************************
      */
-    ReturnCode ndefT4TPollerReadBinary(uint16_t offset, uint8_t len);
+    ReturnCode ndefT4TPollerReadBinary(uint16_t offset, uint16_t len);
 
 
     /*!
@@ -1029,7 +1162,7 @@ class NdefClass {
      * ReadBinary ODO command
      *
      * \param[in]   offset : file offset of where to star reading data; valid range 0000h-7FFFh
-     * \param[in]   len    : requested len (short field coding)
+     * \param[in]   len    : requested len (extended field coding above 256)
      *
      * \return ERR_WRONG_STATE  : RFAL not initialized or mode not set
      * \return ERR_REQUEST      : read failed (SW1SW2 <> 9000h)
@@ -1038,7 +1171,7 @@ class NdefClass {
      * \return ERR_NONE         : No error
      *****************************************************************************
      */
-    ReturnCode ndefT4TPollerReadBinaryODO(uint32_t offset, uint8_t len);
+    ReturnCode ndefT4TPollerReadBinaryODO(uint32_t offset, uint16_t len);
 
 
     /*!
@@ -1079,7 +1212,7 @@ class NdefClass {
      * \return ERR_NONE         : No error
      *****************************************************************************
      */
-    ReturnCode ndefT4TPollerWriteBinary(uint16_t offset, const uint8_t *data, uint8_t len);
+    ReturnCode ndefT4TPollerWriteBinary(uint16_t offset, const uint8_t *data, uint16_t len);
 
 
     /*!
@@ -1100,7 +1233,7 @@ class NdefClass {
      * \return ERR_NONE         : No error
      *****************************************************************************
      */
-    ReturnCode ndefT4TPollerWriteBinaryODO(uint32_t offset, const uint8_t *data, uint8_t len);
+    ReturnCode ndefT4TPollerWriteBinaryODO(uint32_t offset, const uint8_t *data, uint16_t len);
 
     /*!
      *****************************************************************************
@@ -1293,6 +1426,9 @@ class NdefClass {
      * It must be called after a successful
      * anticollition procedure and prior to any NDEF procedures such as NDEF
      * detection procedure.
+     * The System Information of one of the last NDEF_T5T_SYSINFO_CACHE_LEN tags
+     * is not queried again unless the block 0 read shows a different block length
+     * or addressing mode
      *
      * \param[in]   dev    : ndef Device
      *
@@ -1593,6 +1729,157 @@ class NdefClass {
     ReturnCode ndefMessageDecode(const ndefConstBuffer *bufPayload, ndefMessage *message);
 
 
+    /*!
+     *****************************************************************************
+     * Decode a raw buffer to an NDEF message using a record arena
+     *
+     * Same as ndefMessageDecode() but the records are taken from the given
+     * arena instead of the internal pool (NDEF_MAX_RECORD records), so that
+     * several messages can be decoded and kept side by side.
+     * The records point into bufPayload, which must be kept as long as the
+     * message is used. On error the records taken are given back to the arena.
+     *
+     * \param[in]     bufPayload: Payload buffer to convert into message
+     * \param[out]    message:    Message created from the raw buffer
+     * \param[in,out] arena:      Arena the records are allocated from
+     *
+     * \return ERR_NOMEM if the arena is exhausted
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefMessageDecodeArena(const ndefConstBuffer *bufPayload, ndefMessage *message, ndefRecordArena *arena);
+
+
+    /*!
+     *****************************************************************************
+     * Initialize an incremental message decoder
+     *
+     * The message is received in chunks with ndefMessageDecoderPush() and its
+     * records are returned by ndefMessageDecoderGetRecord() as soon as they are
+     * complete. The records point into the buffer, which must be large
+     * enough for the part of the message received since the last
+     * ndefMessageDecoderCompact().
+     *
+     * \param[out] dec:    Decoder to initialize
+     * \param[in]  buf:    Buffer receiving the message
+     * \param[in]  bufLen: Buffer length
+     *
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefMessageDecoderInit(ndefMessageDecoder *dec, uint8_t *buf, uint32_t bufLen);
+
+
+    /*!
+     *****************************************************************************
+     * Push a chunk of message to an incremental decoder
+     *
+     * The chunk is appended to the decoder buffer. Data already received in
+     * place, i.e. at dec->buffer + dec->fill, is not copied.
+     *
+     * \param[in,out] dec
+     * \param[in]     data: Chunk of message
+     * \param[in]     len:  Chunk length
+     *
+     * \return ERR_NOMEM if the decoder buffer is full
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefMessageDecoderPush(ndefMessageDecoder *dec, const uint8_t *data, uint32_t len);
+
+
+    /*!
+     *****************************************************************************
+     * Get the next record from an incremental decoder
+     *
+     * \param[in,out] dec
+     * \param[out]    record: Next record, pointing into the decoder buffer
+     * \param[out]    needed: if not NULL, number of bytes to push for the
+     *                        record to be complete (on ERR_AGAIN), when known
+     *                        from the record header, 1 otherwise
+     *
+     * \return ERR_AGAIN if the record is not complete yet, more bytes are to be pushed
+     * \return ERR_DONE if the Message End record has already been returned
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefMessageDecoderGetRecord(ndefMessageDecoder *dec, ndefRecord *record, uint32_t *needed);
+
+
+    /*!
+     *****************************************************************************
+     * Drop the records already returned by an incremental decoder
+     *
+     * The bytes not decoded yet are moved to the beginning of the buffer, so
+     * that a message, e.g. a chunked record, longer than the buffer can be
+     * received record by record. The records previously returned are no
+     * longer valid.
+     *
+     * \param[in,out] dec
+     *
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefMessageDecoderCompact(ndefMessageDecoder *dec);
+
+
+    /*!
+     *****************************************************************************
+     * Initialize a record arena
+     *
+     * \param[out] arena:   Arena to initialize
+     * \param[in]  records: Caller-supplied record storage
+     * \param[in]  length:  Number of records in the storage
+     *
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefRecordArenaInit(ndefRecordArena *arena, ndefRecord *records, uint32_t length);
+
+
+    /*!
+     *****************************************************************************
+     * Allocate a record from an arena
+     *
+     * \param[in,out] arena
+     *
+     * \return the record, or NULL if the arena is exhausted
+     *****************************************************************************
+     */
+    ndefRecord *ndefRecordArenaAlloc(ndefRecordArena *arena);
+
+
+    /*!
+     *****************************************************************************
+     * Get the current position of an arena
+     *
+     * The mark is to be given to ndefRecordArenaRelease() to free all the
+     * records allocated after it, e.g. the records of a message no longer used.
+     *
+     * \param[in] arena
+     *
+     * \return the arena mark
+     *****************************************************************************
+     */
+    uint32_t ndefRecordArenaMark(const ndefRecordArena *arena);
+
+
+    /*!
+     *****************************************************************************
+     * Release the records of an arena allocated after a mark
+     *
+     * Messages holding the records released must no longer be used.
+     * A mark of 0 resets the whole arena.
+     *
+     * \param[in,out] arena
+     * \param[in]     mark: as returned by ndefRecordArenaMark()
+     *
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefRecordArenaRelease(ndefRecordArena *arena, uint32_t mark);
+
+
     /*!
      *****************************************************************************
      * Encode an NDEF message to a raw buffer
@@ -1614,6 +1901,40 @@ class NdefClass {
     ReturnCode ndefMessageEncode(const ndefMessage *message, ndefBuffer *bufPayload);
 
 
+    /*!
+     *****************************************************************************
+     * Encode an NDEF message to a raw buffer, its long records chunked
+     *
+     * Same as ndefMessageEncode(), but the records whose payload is longer
+     * than chunkLen are encoded as chunked records, see ndefRecordEncodeChunked().
+     *
+     * \param[in]     message:    Message to convert
+     * \param[in]     chunkLen:   Maximum payload length of a chunk
+     * \param[in,out] bufPayload: Output buffer to store the converted message
+     *                            In case the buffer provided is too short, it is
+     *                            updated with the required buffer length.
+     *                            On success, it is updated with the actual buffer
+     *                            length used to contain the converted message.
+     *
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefMessageEncodeChunked(const ndefMessage *message, uint32_t chunkLen, ndefBuffer *bufPayload);
+
+
+    /*!
+     *****************************************************************************
+     * Get the length of an NDEF message, its long records chunked
+     *
+     * \param[in] message:  Message
+     * \param[in] chunkLen: Maximum payload length of a chunk, 0 for no chunking
+     *
+     * \return length in bytes of the encoded message
+     *****************************************************************************
+     */
+    uint32_t ndefMessageGetChunkedLength(const ndefMessage *message, uint32_t chunkLen);
+
+
     /*
     ******************************************************************************
     * NDEF RECORD FUNCTION PROTOTYPES
@@ -1846,6 +2167,76 @@ class NdefClass {
     ReturnCode ndefRecordEncode(const ndefRecord *record, ndefBuffer *bufRecord);
 
 
+    /*!
+     *****************************************************************************
+     * Encode an NDEF record to a raw buffer, as a chunked record
+     *
+     * The payload is split into chunks of at most chunkLen bytes: an initial
+     * chunk carrying the type and Id, then middle and terminating chunks with
+     * the unchanged type. A payload not longer than chunkLen is encoded as with
+     * ndefRecordEncode(). The payload items are copied straight into the chunks.
+     * To write a record longer than the buffers available, the chunks are
+     * written to the tag as they are built with ndefPollerSetChunkLength().
+     *
+     * \param[in]     record:    Record to convert
+     * \param[in]     chunkLen:  Maximum payload length of a chunk
+     * \param[in,out] bufRecord: Output buffer to store the chunks
+     *                           In case the buffer provided is too short, it is
+     *                           updated with the required buffer length.
+     *                           On success, it is updated with the actual buffer
+     *                           length used to contain the chunks.
+     *
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefRecordEncodeChunked(const ndefRecord *record, uint32_t chunkLen, ndefBuffer *bufRecord);
+
+
+    /*!
+     *****************************************************************************
+     * Get the length of an NDEF record encoded as a chunked record
+     *
+     * \param[in] record:   Record
+     * \param[in] chunkLen: Maximum payload length of a chunk, 0 for no chunking
+     *
+     * \return length in bytes of all the chunks
+     *****************************************************************************
+     */
+    uint32_t ndefRecordGetChunkedLength(const ndefRecord *record, uint32_t chunkLen);
+
+
+    /*!
+     *****************************************************************************
+     * Get the payload length of a chunked record
+     *
+     * The chunks of a decoded message are consecutive records, the initial
+     * one having the CF bit set. The payload lengths are summed up to the
+     * terminating chunk. For a record not chunked, the payload length is returned.
+     *
+     * \param[in] record: Initial chunk
+     *
+     * \return payload length in bytes
+     *****************************************************************************
+     */
+    uint32_t ndefRecordGetChunkedPayloadLength(const ndefRecord *record);
+
+
+    /*!
+     *****************************************************************************
+     * Reassemble the payload of a chunked record
+     *
+     * \param[in]     record:     Initial chunk
+     * \param[in,out] bufPayload: Output buffer to store the payload
+     *                            In case the buffer provided is too short, it is
+     *                            updated with the required buffer length.
+     *                            On success, it is updated with the payload length.
+     *
+     * \return ERR_NONE if successful or a standard error code
+     *****************************************************************************
+     */
+    ReturnCode ndefRecordGetChunkedPayload(const ndefRecord *record, ndefBuffer *bufPayload);
+
+
     /*!
      *****************************************************************************
      * Get NDEF record payload length
@@ -1877,6 +2268,26 @@ class NdefClass {
     const uint8_t *ndefRecordGetPayloadItem(const ndefRecord *record, ndefConstBuffer *bufPayloadItem, bool begin);
 
 
+    /*!
+     *****************************************************************************
+     * Return a payload elementary item, iterator state kept by the caller
+     *
+     * Same as above, but the iteration state lives in the cursor provided,
+     * so that several records can be encoded at the same time, e.g. from
+     * different contexts. A returned item may point into the cursor and is
+     * only valid until the next call with the same cursor.
+     *
+     * \param[in]     record:         Record
+     * \param[out]    bufPayloadItem: The payload item returned
+     * \param[in,out] cursor:         Iterator state, initialized when begin is true
+     * \param[in]     begin:          Tell to return the first payload item or the next one
+     *
+     * \return the payload item buffer, NULL when there is no more item
+     *****************************************************************************
+     */
+    const uint8_t *ndefRecordGetPayloadItem(const ndefRecord *record, ndefConstBuffer *bufPayloadItem, ndefPayloadItemCursor *cursor, bool begin);
+
+
     /*
     ******************************************************************************
     * NDEF WIFI RECORD FUNCTION PROTOTYPES
@@ -2425,6 +2836,18 @@ class NdefClass {
     uint32_t                     messageLen;                   /*!< NDEF message len                                   */
     uint32_t                     messageOffset;                /*!< NDEF message offset                                */
     uint32_t                     areaLen;                      /*!< Area Len for NDEF storage                          */
+    bool                         differentialWrite;            /*!< Skip blocks already holding the data to be written */
+    bool                         t2tIdentify;                  /*!< Probe the T2T model with GET_VERSION               */
+    uint8_t                     *writeBuf;                     /*!< Write Message buffer, NULL if not set              */
+    uint32_t                     writeBufLen;                  /*!< Write Message buffer length                        */
+    uint32_t                     writeChunkLen;                /*!< Chunk length of the written records, 0 not to chunk */
+    ndefPayloadItemCursor        payloadItemCursor;            /*!< Cursor of ndefRecordGetPayloadItem() without one   */
+    ndefT2TProfileEntry          t2tProfiles[NDEF_T2T_PROFILE_CACHE_LEN]; /*!< T2T model profiles of the last tags   */
+    ndefUidCache                 t2tProfileCache;              /*!< T2T model profile cache, over t2tProfiles          */
+    ndefT3TAibCacheEntry         t3tAibs[NDEF_T3T_AIB_CACHE_LEN]; /*!< T3T AIBs of the last tags                     */
+    ndefUidCache                 t3tAibCache;                  /*!< T3T AIB cache, over t3tAibs                        */
+    ndefT5TSysInfoCacheEntry     t5tSysInfos[NDEF_T5T_SYSINFO_CACHE_LEN]; /*!< T5T System Information of the last tags */
+    ndefUidCache                 t5tSysInfoCache;              /*!< T5T System Information cache, over t5tSysInfos     */
     uint8_t                      ccBuf[NDEF_CC_BUF_LEN];       /*!< buffer for CC                                      */
     union {
       ndefT1TContext t1t;                                    /*!< T1T context                                        */
@@ -2439,21 +2862,71 @@ class NdefClass {
 
     ndefDeviceType ndefPollerGetDeviceType(rfalNfcDevice *dev);
     ReturnCode ndefT2TPollerReadBlock(uint16_t blockAddr, uint8_t *buf);
+    ReturnCode ndefT2TPollerFastReadBlocks(uint16_t blockAddr, uint16_t nbBlocks, uint8_t *buf);
+    void ndefT2TSetFastRead(uint8_t fastRead);
+    ReturnCode ndefT2TPollerSelectSector(uint8_t secNo);
+    ReturnCode ndefT2TPollerReactivate();
+    ReturnCode ndefT2TPollerIdentify();
+    const ndefT2TProfile *ndefT2TFindProfile(const rfalT2TVersion *version);
+    ReturnCode ndefT2TPollerReadRange(uint32_t offset, uint32_t len, uint8_t *buf);
     ReturnCode ndefT2TPollerWriteBlock(uint16_t blockAddr, const uint8_t *buf);
+    const uint8_t *ndefT2TCacheLookup(uint32_t offset, uint8_t *avail);
+    ReturnCode ndefT2TCacheFill(uint16_t blockAddr);
+    ReturnCode ndefT2TCacheFillWindows(uint16_t blockAddr, uint8_t nbWindows);
+    void ndefT2TCachePrefetch(uint32_t offset, uint8_t nbWindows);
+    uint32_t ndefT2TFastReadBlocksCount(uint32_t offset, uint32_t len);
+    ReturnCode ndefT2TWriteBackFlushBlock(ndefT2TWriteBackBlock *wb);
+    ReturnCode ndefT2TWriteBackFlush();
+    void ndefT2TCacheUpdate(uint16_t blockAddr, const uint8_t *buf);
+    ReturnCode ndefT2TPollerAddCtrlArea(ndefTlvScanner *scan, const ndefTlv *tlv);
+    ReturnCode ndefT3TPollerSetBlockList(rfalNfcfServBlockListParam *servBlock, rfalNfcfServ *serviceCode, uint16_t blockNum, uint8_t nbBlocks);
     ReturnCode ndefT3TPollerReadBlocks(uint16_t blockNum, uint8_t nbBlocks, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen);
+    ReturnCode ndefT3TPollerReadBlocksInPlace(uint16_t blockNum, uint8_t nbBlocks, uint8_t *buf, uint16_t bufLen, uint16_t *rcvLen);
     ReturnCode ndefT3TPollerReadAttributeInformationBlock();
+    ReturnCode ndefT3TPollerParseAttributeInformationBlock(const uint8_t *aib);
+    ReturnCode ndefT3TPollerApplyAttributeInformationBlock();
+    ReturnCode ndefT3TPollerConfirmAttributeInformationBlock(uint32_t dataLen, uint32_t *headLen);
+    const uint8_t *ndefT3TAibCacheFind();
+    void ndefT3TAibCacheStore(const uint8_t *aib);
+    void ndefT3TAibCacheRemove();
     ReturnCode ndefT3TPollerWriteBlocks(uint16_t blockNum, uint8_t nbBlocks, const uint8_t *dataBlocks);
     ReturnCode ndefT3TPollerWriteAttributeInformationBlock();
     void ndefT4TInitializeIsoDepTxRxParam(rfalIsoDepApduTxRxParam *isoDepAPDU);
     ReturnCode ndefT4TTransceiveTxRx(rfalIsoDepApduTxRxParam *isoDepAPDU);
+    ReturnCode ndefT4TTransceiveTxRxInto(rfalIsoDepApduTxRxParam *isoDepAPDU, uint8_t *rxDst, uint16_t rxDstLen);
+    ReturnCode ndefT4TPollerReadBinaryInto(uint16_t offset, uint16_t len, uint8_t *buf, uint16_t bufLen);
     ReturnCode ndefT4TReadAndParseCCFile();
+    void ndefT4TApplyMLeMLc();
     ReturnCode ndefT5TPollerReadSingleBlock(uint16_t blockNum, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen);
     ReturnCode ndefT5TGetSystemInformation(bool extended);
+    bool ndefT5TSysInfoIsRejected(ReturnCode ret);
+    const ndefT5TSysInfoCacheEntry *ndefT5TSysInfoCacheFind();
+    void ndefT5TSysInfoCacheStore();
     ReturnCode ndefT5TWriteCC();
     ReturnCode ndefT5TPollerWriteSingleBlock(uint16_t blockNum, const uint8_t *wrData);
+    uint16_t ndefT5TPollerWriteMultipleMaxBlocks(uint16_t blockNum, uint16_t nbBlocks);
+    ReturnCode ndefT5TPollerWriteMultipleBlocks(uint16_t firstBlockNum, uint16_t numOfBlocks, const uint8_t *wrData);
+    void ndefT5TPollerWaitWriteCompletion();
+    ReturnCode ndefT5TPollerWriteBlocks(uint16_t blockNum, uint16_t nbBlocks, const uint8_t *wrData);
+    ReturnCode ndefT5TPollerWriteChangedBlocks(uint16_t blockNum, uint16_t nbBlocks, const uint8_t *wrData);
     ReturnCode ndefT5TPollerReadMultipleBlocks(uint16_t firstBlockNum, uint8_t numOfBlocks, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen);
-    ndefRecord *ndefAllocRecord(void);
+    uint16_t ndefT5TPollerReadMultipleMaxBlocks();
+    void ndefTlvScanInit(ndefTlvScanner *scan, uint32_t offset, uint32_t end, uint8_t unit, uint8_t readLen);
+    void ndefTlvScanSeed(ndefTlvScanner *scan, uint32_t offset, const uint8_t *data, uint32_t len);
+    ReturnCode ndefTlvScanAddReserved(ndefTlvScanner *scan, uint32_t offset, uint32_t len);
+    uint32_t ndefTlvScanNextReserved(const ndefTlvScanner *scan, uint32_t offset);
+    ReturnCode ndefTlvScanRead(ndefTlvScanner *scan, uint32_t *offset, uint8_t *buf, uint32_t len);
+    ReturnCode ndefTlvScanNext(ndefTlvScanner *scan, ndefTlv *tlv);
+    uint32_t ndefTlvScanSkip(const ndefTlvScanner *scan, uint32_t offset, uint32_t len);
+    void ndefUidCacheInit(ndefUidCache *cache, void *entries, uint16_t entrySize, uint8_t nbEntries);
+    void *ndefUidCacheFind(ndefUidCache *cache, const uint8_t *uid, uint8_t uidLen);
+    void *ndefUidCacheStore(ndefUidCache *cache, const uint8_t *uid, uint8_t uidLen);
+    void ndefUidCacheRemove(ndefUidCache *cache, const uint8_t *uid, uint8_t uidLen);
+    ReturnCode ndefPollerWriteMessageItem(uint32_t *offset, uint32_t *staged, const uint8_t *data, uint32_t len);
+    ReturnCode ndefPollerWriteMessageFlush(uint32_t *offset, uint32_t *staged, bool all);
     ReturnCode ndefRecordPayloadEncode(const ndefRecord *record, ndefBuffer *bufPayload);
+    void ndefRecordChunkHeader(const ndefRecord *record, uint32_t payloadOffset, uint32_t chunkLen, ndefRecord *chunk);
+    ReturnCode ndefRecordCheckChunk(const ndefRecord *record, bool *chunked);
     ReturnCode ndefPayloadToWifi(const ndefConstBuffer *bufPayload, ndefType *wifi);
     ReturnCode ndefVCardFindMarker(const ndefConstBuffer *bufPayload, const ndefConstBuffer *bufMarker, uint32_t *offset);
     ReturnCode ndefVCardExtractLine(const ndefConstBuffer *bufPayload, const ndefConstBuffer *bufMarker, ndefConstBuffer *bufLine);
@@ -2468,7 +2941,7 @@ class NdefClass {
 
     RfalNfcClass *rfal_nfc;
 
-    uint8_t ndefRecordPoolIndex;
+    ndefRecordArena ndefRecordPoolArena;
     ndefRecord ndefRecordPool[NDEF_MAX_RECORD];
 };
 
@@ -64,17 +64,6 @@
  */
 
 
-/*****************************************************************************/
-ndefRecord *NdefClass::ndefAllocRecord(void)
-{
-  if (ndefRecordPoolIndex >= NDEF_MAX_RECORD) {
-    return NULL;
-  }
-
-  return &ndefRecordPool[ndefRecordPoolIndex++];
-}
-
-
 /*
  ******************************************************************************
  * GLOBAL FUNCTIONS
@@ -93,7 +82,8 @@ ReturnCode NdefClass::ndefMessageInit(ndefMessage *message)
   message->info.length      = 0;
   message->info.recordCount = 0;
 
-  ndefRecordPoolIndex = 0;
+  /* The records of the internal pool are given back */
+  (void)ndefRecordArenaRelease(&ndefRecordPoolArena, 0);
 
   return ERR_NONE;
 }
@@ -185,7 +175,6 @@ ReturnCode NdefClass::ndefMessageAppend(ndefMessage *message, ndefRecord *record
 ReturnCode NdefClass::ndefMessageDecode(const ndefConstBuffer *bufPayload, ndefMessage *message)
 {
   ReturnCode err;
-  uint32_t offset;
 
   if ((bufPayload == NULL) || (bufPayload->buffer == NULL) || (message == NULL)) {
     return ERR_PARAM;
@@ -196,27 +185,249 @@ ReturnCode NdefClass::ndefMessageDecode(const ndefConstBuffer *bufPayload, ndefM
     return err;
   }
 
-  offset = 0;
+  return ndefMessageDecodeArena(bufPayload, message, &ndefRecordPoolArena);
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefMessageDecodeArena(const ndefConstBuffer *bufPayload, ndefMessage *message, ndefRecordArena *arena)
+{
+  ReturnCode err;
+  uint32_t offset;
+  uint32_t mark;
+  bool     chunked;
+
+  if ((bufPayload == NULL) || (bufPayload->buffer == NULL) || (message == NULL) || (arena == NULL)) {
+    return ERR_PARAM;
+  }
+
+  /* Not ndefMessageInit(): the internal pool may hold another message */
+  message->record           = NULL;
+  message->info.length      = 0;
+  message->info.recordCount = 0;
+
+  mark    = ndefRecordArenaMark(arena);
+  offset  = 0;
+  chunked = false;
+  err     = ERR_NONE;
   while (offset < bufPayload->length) {
     ndefConstBuffer bufRecord;
-    ndefRecord *record = ndefAllocRecord();
+    ndefRecord *record = ndefRecordArenaAlloc(arena);
     if (record == NULL) {
-      return ERR_NOMEM;
+      err = ERR_NOMEM;
+      break;
     }
     bufRecord.buffer = &bufPayload->buffer[offset];
     bufRecord.length =  bufPayload->length - offset;
     err = ndefRecordDecode(&bufRecord, record);
     if (err != ERR_NONE) {
-      return err;
+      break;
+    }
+    /* Before ndefMessageAppend() updates the MB and ME bits */
+    err = ndefRecordCheckChunk(record, &chunked);
+    if (err != ERR_NONE) {
+      break;
     }
     offset += ndefRecordGetLength(record);
 
     err = ndefMessageAppend(message, record);
     if (err != ERR_NONE) {
-      return err;
+      break;
     }
   }
 
+  /* Terminating chunk missing */
+  if ((err == ERR_NONE) && chunked) {
+    err = ERR_PROTO;
+  }
+
+  if (err != ERR_NONE) {
+    /* Give the records back, the message is left empty */
+    (void)ndefRecordArenaRelease(arena, mark);
+    message->record           = NULL;
+    message->info.length      = 0;
+    message->info.recordCount = 0;
+  }
+
+  return err;
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefMessageDecoderInit(ndefMessageDecoder *dec, uint8_t *buf, uint32_t bufLen)
+{
+  if ((dec == NULL) || ((buf == NULL) && (bufLen != 0U))) {
+    return ERR_PARAM;
+  }
+
+  dec->buffer  = buf;
+  dec->length  = bufLen;
+  dec->fill    = 0;
+  dec->offset  = 0;
+  dec->base    = 0;
+  dec->chunked = false;
+  dec->end     = false;
+
+  return ERR_NONE;
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefMessageDecoderPush(ndefMessageDecoder *dec, const uint8_t *data, uint32_t len)
+{
+  if ((dec == NULL) || ((data == NULL) && (len != 0U))) {
+    return ERR_PARAM;
+  }
+
+  if (len > (dec->length - dec->fill)) {
+    return ERR_NOMEM;
+  }
+
+  /* Nothing to copy when the chunk has been received in place */
+  if ((len > 0U) && (data != &dec->buffer[dec->fill])) {
+    (void)ST_MEMMOVE(&dec->buffer[dec->fill], data, len);
+  }
+  dec->fill += len;
+
+  return ERR_NONE;
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefMessageDecoderGetRecord(ndefMessageDecoder *dec, ndefRecord *record, uint32_t *needed)
+{
+  ndefConstBuffer bufRecord;
+  const uint8_t  *p;
+  uint32_t        avail;
+  uint32_t        headerLen;
+  uint32_t        recordLen;
+  ReturnCode      err;
+
+  if ((dec == NULL) || (record == NULL)) {
+    return ERR_PARAM;
+  }
+
+  if (dec->end) {
+    return ERR_DONE;
+  }
+
+  p     = &dec->buffer[dec->offset];
+  avail = dec->fill - dec->offset;
+
+  /* Header byte and Type length, then Payload length and Id length fields as told by SR and IL */
+  headerLen = (2U * sizeof(uint8_t));
+  if (avail >= headerLen) {
+    record->header     = p[0];
+    record->typeLength = 0;
+    record->idLength   = 0;
+    headerLen          = ndefRecordGetHeaderLength(record);
+  }
+  if (avail < headerLen) {
+    if (needed != NULL) {
+      *needed = headerLen - avail;
+    }
+    return ERR_AGAIN;
+  }
+
+  record->typeLength = p[1];
+  record->idLength   = ndefHeaderIsSetIL(record) ? p[headerLen - 1U] : 0U;
+  recordLen          = ndefHeaderIsSetSR(record) ? p[2] : GETU32(&p[2]);
+
+  /* Whole record to fit in the buffer */
+  if (recordLen > (dec->length - dec->offset)) {
+    return ERR_NOMEM;
+  }
+  recordLen += ndefRecordGetHeaderLength(record);
+  if (recordLen > (dec->length - dec->offset)) {
+    return ERR_NOMEM;
+  }
+
+  if (avail < recordLen) {
+    if (needed != NULL) {
+      *needed = recordLen - avail;
+    }
+    return ERR_AGAIN;
+  }
+
+  bufRecord.buffer = p;
+  bufRecord.length = recordLen;
+  err = ndefRecordDecode(&bufRecord, record);
+  if (err != ERR_NONE) {
+    return err;
+  }
+  err = ndefRecordCheckChunk(record, &dec->chunked);
+  if (err != ERR_NONE) {
+    return err;
+  }
+
+  dec->offset += recordLen;
+  dec->end     = (ndefHeaderME(record) == 1U);
+
+  return ERR_NONE;
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefMessageDecoderCompact(ndefMessageDecoder *dec)
+{
+  if (dec == NULL) {
+    return ERR_PARAM;
+  }
+
+  /* Move the bytes not decoded yet to the beginning of the buffer */
+  if ((dec->offset > 0U) && (dec->fill > dec->offset)) {
+    (void)ST_MEMMOVE(dec->buffer, &dec->buffer[dec->offset], (dec->fill - dec->offset));
+  }
+  dec->base   += dec->offset;
+  dec->fill   -= dec->offset;
+  dec->offset  = 0;
+
+  return ERR_NONE;
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefRecordArenaInit(ndefRecordArena *arena, ndefRecord *records, uint32_t length)
+{
+  if ((arena == NULL) || ((records == NULL) && (length != 0U))) {
+    return ERR_PARAM;
+  }
+
+  arena->record = records;
+  arena->length = length;
+  arena->used   = 0;
+
+  return ERR_NONE;
+}
+
+
+/*****************************************************************************/
+ndefRecord *NdefClass::ndefRecordArenaAlloc(ndefRecordArena *arena)
+{
+  if ((arena == NULL) || (arena->used >= arena->length)) {
+    return NULL;
+  }
+
+  return &arena->record[arena->used++];
+}
+
+
+/*****************************************************************************/
+uint32_t NdefClass::ndefRecordArenaMark(const ndefRecordArena *arena)
+{
+  return ((arena == NULL) ? 0U : arena->used);
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefRecordArenaRelease(ndefRecordArena *arena, uint32_t mark)
+{
+  if ((arena == NULL) || (mark > arena->used)) {
+    return ERR_PARAM;
+  }
+
+  arena->used = mark;
+
   return ERR_NONE;
 }
 
@@ -263,3 +474,59 @@ ReturnCode NdefClass::ndefMessageEncode(const ndefMessage *message, ndefBuffer *
   bufPayload->length = offset;
   return ERR_NONE;
 }
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefMessageEncodeChunked(const ndefMessage *message, uint32_t chunkLen, ndefBuffer *bufPayload)
+{
+  ReturnCode  err;
+  ndefRecord *record;
+  ndefBuffer  bufRecord;
+  uint32_t    length;
+  uint32_t    offset;
+
+  if ((message == NULL) || (bufPayload == NULL) || (bufPayload->buffer == NULL) || (chunkLen == 0U)) {
+    return ERR_PARAM;
+  }
+
+  length = ndefMessageGetChunkedLength(message, chunkLen);
+  if (bufPayload->length < length) {
+    bufPayload->length = length;
+    return ERR_NOMEM;
+  }
+
+  record = ndefMessageGetFirstRecord(message);
+  offset = 0;
+  while (record != NULL) {
+    bufRecord.buffer = &bufPayload->buffer[offset];
+    bufRecord.length = bufPayload->length - offset;
+    err = ndefRecordEncodeChunked(record, chunkLen, &bufRecord);
+    if (err != ERR_NONE) {
+      bufPayload->length = length;
+      return err;
+    }
+    offset += bufRecord.length;
+
+    record = ndefMessageGetNextRecord(record);
+  }
+
+  bufPayload->length = offset;
+  return ERR_NONE;
+}
+
+
+/*****************************************************************************/
+uint32_t NdefClass::ndefMessageGetChunkedLength(const ndefMessage *message, uint32_t chunkLen)
+{
+  ndefRecord *record;
+  uint32_t    length;
+
+  length = 0;
+  record = ndefMessageGetFirstRecord(message);
+  while (record != NULL) {
+    length += ndefRecordGetChunkedLength(record, chunkLen);
+    record  = ndefMessageGetNextRecord(record);
+  }
+
+  return length;
+}
@@ -83,6 +83,26 @@ struct ndefMessageStruct {
 };
 
 
+/*! Incremental message decoder: the message is received in chunks into a caller-supplied buffer */
+typedef struct {
+  uint8_t    *buffer;   /*!< Buffer holding the bytes received, records point into it */
+  uint32_t    length;   /*!< Buffer length                                 */
+  uint32_t    fill;     /*!< Number of bytes received                      */
+  uint32_t    offset;   /*!< Offset of the next record                     */
+  uint32_t    base;     /*!< Message offset of the first buffer byte       */
+  bool        chunked;  /*!< Inside a chunked record                       */
+  bool        end;      /*!< Message End record decoded                    */
+} ndefMessageDecoder;
+
+
+/*! Record arena: caller-supplied storage the records of a message are taken from */
+typedef struct {
+  ndefRecord *record;   /*!< Record storage                                 */
+  uint32_t    length;   /*!< Number of records in the storage              */
+  uint32_t    used;     /*!< Number of records handed out, bump pointer     */
+} ndefRecordArena;
+
+
 /*
  ******************************************************************************
  * GLOBAL FUNCTION PROTOTYPES
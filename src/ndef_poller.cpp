@@ -157,6 +157,54 @@ ReturnCode NdefClass::ndefPollerReadRawMessage(uint8_t *buf, uint32_t bufLen, ui
   }
 }
 
+/*******************************************************************************/
+ReturnCode NdefClass::ndefPollerReadRecord(ndefMessageDecoder *dec, ndefRecord *record)
+{
+  ReturnCode ret;
+  uint32_t   needed;
+  uint32_t   len;
+  uint32_t   rcvdLen;
+
+  if ((dec == NULL) || (record == NULL)) {
+    return ERR_PARAM;
+  }
+
+  if (state <= NDEF_STATE_INITIALIZED) {
+    return ERR_WRONG_STATE;
+  }
+
+  for (;;) {
+    ret = ndefMessageDecoderGetRecord(dec, record, &needed);
+    if (ret != ERR_AGAIN) {
+      return ret;
+    }
+
+    /* Whole message consumed: no Message End record */
+    if ((dec->base + dec->offset) >= messageLen) {
+      return ERR_DONE;
+    }
+    if ((dec->base + dec->fill) >= messageLen) {
+      return ERR_PROTO;
+    }
+
+    /* Read the rest of the record, and ahead of it to save exchanges on short records */
+    len = MIN(MAX(needed, NDEF_READ_RECORD_LEN), (messageLen - (dec->base + dec->fill)));
+    len = MIN(len, (dec->length - dec->fill));
+    if (len == 0U) {
+      return ERR_NOMEM;
+    }
+
+    ret = ndefPollerReadBytes(messageOffset + dec->base + dec->fill, len, &dec->buffer[dec->fill], &rcvdLen);
+    if (ret != ERR_NONE) {
+      return ret;
+    }
+    if (rcvdLen == 0U) {
+      return ERR_PROTO;
+    }
+    EXIT_ON_ERR(ret, ndefMessageDecoderPush(dec, &dec->buffer[dec->fill], MIN(rcvdLen, len)));
+  }
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefPollerReadBytes(uint32_t offset, uint32_t len, uint8_t *buf, uint32_t *rcvdLen)
 {
@@ -340,16 +388,51 @@ ReturnCode NdefClass::ndefPollerEndWriteMessage(uint32_t messageLen)
   }
 }
 
+/*******************************************************************************/
+void NdefClass::ndefPollerSetDifferentialWrite(bool enable)
+{
+  differentialWrite = enable;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefPollerSetT2TIdentify(bool enable)
+{
+  t2tIdentify = enable;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefPollerSetWriteBuffer(uint8_t *buf, uint32_t bufLen)
+{
+  writeBuf    = (bufLen != 0U) ? buf : NULL;
+  writeBufLen = (buf != NULL) ? bufLen : 0U;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefPollerSetChunkLength(uint32_t chunkLen)
+{
+  writeChunkLen = chunkLen;
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefPollerWriteMessage(const ndefMessage *message)
 {
   ReturnCode      err;
   ndefMessageInfo info;
   ndefRecord     *record;
+  ndefRecord      chunk;
+  const ndefRecord *unit;
   uint8_t         recordHeaderBuf[NDEF_RECORD_HEADER_LEN];
   ndefBuffer      bufHeader;
   ndefConstBuffer bufPayloadItem;
+  ndefPayloadItemCursor cursor;
   uint32_t        offset;
+  uint32_t        staged;
+  uint32_t        payloadLength;
+  uint32_t        payloadOffset;
+  uint32_t        unitLength;
+  uint32_t        unitOffset;
+  uint32_t        itemOffset;
+  uint32_t        len;
   bool            firstPayloadItem;
 
   if ((message == NULL)) {
@@ -361,6 +444,7 @@ ReturnCode NdefClass::ndefPollerWriteMessage(const ndefMessage *message)
   }
 
   (void)ndefMessageGetInfo(message, &info);
+  info.length = ndefMessageGetChunkedLength(message, writeChunkLen);
 
   /* Verify length of the NDEF message */
   err = ndefPollerCheckAvailableSpace(info.length);
@@ -379,53 +463,71 @@ ReturnCode NdefClass::ndefPollerWriteMessage(const ndefMessage *message)
 
   if (info.length != 0U) {
     offset = messageOffset;
+    staged = 0;
     record = ndefMessageGetFirstRecord(message);
+    while ((record != NULL) && (err == ERR_NONE)) {
+      payloadLength         = ndefRecordGetPayloadLength(record);
+      payloadOffset         = 0;
+      itemOffset            = 0;
+      bufPayloadItem.buffer = NULL;
+      bufPayloadItem.length = 0;
+      firstPayloadItem      = true;
+
+      /* Whole record, or one chunk after the other when it is to be chunked */
+      do {
+        unit       = record;
+        unitLength = payloadLength;
+        if ((writeChunkLen != 0U) && (payloadLength > writeChunkLen)) {
+          ndefRecordChunkHeader(record, payloadOffset, writeChunkLen, &chunk);
+          unit       = &chunk;
+          unitLength = chunk.bufPayload.length;
+        }
 
-    while (record != NULL) {
-      bufHeader.buffer = recordHeaderBuf;
-      bufHeader.length = sizeof(recordHeaderBuf);
-      (void)ndefRecordEncodeHeader(record, &bufHeader);
-      err = ndefPollerWriteBytes(offset, bufHeader.buffer, bufHeader.length);
-      if (err != ERR_NONE) {
-        return err;
-      }
-      offset += bufHeader.length;
-      // TODO Use API to access record internal
-      if (record->typeLength != 0U) {
-        err = ndefPollerWriteBytes(offset, record->type, record->typeLength);
-        if (err != ERR_NONE) {
-          /* Conclude procedure */
-          state = NDEF_STATE_INVALID;
-          return err;
+        bufHeader.buffer = recordHeaderBuf;
+        bufHeader.length = sizeof(recordHeaderBuf);
+        (void)ndefRecordEncodeHeader(unit, &bufHeader);
+        err = ndefPollerWriteMessageItem(&offset, &staged, bufHeader.buffer, bufHeader.length);
+
+        // TODO Use API to access record internal
+        if ((err == ERR_NONE) && (unit->typeLength != 0U)) {
+          err = ndefPollerWriteMessageItem(&offset, &staged, unit->type, unit->typeLength);
         }
-        offset += record->typeLength;
-      }
-      if (record->idLength != 0U) {
-        err = ndefPollerWriteBytes(offset, record->id, record->idLength);
-        if (err != ERR_NONE) {
-          /* Conclude procedure */
-          state = NDEF_STATE_INVALID;
-          return err;
+
+        if ((err == ERR_NONE) && (unit->idLength != 0U)) {
+          err = ndefPollerWriteMessageItem(&offset, &staged, unit->id, unit->idLength);
         }
-        offset += record->idLength;
-      }
-      if (ndefRecordGetPayloadLength(record) != 0U) {
-        firstPayloadItem = true;
-        while (ndefRecordGetPayloadItem(record, &bufPayloadItem, firstPayloadItem) != NULL) {
-          firstPayloadItem = false;
-          err = ndefPollerWriteBytes(offset, bufPayloadItem.buffer, bufPayloadItem.length);
-          if (err != ERR_NONE) {
-            /* Conclude procedure */
-            state = NDEF_STATE_INVALID;
-            return err;
+
+        /* Payload items, an item may span several chunks */
+        unitOffset = 0;
+        while ((err == ERR_NONE) && (unitOffset < unitLength)) {
+          if (itemOffset >= bufPayloadItem.length) {
+            if (ndefRecordGetPayloadItem(record, &bufPayloadItem, &cursor, firstPayloadItem) == NULL) {
+              err = ERR_INTERNAL;
+            }
+            firstPayloadItem = false;
+            itemOffset       = 0;
+            continue;
           }
-          offset += bufPayloadItem.length;
+          len = MIN((bufPayloadItem.length - itemOffset), (unitLength - unitOffset));
+          err = ndefPollerWriteMessageItem(&offset, &staged, &bufPayloadItem.buffer[itemOffset], len);
+          itemOffset += len;
+          unitOffset += len;
         }
-      }
+        payloadOffset += unitLength;
+      } while ((err == ERR_NONE) && (payloadOffset < payloadLength));
+
       record = ndefMessageGetNextRecord(record);
     }
 
-    err = ndefPollerEndWriteMessage(info.length);
+    /* Write what is left in the Write Message buffer */
+    if (err == ERR_NONE) {
+      err = ndefPollerWriteMessageFlush(&offset, &staged, true);
+    }
+
+    if (err == ERR_NONE) {
+      err = ndefPollerEndWriteMessage(info.length);
+    }
+
     if (err != ERR_NONE) {
       /* Conclude procedure */
       state = NDEF_STATE_INVALID;
@@ -436,6 +538,95 @@ ReturnCode NdefClass::ndefPollerWriteMessage(const ndefMessage *message)
   return ERR_NONE;
 }
 
+/*******************************************************************************/
+ReturnCode NdefClass::ndefPollerWriteMessageItem(uint32_t *offset, uint32_t *staged, const uint8_t *data, uint32_t len)
+{
+  ReturnCode err;
+  uint32_t   n;
+
+  /* No Write Message buffer: each item is written on its own */
+  if (writeBuf == NULL) {
+    err = ndefPollerWriteBytes(*offset, data, len);
+    if (err == ERR_NONE) {
+      *offset += len;
+    }
+    return err;
+  }
+
+  while (len > 0U) {
+    n = MIN(len, (writeBufLen - *staged));
+    (void)ST_MEMCPY(&writeBuf[*staged], data, n);
+    *staged += n;
+    data     = &data[n];
+    len     -= n;
+
+    if (*staged == writeBufLen) {
+      EXIT_ON_ERR(err, ndefPollerWriteMessageFlush(offset, staged, false));
+    }
+  }
+
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefPollerWriteMessageFlush(uint32_t *offset, uint32_t *staged, bool all)
+{
+  ReturnCode err;
+  uint32_t   unit;
+  uint32_t   base;
+  uint32_t   rem;
+  uint32_t   len;
+
+  len = *staged;
+
+  if (!all) {
+    /* Stop on the granularity of the tag writes, the rest goes with the next chunk */
+    base = 0;
+    switch (type) {
+      case NDEF_DEV_T2T:
+        unit = NDEF_T2T_BLOCK_SIZE;
+        break;
+      case NDEF_DEV_T3T:
+        unit = NDEF_T3T_BLOCK_SIZE;
+        break;
+      case NDEF_DEV_T4T:
+        /* UPDATE BINARY is not block based: chunks of MLc from the message start */
+        unit = subCtx.t4t.curMLc;
+        base = messageOffset;
+        break;
+      case NDEF_DEV_T5T:
+        unit = ((uint32_t)subCtx.t5t.blockLen * NDEF_T5T_WR_MULT_MAX_BLOCKS);
+        break;
+      default:
+        unit = 0;
+        break;
+    }
+    if (unit != 0U) {
+      rem = (((*offset + len) - base) % unit);
+      if (rem < len) {
+        len -= rem;
+      }
+    }
+  }
+
+  if (len == 0U) {
+    return ERR_NONE;
+  }
+
+  err = ndefPollerWriteBytes(*offset, writeBuf, len);
+  if (err != ERR_NONE) {
+    return err;
+  }
+
+  *offset += len;
+  *staged -= len;
+  if (*staged != 0U) {
+    (void)ST_MEMMOVE(writeBuf, &writeBuf[len], *staged);
+  }
+
+  return ERR_NONE;
+}
+
 /*******************************************************************************/
 ndefDeviceType NdefClass::ndefPollerGetDeviceType(rfalNfcDevice *dev)
 {
@@ -476,4 +667,237 @@ ndefDeviceType NdefClass::ndefPollerGetDeviceType(rfalNfcDevice *dev)
   return type;
 }
 
+/*******************************************************************************/
+void NdefClass::ndefTlvScanInit(ndefTlvScanner *scan, uint32_t offset, uint32_t end, uint8_t unit, uint8_t readLen)
+{
+  scan->bufOffset  = 0U;
+  scan->bufLen     = 0U;
+  scan->offset     = offset;
+  scan->end        = end;
+  scan->unit       = ((unit == 0U) || (unit > NDEF_TLV_SCAN_BUF_LEN)) ? (uint8_t)NDEF_TLV_SCAN_BUF_LEN : unit;
+  scan->readLen    = (readLen > NDEF_TLV_SCAN_BUF_LEN) ? (uint8_t)NDEF_TLV_SCAN_BUF_LEN : readLen;
+  scan->readLen    = (uint8_t)((scan->readLen < scan->unit) ? scan->unit : (scan->readLen - (scan->readLen % scan->unit)));
+  scan->nbReserved = 0U;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefTlvScanSeed(ndefTlvScanner *scan, uint32_t offset, const uint8_t *data, uint32_t len)
+{
+  /* Data already read by the caller (e.g. the CC) is not read again */
+  if ((data == NULL) || (len == 0U) || (len > NDEF_TLV_SCAN_BUF_LEN)) {
+    return;
+  }
+  (void)ST_MEMCPY(scan->buf, data, len);
+  scan->bufOffset = offset;
+  scan->bufLen    = len;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefTlvScanAddReserved(ndefTlvScanner *scan, uint32_t offset, uint32_t len)
+{
+  if (len == 0U) {
+    return ERR_NONE;
+  }
+  if (scan->nbReserved >= NDEF_TLV_SCAN_MAX_RESERVED) {
+    return ERR_NOMEM;
+  }
+  scan->reserved[scan->nbReserved].offset = offset;
+  scan->reserved[scan->nbReserved].len    = len;
+  scan->nbReserved++;
+
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+uint32_t NdefClass::ndefTlvScanNextReserved(const ndefTlvScanner *scan, uint32_t offset)
+{
+  uint8_t  i;
+  uint32_t next = scan->end;
+
+  for (i = 0U; i < scan->nbReserved; i++) {
+    if ((scan->reserved[i].offset >= offset) && (scan->reserved[i].offset < next)) {
+      next = scan->reserved[i].offset;
+    }
+  }
+  return next;
+}
+
+/*******************************************************************************/
+uint32_t NdefClass::ndefTlvScanSkip(const ndefTlvScanner *scan, uint32_t offset, uint32_t len)
+{
+  uint8_t  i;
+  uint32_t le;
+  uint32_t next;
+  uint32_t lvOffset = offset;
+  uint32_t lvLen    = len;
+
+  /* Step over len bytes of the data area, the reserved areas are not part of the TLVs */
+  while (true) {
+    i = 0U;
+    while (i < scan->nbReserved) {
+      if ((lvOffset >= scan->reserved[i].offset) && (lvOffset < (scan->reserved[i].offset + scan->reserved[i].len))) {
+        lvOffset = scan->reserved[i].offset + scan->reserved[i].len;
+        i = 0U;
+      } else {
+        i++;
+      }
+    }
+    if (lvLen == 0U) {
+      break;
+    }
+    if (lvOffset >= scan->end) {
+      /* Beyond the data area: let the caller detect it */
+      lvOffset += lvLen;
+      break;
+    }
+    next      = ndefTlvScanNextReserved(scan, lvOffset);
+    le        = ((next - lvOffset) < lvLen) ? (next - lvOffset) : lvLen;
+    lvOffset += le;
+    lvLen    -= le;
+  }
+  return lvOffset;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefTlvScanRead(ndefTlvScanner *scan, uint32_t *offset, uint8_t *buf, uint32_t len)
+{
+  ReturnCode ret;
+  uint32_t   i;
+  uint32_t   start;
+  uint32_t   rdLen;
+  uint32_t   rcvdLen;
+  uint32_t   lvOffset = *offset;
+
+  for (i = 0U; i < len; i++) {
+    lvOffset = ndefTlvScanSkip(scan, lvOffset, 0U);
+    if (lvOffset >= scan->end) {
+      return ERR_REQUEST;
+    }
+    if ((lvOffset < scan->bufOffset) || (lvOffset >= (scan->bufOffset + scan->bufLen))) {
+      /* Refill the read-ahead buffer from the read unit holding lvOffset, readLen bytes
+       * at once so that a single multiple block read serves the next TLVs */
+      start = lvOffset - (lvOffset % scan->unit);
+      rdLen = ((scan->end - start) < scan->readLen) ? (scan->end - start) : scan->readLen;
+      scan->bufLen = 0U;
+      ret = ndefPollerReadBytes(start, rdLen, scan->buf, &rcvdLen);
+      if (ret != ERR_NONE) {
+        return ret;
+      }
+      if (rcvdLen != rdLen) {
+        return ERR_PROTO;
+      }
+      scan->bufOffset = start;
+      scan->bufLen    = rdLen;
+    }
+    buf[i] = scan->buf[lvOffset - scan->bufOffset];
+    lvOffset++;
+  }
+  *offset = lvOffset;
+
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefTlvScanNext(ndefTlvScanner *scan, ndefTlv *tlv)
+{
+  ReturnCode ret;
+  uint8_t    data[2];
+  uint32_t   lvOffset;
+
+  lvOffset    = ndefTlvScanSkip(scan, scan->offset, 0U);
+  tlv->offset = lvOffset;
+  tlv->len    = 0U;
+  ret = ndefTlvScanRead(scan, &lvOffset, &tlv->type, 1U);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+
+  /* NULL and Terminator TLVs consist of the T-field only */
+  if ((tlv->type != NDEF_NULL_TLV_T) && (tlv->type != NDEF_TERMINATOR_TLV_T)) {
+    ret = ndefTlvScanRead(scan, &lvOffset, data, 1U);
+    if (ret != ERR_NONE) {
+      return ret;
+    }
+    tlv->len = data[0];
+    if (data[0] == NDEF_3_BYTES_L_FIELD) {
+      ret = ndefTlvScanRead(scan, &lvOffset, data, 2U);
+      if (ret != ERR_NONE) {
+        return ret;
+      }
+      tlv->len = ndefBytes2Uint16(data[0], data[1]);
+    }
+  }
+  tlv->valueOffset = ndefTlvScanSkip(scan, lvOffset, 0U);
+  scan->offset     = ndefTlvScanSkip(scan, lvOffset, tlv->len);
+
+  return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+void NdefClass::ndefUidCacheInit(ndefUidCache *cache, void *entries, uint16_t entrySize, uint8_t nbEntries)
+{
+  (void)ST_MEMSET(entries, 0, ((uint32_t)entrySize * nbEntries));
+  cache->entries   = (uint8_t *)entries;
+  cache->entrySize = entrySize;
+  cache->nbEntries = nbEntries;
+  cache->stamp     = 0U;
+}
+
+/*******************************************************************************/
+void *NdefClass::ndefUidCacheFind(ndefUidCache *cache, const uint8_t *uid, uint8_t uidLen)
+{
+  ndefUidCacheKey *key;
+  uint8_t          i;
+
+  for (i = 0U; i < cache->nbEntries; i++) {
+    key = (ndefUidCacheKey *)&cache->entries[(uint32_t)i * cache->entrySize];
+    if ((key->lastUse != 0U) && (key->uidLen == uidLen) && (ST_BYTECMP(key->uid, uid, uidLen) == 0)) {
+      cache->stamp++;
+      key->lastUse = cache->stamp;
+      return key;
+    }
+  }
+  return NULL;
+}
 
+/*******************************************************************************/
+void *NdefClass::ndefUidCacheStore(ndefUidCache *cache, const uint8_t *uid, uint8_t uidLen)
+{
+  ndefUidCacheKey *entry = (ndefUidCacheKey *)cache->entries;
+  ndefUidCacheKey *key;
+  uint8_t          i;
+
+  if (uidLen > NDEF_UID_CACHE_UID_MAX_LEN) {
+    return NULL;
+  }
+
+  /* Entry of this tag if any, the least recently used one otherwise (free entries have a 0 stamp) */
+  for (i = 0U; i < cache->nbEntries; i++) {
+    key = (ndefUidCacheKey *)&cache->entries[(uint32_t)i * cache->entrySize];
+    if ((key->lastUse != 0U) && (key->uidLen == uidLen) && (ST_BYTECMP(key->uid, uid, uidLen) == 0)) {
+      entry = key;
+      break;
+    }
+    if (key->lastUse < entry->lastUse) {
+      entry = key;
+    }
+  }
+
+  cache->stamp++;
+  (void)ST_MEMCPY(entry->uid, uid, uidLen);
+  entry->uidLen  = uidLen;
+  entry->lastUse = cache->stamp;
+  return entry;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefUidCacheRemove(ndefUidCache *cache, const uint8_t *uid, uint8_t uidLen)
+{
+  ndefUidCacheKey *key;
+
+  key = (ndefUidCacheKey *)ndefUidCacheFind(cache, uid, uidLen);
+  if (key != NULL) {
+    key->lastUse = 0U;
+  }
+}
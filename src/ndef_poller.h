@@ -84,13 +84,25 @@
 #define NDEF_SHORT_VFIELD_MAX_LEN  254U                                                /*!< Max V-field length for 1-byte Length encoding                 */
 #define NDEF_TERMINATOR_TLV_LEN      1U                                                /*!< Terminator TLV size                                          */
 #define NDEF_TERMINATOR_TLV_T     0xFEU                                                /*!< Terminator TLV T=FEh                                         */
+#define NDEF_NULL_TLV_T           0x00U                                                /*!< NULL TLV T=00h                                               */
+#define NDEF_3_BYTES_L_FIELD      0xFFU                                                /*!< L-field first byte announcing a 3 bytes L-field              */
 
+#ifndef NDEF_READ_RECORD_LEN
+  #define NDEF_READ_RECORD_LEN      64U                                                /*!< Min bytes read ahead by ndefPollerReadRecord()               */
+#endif
+
+#define NDEF_TLV_SCAN_BUF_LEN       32U                                                /*!< TLV scanner read-ahead buffer len, at least the max T5T block len */
+#define NDEF_TLV_SCAN_MAX_RESERVED   4U                                                /*!< Max number of reserved/lock areas tracked by the TLV scanner */
+#define NDEF_UID_CACHE_UID_MAX_LEN  10U                                                /*!< Longest UID kept by a UID cache i.e. NFC-A triple size UID   */
+
+#define NDEF_T2T_BLOCK_SIZE          4U                                                /*!< block size                                                   */
 #define NDEF_T2T_READ_RESP_SIZE     16U                                                /*!< Size of the READ response i.e. four blocks                   */
 
 #define NDEF_T3T_BLOCK_SIZE         16U                                                /*!< size for a block in t3t                                      */
-#define NDEF_T3T_MAX_NB_BLOCKS       4U                                                /*!< size for a block in t3t                                      */
-#define NDEF_T3T_MAX_RX_SIZE      ((NDEF_T3T_BLOCK_SIZE*NDEF_T3T_MAX_NB_BLOCKS) + 16U) /*!< size for receive 4 blocks of 16 + UID + HEADER + CHECKSUM    */
-#define NDEF_T3T_MAX_TX_SIZE      ((NDEF_T3T_BLOCK_SIZE*NDEF_T3T_MAX_NB_BLOCKS) + 16U) /*!< size for send Check 4 blocks of 16 + UID + HEADER + CHECKSUM */
+#define NDEF_T3T_MAX_NB_BLOCKS      15U                                                /*!< max nb of blocks per CHECK (FeliCa limit)                    */
+#define NDEF_T3T_MAX_RX_SIZE      ((NDEF_T3T_BLOCK_SIZE*NDEF_T3T_MAX_NB_BLOCKS) + 16U) /*!< size for receive 15 blocks of 16 + UID + HEADER + CHECKSUM   */
+#define NDEF_T3T_MAX_TX_SIZE                  \
+          (((NDEF_T3T_BLOCK_SIZE + sizeof(rfalNfcfBlockListElem)) * NDEF_T3T_MAX_NB_BLOCKS) + 16U) /*!< size for send Update: blocks + block list + UID + HEADER */
 
 #define NDEF_T5T_TxRx_BUFF_HEADER_SIZE        1U                                       /*!< Request Flags/Responses Flags size                           */
 #define NDEF_T5T_TxRx_BUFF_FOOTER_SIZE        2U                                       /*!< CRC size                                                     */
@@ -98,6 +110,14 @@
 #define NDEF_T5T_TxRx_BUFF_SIZE               \
           (32U +  NDEF_T5T_TxRx_BUFF_HEADER_SIZE + NDEF_T5T_TxRx_BUFF_FOOTER_SIZE)     /*!< T5T working buffer size                                      */
 
+#ifndef NDEF_T5T_RD_MULT_MAX_LEN
+  #define NDEF_T5T_RD_MULT_MAX_LEN            128U                                     /*!< Max data bytes requested per Read Multiple Blocks            */
+#endif
+
+#ifndef NDEF_T5T_WR_MULT_MAX_BLOCKS
+  #define NDEF_T5T_WR_MULT_MAX_BLOCKS           4U                                     /*!< Max blocks per Write Multiple Blocks (ST25DV limit)          */
+#endif
+
 /*
  ******************************************************************************
  * GLOBAL MACROS
@@ -115,6 +135,39 @@
  ******************************************************************************
  */
 
+#ifndef NDEF_T2T_CACHE_WINDOWS
+  #define NDEF_T2T_CACHE_WINDOWS       4U                                              /*!< Number of T2T READ responses kept in the T2T read cache      */
+#endif
+
+/* Read-ahead pays off on FAST_READ capable tags (NTAG21x, NTAG I2C) read in
+ * small forward steps, e.g. the incremental decoder fed by 16 bytes
+ * ndefPollerReadBytes() calls: a miss is then followed by one FAST_READ of the
+ * next windows instead of one READ per window (3 halves the frames of such a
+ * read). Without FAST_READ every window still costs a READ, and on short
+ * messages the prefetch reads past the message end: keep it at 0 then. */
+#ifndef NDEF_T2T_CACHE_READ_AHEAD
+  #define NDEF_T2T_CACHE_READ_AHEAD    0U                                              /*!< Number of T2T READ responses prefetched on sequential reads, at most NDEF_T2T_CACHE_WINDOWS - 1 */
+#endif
+
+#ifndef NDEF_T2T_PROFILE_CACHE_LEN
+  #define NDEF_T2T_PROFILE_CACHE_LEN   4U                                              /*!< Number of T2T tags (UIDs) whose model profile is remembered, at least 1 */
+#endif
+
+#ifndef NDEF_T2T_IDENTIFY_MAX_TRIES
+  #define NDEF_T2T_IDENTIFY_MAX_TRIES  3U                                              /*!< Unanswered GET_VERSION probes after which a T2T tag is remembered as an unknown model */
+#endif
+
+#ifndef NDEF_T2T_FAST_READ_MAX_LEN
+  #define NDEF_T2T_FAST_READ_MAX_LEN 252U                                              /*!< Max length of a T2T FAST_READ response, bounded by the RF buffer (RFAL_NFC_RF_BUF_LEN). 0 disables FAST_READ */
+#endif
+
+#ifndef NDEF_T3T_AIB_CACHE_LEN
+  #define NDEF_T3T_AIB_CACHE_LEN       4U                                              /*!< Number of T3T tags (NFCID2) whose Attribute Information Block is remembered, at least 1 */
+#endif
+
+#ifndef NDEF_T5T_SYSINFO_CACHE_LEN
+  #define NDEF_T5T_SYSINFO_CACHE_LEN   4U                                              /*!< Number of T5T tags (UIDs) whose System Information is remembered, at least 1 */
+#endif
 
 /*
  ******************************************************************************
@@ -150,6 +203,48 @@ typedef struct {
   ndefState                state;                            /*!< Tag state e.g. NDEF_STATE_INITIALIZED              */
 } ndefInfo;
 
+/*! Tag memory area  */
+typedef struct {
+  uint32_t                 offset;                           /*!< Area offset                                        */
+  uint32_t                 len;                              /*!< Area length                                        */
+} ndefArea;
+
+/*! TLV block found by the TLV scanner  */
+typedef struct {
+  uint8_t                  type;                             /*!< T-field                                            */
+  uint32_t                 offset;                           /*!< Offset of the T-field                              */
+  uint32_t                 valueOffset;                      /*!< Offset of the V-field                              */
+  uint32_t                 len;                              /*!< L-field value, 0 for NULL and Terminator TLVs      */
+} ndefTlv;
+
+/*! TLV scanner: walks the TLV blocks of a tag data area through a read-ahead buffer  */
+typedef struct {
+  uint8_t                  buf[NDEF_TLV_SCAN_BUF_LEN];       /*!< Read-ahead buffer                                  */
+  uint32_t                 bufOffset;                        /*!< Tag offset of buf[0]                               */
+  uint32_t                 bufLen;                           /*!< Number of valid bytes in buf                       */
+  uint32_t                 offset;                           /*!< Offset of the next TLV                             */
+  uint32_t                 end;                              /*!< End of the data area                               */
+  uint8_t                  unit;                             /*!< Read unit (block size) of the tag                  */
+  uint8_t                  readLen;                          /*!< Bytes read per refill, a multiple of unit          */
+  ndefArea                 reserved[NDEF_TLV_SCAN_MAX_RESERVED]; /*!< Reserved/lock areas skipped by the TLVs        */
+  uint8_t                  nbReserved;                       /*!< Number of reserved areas                           */
+} ndefTlvScanner;
+
+/*! UID cache entry key, first member of every UID cache entry  */
+typedef struct {
+  uint8_t                  uid[NDEF_UID_CACHE_UID_MAX_LEN];  /*!< Tag UID (NFCID1, NFCID2 or NFC-V UID)              */
+  uint8_t                  uidLen;                           /*!< Tag UID length                                     */
+  uint32_t                 lastUse;                          /*!< Least recently used stamp, 0 if the entry is free  */
+} ndefUidCacheKey;
+
+/*! UID cache: data remembered per tag, the least recently used entry is replaced first  */
+typedef struct {
+  uint8_t                 *entries;                          /*!< Entries, each one starting with a ndefUidCacheKey  */
+  uint16_t                 entrySize;                        /*!< Size of an entry                                   */
+  uint8_t                  nbEntries;                        /*!< Number of entries                                  */
+  uint32_t                 stamp;                            /*!< Last use stamp                                     */
+} ndefUidCache;
+
 /*! NFCV (Extended) System Information  */
 typedef struct {
   uint16_t                 numberOfBlock;                    /*!< Number of block                                    */
@@ -235,26 +330,72 @@ typedef struct {
   void *rfu;                                                 /*!< RFU                                                */
 } ndefT1TContext;
 
+/*! NDEF T2T read cache window */
+typedef struct {
+  uint8_t                     buf[NDEF_T2T_READ_RESP_SIZE];      /*!< READ response                                  */
+  uint32_t                    addr;                              /*!< Byte address of buf[0]                         */
+  uint8_t                     len;                               /*!< Number of valid bytes in buf, 0 if unused      */
+} ndefT2TCacheWindow;
+
+/*! NDEF T2T write-back block */
+typedef struct {
+  uint8_t                     buf[NDEF_T2T_BLOCK_SIZE];          /*!< Block data                                     */
+  uint16_t                    blockAddr;                         /*!< Block address                                  */
+  uint8_t                     mask;                              /*!< Bytes to be written (bit n: buf[n]), 0 if free */
+} ndefT2TWriteBackBlock;
+
+/*! T2T model profile, identified by the GET_VERSION response */
+typedef struct {
+  uint8_t                     productType;                       /*!< GET_VERSION product type                       */
+  uint8_t                     productSubtype;                    /*!< GET_VERSION product subtype                    */
+  uint8_t                     storageSize;                       /*!< GET_VERSION storage size                       */
+  uint16_t                    areaMaxLen;                        /*!< Memory from block 4 up to the last user block  */
+  bool                        fastRead;                          /*!< FAST_READ supported                            */
+  uint8_t                     maxReadBlocks;                     /*!< Max blocks read by a single FAST_READ          */
+} ndefT2TProfile;
+
+/*! T2T model profile cache entry */
+typedef struct {
+  ndefUidCacheKey             key;                               /*!< Tag UID                                        */
+  const ndefT2TProfile       *profile;                           /*!< Tag model profile, NULL if unknown             */
+  uint8_t                     fastRead;                          /*!< FAST_READ support: unknown, supported or not   */
+  uint8_t                     tries;                             /*!< Unanswered GET_VERSION probes, 0 if identified */
+} ndefT2TProfileEntry;
+
 /*! NDEF T2T sub context structure */
 typedef struct {
-  uint8_t                     currentSecNo;                      /*!< Current sector number                          */
-  uint8_t                     cacheBuf[NDEF_T2T_READ_RESP_SIZE]; /*!< Cache buffer                                   */
-  uint32_t                    cacheAddr;                         /*!< Address of cached data                         */
+  ndefT2TCacheWindow          cache[NDEF_T2T_CACHE_WINDOWS];     /*!< Read cache windows                             */
+  uint8_t                     cacheNext;                         /*!< Next cache window to be replaced               */
+  uint32_t                    cacheEnd;                          /*!< Address following the last fetched window      */
+  uint8_t                     fastRead;                          /*!< FAST_READ support: unknown, supported or not   */
+  const ndefT2TProfile       *profile;                           /*!< Tag model profile, NULL if unknown             */
+  ndefT2TWriteBackBlock       wbData;                            /*!< Pending block of a message write               */
+  ndefT2TWriteBackBlock       wbLField;                          /*!< Pending block holding the L-field              */
+  bool                        writeBack;                         /*!< Message write in progress: writes are buffered */
+  uint32_t                    writeEnd;                          /*!< End of the message write in progress           */
   uint32_t                    offsetNdefTLV;                     /*!< NDEF TLV message offset                        */
 } ndefT2TContext;
 
+/*! T3T Attribute Information Block cache entry */
+typedef struct {
+  ndefUidCacheKey              key;                                 /*!< Tag NFCID2                                              */
+  uint8_t                      aib[NDEF_T3T_BLOCK_SIZE];            /*!< Last Attribute Information Block read or written        */
+} ndefT3TAibCacheEntry;
+
 /*! NDEF T3T sub context structure */
 typedef struct {
   uint8_t                      txbuf[NDEF_T3T_MAX_TX_SIZE];         /*!< Tx buffer dedicated for T3T internal operations         */
   uint8_t                      rxbuf[NDEF_T3T_MAX_RX_SIZE];         /*!< Rx buffer dedicated for T3T internal operations         */
   rfalNfcfBlockListElem        listBlocks[NDEF_T3T_MAX_NB_BLOCKS];  /*!< block number list for T3T internal operations           */
+  bool                         aibSpeculative;                      /*!< AIB taken from the cache, not yet confirmed by the tag  */
 } ndefT3TContext;
 
 /*! NDEF T4T sub context structure */
 typedef struct {
-  uint8_t                      curMLe;                       /*!< Current MLe. Default Fh until CC file is read      */
-  uint8_t                      curMLc;                       /*!< Current MLc. Default Dh until CC file is read      */
+  uint16_t                     curMLe;                       /*!< Current MLe. Default Fh until CC file is read      */
+  uint16_t                     curMLc;                       /*!< Current MLc. Default Dh until CC file is read      */
   bool                         mv1Flag;                      /*!< Mapping version 1 flag                             */
+  bool                         ccValid;                      /*!< CC file read while the application stayed selected */
   rfalIsoDepApduBufFormat      cApduBuf;                     /*!< Command-APDU buffer                                */
   rfalIsoDepApduBufFormat      rApduBuf;                     /*!< Response-APDU buffer                               */
   rfalT4tRApduParam            respAPDU;                     /*!< Response-APDU params                               */
@@ -262,6 +403,15 @@ typedef struct {
   uint16_t                     rApduBodyLen;                 /*!< Response Body Len                                  */
 } ndefT4TContext;
 
+/*! T5T System Information cache entry */
+typedef struct {
+  ndefUidCacheKey              key;                          /*!< Tag UID                                            */
+  ndefSystemInformation        sysInfo;                      /*!< System Information (when supported)                */
+  bool                         sysInfoSupported;             /*!< System Information Supported flag                  */
+  bool                         legacySTHighDensity;          /*!< Legacy ST High Density flag                        */
+  uint8_t                      blockLen;                     /*!< Block length seen when the entry was stored        */
+} ndefT5TSysInfoCacheEntry;
+
 /*! NDEF T5T sub context structure */
 typedef struct {
   uint8_t                     *pAddressedUid;                /*!< Pointer to UID in Addr mode or NULL selected one   */
@@ -270,6 +420,9 @@ typedef struct {
   ndefSystemInformation        sysInfo;                      /*!< System Information (when supported)                */
   bool                         sysInfoSupported;             /*!< System Information Supported flag                  */
   bool                         legacySTHighDensity;          /*!< Legacy ST High Density flag                        */
+  bool                         rdMultDisabled;               /*!< Read Multiple Blocks rejected by the tag           */
+  bool                         wrMultDisabled;               /*!< Write Multiple Blocks rejected by the tag          */
+  bool                         stFastRead;                   /*!< ST Fast Read Multiple Blocks in use                */
   uint8_t                      txrxBuf[NDEF_T5T_TxRx_BUFF_SIZE];  /*!< Tx Rx Buffer                                  */
 } ndefT5TContext;
 
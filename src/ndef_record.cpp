@@ -427,6 +427,7 @@ ReturnCode NdefClass::ndefRecordPayloadEncode(const ndefRecord *record, ndefBuff
   uint32_t offset;
   bool     begin;
   ndefConstBuffer bufPayloadItem;
+  ndefPayloadItemCursor cursor;
 
   if ((record == NULL) || (bufPayload == NULL)) {
     return ERR_PROTO;
@@ -439,7 +440,7 @@ ReturnCode NdefClass::ndefRecordPayloadEncode(const ndefRecord *record, ndefBuff
 
   begin  = true;
   offset = 0;
-  while (ndefRecordGetPayloadItem(record, &bufPayloadItem, begin) != NULL) {
+  while (ndefRecordGetPayloadItem(record, &bufPayloadItem, &cursor, begin) != NULL) {
     begin = false;
     if (bufPayloadItem.length > 0U) {
       ST_MEMCPY(&bufPayload->buffer[offset], bufPayloadItem.buffer, bufPayloadItem.length);
@@ -506,6 +507,237 @@ ReturnCode NdefClass::ndefRecordEncode(const ndefRecord *record, ndefBuffer *buf
 }
 
 
+/*****************************************************************************/
+void NdefClass::ndefRecordChunkHeader(const ndefRecord *record, uint32_t payloadOffset, uint32_t chunkLen, ndefRecord *chunk)
+{
+  uint32_t payloadLength;
+  uint32_t length;
+  uint8_t  last;
+
+  payloadLength = ndefRecordGetPayloadLength(record);
+  length        = MIN(chunkLen, (payloadLength - payloadOffset));
+  last          = (((payloadOffset + length) >= payloadLength) ? 1U : 0U);
+
+  if (payloadOffset == 0U) {
+    /* Initial chunk: record type and Id */
+    chunk->header     = ndefHeader(ndefHeaderMB(record), 0U, 1U, 0U, ndefHeaderIL(record), ndefHeaderTNF(record));
+    chunk->typeLength = record->typeLength;
+    chunk->type       = record->type;
+    chunk->idLength   = record->idLength;
+    chunk->id         = record->id;
+  } else {
+    /* Middle and terminating chunks: unchanged type, no Id */
+    chunk->header     = ndefHeader(0U, ((last == 1U) ? ndefHeaderME(record) : 0U), ((last == 1U) ? 0U : 1U), 0U, 0U, NDEF_TNF_UNCHANGED);
+    chunk->typeLength = 0;
+    chunk->type       = NULL;
+    chunk->idLength   = 0;
+    chunk->id         = NULL;
+  }
+  ndefHeaderSetValueSR(chunk, (length <= NDEF_SHORT_RECORD_LENGTH_MAX) ? 1 : 0);
+
+  /* Only the length is used to encode the chunk header */
+  chunk->bufPayload.buffer = NULL;
+  chunk->bufPayload.length = length;
+  chunk->ndeftype          = NULL;
+  chunk->next              = NULL;
+}
+
+
+/*****************************************************************************/
+uint32_t NdefClass::ndefRecordGetChunkedLength(const ndefRecord *record, uint32_t chunkLen)
+{
+  ndefRecord chunk;
+  uint32_t   payloadLength;
+  uint32_t   payloadOffset;
+  uint32_t   length;
+
+  payloadLength = ndefRecordGetPayloadLength(record);
+  if ((chunkLen == 0U) || (payloadLength <= chunkLen)) {
+    return ndefRecordGetLength(record);
+  }
+
+  length        = 0;
+  payloadOffset = 0;
+  while (payloadOffset < payloadLength) {
+    ndefRecordChunkHeader(record, payloadOffset, chunkLen, &chunk);
+    length        += ndefRecordGetLength(&chunk);
+    payloadOffset += chunk.bufPayload.length;
+  }
+
+  return length;
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefRecordEncodeChunked(const ndefRecord *record, uint32_t chunkLen, ndefBuffer *bufRecord)
+{
+  ReturnCode            err;
+  ndefRecord            chunk;
+  ndefBuffer            bufHeader;
+  ndefConstBuffer       bufPayloadItem;
+  ndefPayloadItemCursor cursor;
+  uint32_t              payloadLength;
+  uint32_t              payloadOffset;
+  uint32_t              itemOffset;
+  uint32_t              chunkOffset;
+  uint32_t              length;
+  uint32_t              offset;
+  bool                  begin;
+
+  if ((record == NULL) || (bufRecord == NULL) || (bufRecord->buffer == NULL) || (chunkLen == 0U)) {
+    return ERR_PARAM;
+  }
+
+  payloadLength = ndefRecordGetPayloadLength(record);
+  if (payloadLength <= chunkLen) {
+    return ndefRecordEncode(record, bufRecord);
+  }
+
+  length = ndefRecordGetChunkedLength(record, chunkLen);
+  if (bufRecord->length < length) {
+    bufRecord->length = length;
+    return ERR_NOMEM;
+  }
+
+  bufPayloadItem.buffer = NULL;
+  bufPayloadItem.length = 0;
+  itemOffset    = 0;
+  begin         = true;
+  payloadOffset = 0;
+  offset        = 0;
+  while (payloadOffset < payloadLength) {
+    ndefRecordChunkHeader(record, payloadOffset, chunkLen, &chunk);
+
+    bufHeader.buffer = &bufRecord->buffer[offset];
+    bufHeader.length = bufRecord->length - offset;
+    err = ndefRecordEncodeHeader(&chunk, &bufHeader);
+    if (err != ERR_NONE) {
+      return err;
+    }
+    offset += bufHeader.length;
+
+    /* Set Type and Id, initial chunk only */
+    if (chunk.typeLength > 0U) {
+      (void)ST_MEMCPY(&bufRecord->buffer[offset], chunk.type, chunk.typeLength);
+      offset += chunk.typeLength;
+    }
+    if (chunk.idLength > 0U) {
+      (void)ST_MEMCPY(&bufRecord->buffer[offset], chunk.id, chunk.idLength);
+      offset += chunk.idLength;
+    }
+
+    /* Set the chunk payload, a payload item may span several chunks */
+    chunkOffset = 0;
+    while (chunkOffset < chunk.bufPayload.length) {
+      if (itemOffset >= bufPayloadItem.length) {
+        if (ndefRecordGetPayloadItem(record, &bufPayloadItem, &cursor, begin) == NULL) {
+          return ERR_INTERNAL;
+        }
+        begin      = false;
+        itemOffset = 0;
+        continue;
+      }
+      length = MIN((bufPayloadItem.length - itemOffset), (chunk.bufPayload.length - chunkOffset));
+      (void)ST_MEMCPY(&bufRecord->buffer[offset], &bufPayloadItem.buffer[itemOffset], length);
+      offset      += length;
+      itemOffset  += length;
+      chunkOffset += length;
+    }
+    payloadOffset += chunk.bufPayload.length;
+  }
+
+  bufRecord->length = offset;
+
+  return ERR_NONE;
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefRecordCheckChunk(const ndefRecord *record, bool *chunked)
+{
+  if ((record == NULL) || (chunked == NULL)) {
+    return ERR_PARAM;
+  }
+
+  if (*chunked) {
+    /* Middle or terminating chunk */
+    if ((ndefHeaderTNF(record) != NDEF_TNF_UNCHANGED) ||
+        (record->typeLength    != 0U) ||
+        ndefHeaderIsSetIL(record)) {
+      return ERR_PROTO;
+    }
+  } else {
+    /* Unchanged type outside of a chunked record */
+    if (ndefHeaderTNF(record) == NDEF_TNF_UNCHANGED) {
+      return ERR_PROTO;
+    }
+  }
+
+  /* A chunked record cannot end the message */
+  if ((ndefHeaderCF(record) == 1U) && (ndefHeaderME(record) == 1U)) {
+    return ERR_PROTO;
+  }
+
+  *chunked = (ndefHeaderCF(record) == 1U);
+
+  return ERR_NONE;
+}
+
+
+/*****************************************************************************/
+uint32_t NdefClass::ndefRecordGetChunkedPayloadLength(const ndefRecord *record)
+{
+  uint32_t length;
+
+  length = 0;
+  while (record != NULL) {
+    length += ndefRecordGetPayloadLength(record);
+    if (ndefHeaderCF(record) == 0U) {
+      break;
+    }
+    record = record->next;
+  }
+
+  return length;
+}
+
+
+/*****************************************************************************/
+ReturnCode NdefClass::ndefRecordGetChunkedPayload(const ndefRecord *record, ndefBuffer *bufPayload)
+{
+  ndefConstBuffer bufChunk;
+  uint32_t        length;
+  uint32_t        offset;
+
+  if ((record == NULL) || (bufPayload == NULL) || (bufPayload->buffer == NULL)) {
+    return ERR_PARAM;
+  }
+
+  length = ndefRecordGetChunkedPayloadLength(record);
+  if (bufPayload->length < length) {
+    bufPayload->length = length;
+    return ERR_NOMEM;
+  }
+
+  offset = 0;
+  while (record != NULL) {
+    (void)ndefRecordGetPayload(record, &bufChunk);
+    if (bufChunk.length > 0U) {
+      (void)ST_MEMCPY(&bufPayload->buffer[offset], bufChunk.buffer, bufChunk.length);
+      offset += bufChunk.length;
+    }
+    if (ndefHeaderCF(record) == 0U) {
+      break;
+    }
+    record = record->next;
+  }
+
+  bufPayload->length = offset;
+
+  return ERR_NONE;
+}
+
+
 /*****************************************************************************/
 uint32_t NdefClass::ndefRecordGetPayloadLength(const ndefRecord *record)
 {
@@ -528,7 +760,14 @@ uint32_t NdefClass::ndefRecordGetPayloadLength(const ndefRecord *record)
 /*****************************************************************************/
 const uint8_t *NdefClass::ndefRecordGetPayloadItem(const ndefRecord *record, ndefConstBuffer *bufPayloadItem, bool begin)
 {
-  if ((record == NULL) || (bufPayloadItem == NULL)) {
+  return ndefRecordGetPayloadItem(record, bufPayloadItem, &payloadItemCursor, begin);
+}
+
+
+/*****************************************************************************/
+const uint8_t *NdefClass::ndefRecordGetPayloadItem(const ndefRecord *record, ndefConstBuffer *bufPayloadItem, ndefPayloadItemCursor *cursor, bool begin)
+{
+  if ((record == NULL) || (bufPayloadItem == NULL) || (cursor == NULL)) {
     return NULL;
   }
 
@@ -536,7 +775,7 @@ const uint8_t *NdefClass::ndefRecordGetPayloadItem(const ndefRecord *record, nde
   bufPayloadItem->length = 0;
 
   if ((record->ndeftype != NULL) && (record->ndeftype->getPayloadItem != NULL)) {
-    record->ndeftype->getPayloadItem(record->ndeftype, bufPayloadItem, begin);
+    record->ndeftype->getPayloadItem(record->ndeftype, bufPayloadItem, cursor, begin);
   } else {
     if (begin == true) {
       (void)ndefRecordGetPayload(record, bufPayloadItem);
@@ -49,7 +49,6 @@
  ******************************************************************************
  */
 
-#define NDEF_T2T_BLOCK_SIZE            4U         /*!< block size                                        */
 #define NDEF_T2T_MAX_SECTOR          255U         /*!< Max Number of Sector in Sector Select Command     */ /* 00h -- FEh: 255 sectors */
 #define NDEF_T2T_BLOCKS_PER_SECTOR   256U         /*!< Number of Block per Sector                        */
 #define NDEF_T2T_BYTES_PER_SECTOR (NDEF_T2T_BLOCKS_PER_SECTOR * NDEF_T2T_BLOCK_SIZE) /*!< Number of Bytes per Sector                        */
@@ -81,6 +80,16 @@
 #define NDEF_T2T_TLV_L_3_BYTES_LEN     3U         /*!< TLV L Length: 3 bytes                             */
 #define NDEF_T2T_TLV_L_1_BYTES_LEN     1U         /*!< TLV L Length: 1 bytes                             */
 #define NDEF_T2T_TLV_T_LEN             1U         /*!< TLV T Length: 1 bytes                             */
+#define NDEF_T2T_TLV_CTRL_LEN          3U         /*!< Lock/Memory Control TLV V Length: 3 bytes         */
+#define NDEF_T2T_TLV_CTRL_MAX_SIZE   256U         /*!< Lock/Memory Control TLV Size 00h means 256        */
+
+#define NDEF_T2T_FAST_READ_UNKNOWN     0U         /*!< FAST_READ support not probed yet                  */
+#define NDEF_T2T_FAST_READ_SUPPORTED   1U         /*!< FAST_READ supported                               */
+#define NDEF_T2T_FAST_READ_UNSUPPORTED 2U         /*!< FAST_READ NACKed: use READ only                   */
+
+#define NDEF_T2T_VENDOR_ID_NXP      0x04U         /*!< GET_VERSION vendor ID: NXP                        */
+
+#define NDEF_T2T_WB_MASK_FULL       0x0FU         /*!< Write-back block mask: all bytes written          */
 
 /*
  ******************************************************************************
@@ -95,7 +104,7 @@
  */
 
 #define ndefT2TisT2TDevice(device) ((((device)->type == RFAL_NFC_LISTEN_TYPE_NFCA) && ((device)->dev.nfca.type == RFAL_NFCA_T2T)))
-#define ndefT2TInvalidateCache() { subCtx.t2t.cacheAddr = 0xFFFFFFFFU; }
+#define ndefT2TWriteBackDrop()     { subCtx.t2t.wbData.mask = 0U; subCtx.t2t.wbLField.mask = 0U; subCtx.t2t.writeBack = false; }
 
 
 #define ndefT2TIsReadOnlyAccessGranted()  ((cc.t2t.readAccess == 0x0U) && (cc.t2t.writeAccess == 0xFU))
@@ -107,6 +116,19 @@
  ******************************************************************************
  */
 
+/*! NXP NTAG/Ultralight EV1 models: type, subtype, storage size, area max len, FAST_READ, max FAST_READ blocks */
+static const ndefT2TProfile ndefT2TProfiles[] = {
+  { 0x04U, 0x01U, 0x0BU,   48U, true, 0x14U },  /* NTAG210                */
+  { 0x04U, 0x01U, 0x0EU,  128U, true, 0x29U },  /* NTAG212                */
+  { 0x04U, 0x02U, 0x0FU,  144U, true, 0x2DU },  /* NTAG213                */
+  { 0x04U, 0x02U, 0x11U,  504U, true, 0x87U },  /* NTAG215                */
+  { 0x04U, 0x02U, 0x13U,  888U, true, 0xE7U },  /* NTAG216                */
+  { 0x04U, 0x05U, 0x13U,  888U, true, 0xFFU },  /* NTAG I2C (plus) 1k     */
+  { 0x04U, 0x05U, 0x15U, 1904U, true, 0xFFU },  /* NTAG I2C (plus) 2k     */
+  { 0x03U, 0x01U, 0x0BU,   48U, true, 0x14U },  /* MIFARE Ultralight EV1 MF0UL11 */
+  { 0x03U, 0x01U, 0x0EU,  128U, true, 0x29U },  /* MIFARE Ultralight EV1 MF0UL21 */
+};
+
 /*
  ******************************************************************************
  * LOCAL FUNCTION PROTOTYPES
@@ -135,12 +157,9 @@ ReturnCode NdefClass::ndefT2TPollerReadBlock(uint16_t blockAddr, uint8_t *buf)
   secNo = (uint8_t)(blockAddr >> 8U);
   blNo  = (uint8_t)blockAddr;
 
-  if (secNo != subCtx.t2t.currentSecNo) {
-    ret = rfal_nfc->rfalT2TPollerSectorSelect(secNo);
-    if (ret != ERR_NONE) {
-      return ret;
-    }
-    subCtx.t2t.currentSecNo = secNo;
+  ret = ndefT2TPollerSelectSector(secNo);
+  if (ret != ERR_NONE) {
+    return ret;
   }
 
   ret = rfal_nfc->rfalT2TPollerRead(blNo, buf, NDEF_T2T_READ_RESP_SIZE, &rcvdLen);
@@ -152,67 +171,447 @@ ReturnCode NdefClass::ndefT2TPollerReadBlock(uint16_t blockAddr, uint8_t *buf)
   return ret;
 }
 
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TPollerFastReadBlocks(uint16_t blockAddr, uint16_t nbBlocks, uint8_t *buf)
+{
+  ReturnCode           ret;
+  uint8_t              secNo;
+  uint8_t              blNo;
+  uint16_t             rcvdLen;
+  uint16_t             len;
+
+  if (!ndefT2TisT2TDevice(&device) || (buf == NULL) || (nbBlocks == 0U) || (nbBlocks > (NDEF_T2T_FAST_READ_MAX_LEN / NDEF_T2T_BLOCK_SIZE)) ||
+      ((((uint32_t)blockAddr % NDEF_T2T_BLOCKS_PER_SECTOR) + nbBlocks) > NDEF_T2T_BLOCKS_PER_SECTOR)) {
+    return ERR_PARAM;
+  }
+
+  if (subCtx.t2t.fastRead == NDEF_T2T_FAST_READ_UNSUPPORTED) {
+    return ERR_NOTSUPP;
+  }
+
+  secNo = (uint8_t)(blockAddr >> 8U);
+  blNo  = (uint8_t)blockAddr;
+  len   = (uint16_t)(nbBlocks * NDEF_T2T_BLOCK_SIZE);
+
+  ret = ndefT2TPollerSelectSector(secNo);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+
+  ret = rfal_nfc->rfalT2TPollerFastRead(blNo, (uint8_t)(blNo + (nbBlocks - 1U)), buf, len, &rcvdLen);
+
+  if ((ret == ERR_NONE) && (rcvdLen != len)) {
+    ret = ERR_PROTO;
+  }
+
+  if ((ret != ERR_NONE) && (subCtx.t2t.fastRead == NDEF_T2T_FAST_READ_UNKNOWN)) {
+    /* FAST_READ is not part of TS T2T: a tag not supporting it NACKs it and leaves the ACTIVE state.
+     * A timeout or a transmission error tells nothing: probe again on the next bulk read */
+    if (ret == ERR_NOTSUPP) {
+      ndefT2TSetFastRead(NDEF_T2T_FAST_READ_UNSUPPORTED);
+    }
+    ret = ndefT2TPollerReactivate();
+    return (ret == ERR_NONE) ? ERR_NOTSUPP : ret;
+  }
+
+  if ((ret == ERR_NONE) && (subCtx.t2t.fastRead == NDEF_T2T_FAST_READ_UNKNOWN)) {
+    ndefT2TSetFastRead(NDEF_T2T_FAST_READ_SUPPORTED);
+  }
+
+  return ret;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefT2TSetFastRead(uint8_t fastRead)
+{
+  ndefT2TProfileEntry *entry;
+
+  /* Probe result: remembered along with the model profile of the tag */
+  subCtx.t2t.fastRead = fastRead;
+  entry = (ndefT2TProfileEntry *)ndefUidCacheFind(&t2tProfileCache, device.dev.nfca.nfcId1, device.dev.nfca.nfcId1Len);
+  if (entry != NULL) {
+    entry->fastRead = fastRead;
+  }
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TPollerSelectSector(uint8_t secNo)
+{
+  /* The RFAL keeps track of the sector selected on the activated device: only switch when needed */
+  if (secNo == rfal_nfc->rfalT2TPollerGetSector()) {
+    return ERR_NONE;
+  }
+
+  return rfal_nfc->rfalT2TPollerSectorSelect(secNo);
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TPollerReactivate()
+{
+  ReturnCode           ret;
+  rfalNfcaSensRes      sensRes;
+  rfalNfcaSelRes       selRes;
+
+  /* WUPA brings the tag back from IDLE or HALT, the SELECT puts it back in sector 0 */
+  ret = rfal_nfc->rfalNfcaPollerCheckPresence(RFAL_14443A_SHORTFRAME_CMD_WUPA, &sensRes);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+
+  return rfal_nfc->rfalNfcaPollerSelect(device.dev.nfca.nfcId1, device.dev.nfca.nfcId1Len, &selRes);
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TPollerIdentify()
+{
+  ReturnCode           ret;
+  rfalT2TVersion       version;
+  ndefT2TProfileEntry *entry;
+  uint8_t              tries = 0U;
+
+  if (!t2tIdentify) {
+    return ERR_NONE;
+  }
+
+  /* Tag seen before: no need to probe it again, unless it left the last probes unanswered */
+  entry = (ndefT2TProfileEntry *)ndefUidCacheFind(&t2tProfileCache, device.dev.nfca.nfcId1, device.dev.nfca.nfcId1Len);
+  if (entry != NULL) {
+    subCtx.t2t.profile  = entry->profile;
+    subCtx.t2t.fastRead = entry->fastRead;
+    if ((entry->tries == 0U) || (entry->tries >= NDEF_T2T_IDENTIFY_MAX_TRIES)) {
+      return ERR_NONE;
+    }
+    tries = entry->tries;
+  }
+
+  ret = rfal_nfc->rfalT2TPollerGetVersion(&version);
+  if (ret == ERR_NONE) {
+    tries              = 0U;
+    subCtx.t2t.profile = ndefT2TFindProfile(&version);
+    if (subCtx.t2t.profile != NULL) {
+      subCtx.t2t.fastRead = subCtx.t2t.profile->fastRead ? NDEF_T2T_FAST_READ_SUPPORTED : NDEF_T2T_FAST_READ_UNSUPPORTED;
+    }
+  } else {
+    /* The tag left the ACTIVE state. If it can't be brought back, the
+     * following reads report it: the area is sized from the CC anyway */
+    (void)ndefT2TPollerReactivate();
+    if (ret == ERR_NOTSUPP) {
+      /* No GET_VERSION (e.g. MIFARE Ultralight/Ultralight C, other vendors) means no FAST_READ either */
+      tries               = 0U;
+      subCtx.t2t.fastRead = NDEF_T2T_FAST_READ_UNSUPPORTED;
+    } else {
+      /* Timeout or transmission error: probe again on the next taps, up to NDEF_T2T_IDENTIFY_MAX_TRIES
+       * times, then keep the tag as an unknown model (FAST_READ support is probed by the reads) */
+      tries++;
+    }
+  }
+
+  /* A version response or a NACK identifies the tag for good, otherwise the unanswered probe is counted */
+  entry = (ndefT2TProfileEntry *)ndefUidCacheStore(&t2tProfileCache, device.dev.nfca.nfcId1, device.dev.nfca.nfcId1Len);
+  if (entry != NULL) {
+    entry->profile  = subCtx.t2t.profile;
+    entry->fastRead = subCtx.t2t.fastRead;
+    entry->tries    = tries;
+  }
+
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+const ndefT2TProfile *NdefClass::ndefT2TFindProfile(const rfalT2TVersion *version)
+{
+  uint32_t             i;
+
+  if (version->vendorId != NDEF_T2T_VENDOR_ID_NXP) {
+    return NULL;
+  }
+  for (i = 0U; i < (sizeof(ndefT2TProfiles) / sizeof(ndefT2TProfiles[0])); i++) {
+    if ((ndefT2TProfiles[i].productType == version->productType) && (ndefT2TProfiles[i].productSubtype == version->productSubtype) &&
+        (ndefT2TProfiles[i].storageSize == version->storageSize)) {
+      return &ndefT2TProfiles[i];
+    }
+  }
+  return NULL;
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT2TPollerReadBytes(uint32_t offset, uint32_t len, uint8_t *buf, uint32_t *rcvdLen)
 {
   ReturnCode           ret;
-  uint8_t              le;
-  uint32_t             lvOffset = offset;
-  uint32_t             lvLen    = len;
-  uint8_t             *lvBuf    = buf;
-  uint16_t             blockAddr;
-  uint8_t              byteNo;
+  uint32_t             curSecNo;
+  uint32_t             split;
 
-  if (!ndefT2TisT2TDevice(&device) || (lvLen == 0U) || (offset > NDEF_T2T_MAX_OFFSET)) {
+  if (!ndefT2TisT2TDevice(&device) || (len == 0U) || (offset > NDEF_T2T_MAX_OFFSET)) {
     return ERR_PARAM;
   }
 
-  if ((offset >= subCtx.t2t.cacheAddr) && (offset < (subCtx.t2t.cacheAddr + NDEF_T2T_READ_RESP_SIZE)) && ((offset + len) < (subCtx.t2t.cacheAddr + NDEF_T2T_READ_RESP_SIZE))) {
-    /* data in cache buffer */
-    (void)ST_MEMCPY(lvBuf, &subCtx.t2t.cacheBuf[offset - subCtx.t2t.cacheAddr], len);
+  /* Pending writes first */
+  ret = ndefT2TWriteBackFlush();
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+
+  /* When the range spans several sectors and the currently selected one is not the first,
+   * read from the current sector onwards first: this saves switching back and forth */
+  curSecNo = rfal_nfc->rfalT2TPollerGetSector();
+  if ((curSecNo > (offset / NDEF_T2T_BYTES_PER_SECTOR)) && (curSecNo <= ((offset + len - 1U) / NDEF_T2T_BYTES_PER_SECTOR))) {
+    split = (curSecNo * NDEF_T2T_BYTES_PER_SECTOR) - offset;
+    ret = ndefT2TPollerReadRange(offset + split, len - split, &buf[split]);
+    if (ret == ERR_NONE) {
+      ret = ndefT2TPollerReadRange(offset, split, buf);
+    }
   } else {
-    do {
-      blockAddr = (uint16_t)(lvOffset / NDEF_T2T_BLOCK_SIZE);
-      byteNo    = (uint8_t)(lvOffset % NDEF_T2T_BLOCK_SIZE);
-      le = (lvLen < NDEF_T2T_READ_RESP_SIZE) ? (uint8_t)lvLen : (uint8_t)NDEF_T2T_READ_RESP_SIZE;
-
-      if ((byteNo != 0U) || (lvLen < NDEF_T2T_READ_RESP_SIZE)) {
-        ret = ndefT2TPollerReadBlock(blockAddr, subCtx.t2t.cacheBuf);
-        if (ret != ERR_NONE) {
-          ndefT2TInvalidateCache();
-          return ret;
-        }
-        subCtx.t2t.cacheAddr = (uint32_t)blockAddr * NDEF_T2T_BLOCK_SIZE;
-        if ((NDEF_T2T_READ_RESP_SIZE - byteNo) < le) {
-          le = NDEF_T2T_READ_RESP_SIZE - byteNo;
-        }
-        if (le > 0U) {
-          (void)ST_MEMCPY(lvBuf, &subCtx.t2t.cacheBuf[byteNo], le);
+    ret = ndefT2TPollerReadRange(offset, len, buf);
+  }
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+
+  if (rcvdLen != NULL) {
+    *rcvdLen = len;
+  }
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TPollerReadRange(uint32_t offset, uint32_t len, uint8_t *buf)
+{
+  ReturnCode           ret;
+  uint32_t             le;
+  uint32_t             lvOffset = offset;
+  uint32_t             lvLen    = len;
+  uint8_t             *lvBuf    = buf;
+  const uint8_t       *data;
+  uint8_t              avail;
+  bool                 sequential;
+  bool                 bulk     = true;
+  uint32_t             nbBlocks;
+
+  do {
+    data = ndefT2TCacheLookup(lvOffset, &avail);
+    if (data == NULL) {
+      /* Bulk read straight into buf when more than a READ response is needed */
+      nbBlocks = bulk ? ndefT2TFastReadBlocksCount(lvOffset, lvLen) : 0U;
+      if (nbBlocks != 0U) {
+        ret = ndefT2TPollerFastReadBlocks((uint16_t)(lvOffset / NDEF_T2T_BLOCK_SIZE), (uint16_t)nbBlocks, lvBuf);
+        if (ret == ERR_NONE) {
+          le        = nbBlocks * NDEF_T2T_BLOCK_SIZE;
+          lvBuf     = &lvBuf[le];
+          lvOffset += le;
+          lvLen    -= le;
+          continue;
         }
-      } else {
-        ret = ndefT2TPollerReadBlock(blockAddr, lvBuf);
-        if (ret != ERR_NONE) {
+        if (ret != ERR_NOTSUPP) {
+          ndefT2TPollerInvalidateCache();
           return ret;
         }
-        if (lvLen == le) {
-          /* cache the last read block */
-          (void)ST_MEMCPY(&subCtx.t2t.cacheBuf[0], lvBuf, NDEF_T2T_READ_RESP_SIZE);
-          subCtx.t2t.cacheAddr = (uint32_t)blockAddr * NDEF_T2T_BLOCK_SIZE;
-        }
+        /* FAST_READ probe failed: READ the rest of the range */
+        bulk = false;
       }
-      lvBuf     = &lvBuf[le];
-      lvOffset += le;
-      lvLen    -= le;
 
-    } while (lvLen != 0U);
+      /* Cache miss: fetch the READ response starting at the block holding lvOffset */
+      sequential = (lvOffset == subCtx.t2t.cacheEnd);
+      ret = ndefT2TCacheFill((uint16_t)(lvOffset / NDEF_T2T_BLOCK_SIZE));
+      if (ret != ERR_NONE) {
+        return ret;
+      }
+      data = ndefT2TCacheLookup(lvOffset, &avail);
+      if (data == NULL) {
+        return ERR_SYSTEM;
+      }
+      if (sequential && (lvLen < avail)) {
+        /* Small reads walking forward (e.g. TLV parsing): prefetch the following windows */
+        ndefT2TCachePrefetch(subCtx.t2t.cacheEnd, NDEF_T2T_CACHE_READ_AHEAD);
+      }
+    }
+    le = (lvLen < avail) ? lvLen : avail;
+    (void)ST_MEMCPY(lvBuf, data, le);
+    lvBuf     = &lvBuf[le];
+    lvOffset += le;
+    lvLen    -= le;
+
+  } while (lvLen != 0U);
+
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefT2TPollerInvalidateCache()
+{
+  uint8_t              i;
+
+  for (i = 0U; i < NDEF_T2T_CACHE_WINDOWS; i++) {
+    subCtx.t2t.cache[i].len = 0U;
+  }
+  subCtx.t2t.cacheNext = 0U;
+  subCtx.t2t.cacheEnd  = 0xFFFFFFFFU;
+}
+
+/*******************************************************************************/
+const uint8_t *NdefClass::ndefT2TCacheLookup(uint32_t offset, uint8_t *avail)
+{
+  uint8_t              i;
+  ndefT2TCacheWindow  *window;
+
+  for (i = 0U; i < NDEF_T2T_CACHE_WINDOWS; i++) {
+    window = &subCtx.t2t.cache[i];
+    if ((window->len != 0U) && (offset >= window->addr) && (offset < (window->addr + window->len))) {
+      *avail = (uint8_t)((window->addr + window->len) - offset);
+      return &window->buf[offset - window->addr];
+    }
   }
+  return NULL;
+}
 
-  if (rcvdLen != NULL) {
-    *rcvdLen = len;
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TCacheFill(uint16_t blockAddr)
+{
+  ReturnCode           ret;
+  ndefT2TCacheWindow  *window;
+  uint32_t             addr;
+  uint32_t             toSectorEnd;
+
+  window = &subCtx.t2t.cache[subCtx.t2t.cacheNext];
+  subCtx.t2t.cacheNext = (uint8_t)((subCtx.t2t.cacheNext + 1U) % NDEF_T2T_CACHE_WINDOWS);
+
+  window->len = 0U;
+  ret = ndefT2TPollerReadBlock(blockAddr, window->buf);
+  if (ret != ERR_NONE) {
+    ndefT2TPollerInvalidateCache();
+    return ret;
+  }
+
+  /* READ rolls over at the end of the sector: only keep the bytes belonging to it */
+  addr        = (uint32_t)blockAddr * NDEF_T2T_BLOCK_SIZE;
+  toSectorEnd = NDEF_T2T_BYTES_PER_SECTOR - (addr % NDEF_T2T_BYTES_PER_SECTOR);
+  window->addr = addr;
+  window->len  = (toSectorEnd < NDEF_T2T_READ_RESP_SIZE) ? (uint8_t)toSectorEnd : (uint8_t)NDEF_T2T_READ_RESP_SIZE;
+  subCtx.t2t.cacheEnd = addr + window->len;
+
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TCacheFillWindows(uint16_t blockAddr, uint8_t nbWindows)
+{
+  ReturnCode           ret;
+  uint8_t              buf[NDEF_T2T_CACHE_WINDOWS * NDEF_T2T_READ_RESP_SIZE];
+  ndefT2TCacheWindow  *window;
+  uint32_t             addr;
+  uint32_t             end;
+  uint32_t             len;
+  uint32_t             pos;
+  uint32_t             nbBlocks;
+
+  /* Refill nbWindows cache windows with a single FAST_READ when possible, fill one with a READ otherwise.
+   * A message write does not fetch beyond the end of the message */
+  addr = (uint32_t)blockAddr * NDEF_T2T_BLOCK_SIZE;
+  end  = NDEF_T2T_AREA_OFFSET + areaLen;
+  if (subCtx.t2t.writeBack) {
+    end = MIN(end, ((subCtx.t2t.writeEnd + NDEF_T2T_BLOCK_SIZE - 1U) / NDEF_T2T_BLOCK_SIZE) * NDEF_T2T_BLOCK_SIZE);
+  }
+  len = (addr < end) ? MIN(MIN((uint32_t)sizeof(buf), (uint32_t)nbWindows * NDEF_T2T_READ_RESP_SIZE), end - addr) : 0U;
+  nbBlocks = ndefT2TFastReadBlocksCount(addr, len);
+  if (nbBlocks == 0U) {
+    return ndefT2TCacheFill(blockAddr);
+  }
+  ret = ndefT2TPollerFastReadBlocks(blockAddr, (uint16_t)nbBlocks, buf);
+  if (ret == ERR_NOTSUPP) {
+    return ndefT2TCacheFill(blockAddr);
+  }
+  if (ret != ERR_NONE) {
+    ndefT2TPollerInvalidateCache();
+    return ret;
+  }
+
+  len = nbBlocks * NDEF_T2T_BLOCK_SIZE;
+  for (pos = 0U; pos < len; pos += NDEF_T2T_READ_RESP_SIZE) {
+    window = &subCtx.t2t.cache[subCtx.t2t.cacheNext];
+    subCtx.t2t.cacheNext = (uint8_t)((subCtx.t2t.cacheNext + 1U) % NDEF_T2T_CACHE_WINDOWS);
+    window->addr = addr + pos;
+    window->len  = (uint8_t)MIN(len - pos, NDEF_T2T_READ_RESP_SIZE);
+    (void)ST_MEMCPY(window->buf, &buf[pos], window->len);
   }
+  subCtx.t2t.cacheEnd = addr + len;
+
   return ERR_NONE;
 }
 
+/*******************************************************************************/
+void NdefClass::ndefT2TCachePrefetch(uint32_t offset, uint8_t nbWindows)
+{
+  uint8_t              i = 0U;
+  uint8_t              max;
+  uint32_t             lvOffset = offset;
+  uint8_t              avail;
+
+  /* Never replace the window the caller is reading from */
+  max = (uint8_t)MIN(nbWindows, (NDEF_T2T_CACHE_WINDOWS - 1U));
+
+  /* Stay within the T2T area and the current sector: a READ beyond the tag memory is NAKed.
+   * The missing windows are fetched with a single FAST_READ when the tag supports it */
+  while (i < max) {
+    if ((lvOffset >= (NDEF_T2T_AREA_OFFSET + areaLen)) || ((lvOffset / NDEF_T2T_BYTES_PER_SECTOR) != rfal_nfc->rfalT2TPollerGetSector())) {
+      break;
+    }
+    if (ndefT2TCacheLookup(lvOffset, &avail) != NULL) {
+      lvOffset += avail;
+      i++;
+      continue;
+    }
+    if (ndefT2TCacheFillWindows((uint16_t)(lvOffset / NDEF_T2T_BLOCK_SIZE), (uint8_t)(max - i)) != ERR_NONE) {
+      break;
+    }
+    i        = (uint8_t)(i + ((subCtx.t2t.cacheEnd - lvOffset + NDEF_T2T_READ_RESP_SIZE - 1U) / NDEF_T2T_READ_RESP_SIZE));
+    lvOffset = subCtx.t2t.cacheEnd;
+  }
+}
+
+/*******************************************************************************/
+uint32_t NdefClass::ndefT2TFastReadBlocksCount(uint32_t offset, uint32_t len)
+{
+  uint32_t             nbBlocks;
+  uint32_t             maxBlocks;
+
+  /* FAST_READ only within the T2T area (a range beyond the tag memory is NACKed) and the current sector */
+  if ((NDEF_T2T_FAST_READ_MAX_LEN < (2U * NDEF_T2T_READ_RESP_SIZE)) || (subCtx.t2t.fastRead == NDEF_T2T_FAST_READ_UNSUPPORTED) ||
+      ((offset % NDEF_T2T_BLOCK_SIZE) != 0U) || (len <= NDEF_T2T_READ_RESP_SIZE) || ((offset + len) > (NDEF_T2T_AREA_OFFSET + areaLen))) {
+    return 0U;
+  }
+
+  nbBlocks  = len / NDEF_T2T_BLOCK_SIZE;
+  maxBlocks = NDEF_T2T_BLOCKS_PER_SECTOR - ((offset / NDEF_T2T_BLOCK_SIZE) % NDEF_T2T_BLOCKS_PER_SECTOR);
+  nbBlocks  = MIN(nbBlocks, maxBlocks);
+  nbBlocks  = MIN(nbBlocks, (NDEF_T2T_FAST_READ_MAX_LEN / NDEF_T2T_BLOCK_SIZE));
+  if (subCtx.t2t.profile != NULL) {
+    nbBlocks = MIN(nbBlocks, subCtx.t2t.profile->maxReadBlocks);
+  }
+
+  /* Not worth it if a single READ does the same */
+  return ((nbBlocks * NDEF_T2T_BLOCK_SIZE) > NDEF_T2T_READ_RESP_SIZE) ? nbBlocks : 0U;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefT2TCacheUpdate(uint16_t blockAddr, const uint8_t *buf)
+{
+  uint8_t              i;
+  ndefT2TCacheWindow  *window;
+  uint32_t             addr = (uint32_t)blockAddr * NDEF_T2T_BLOCK_SIZE;
+
+  for (i = 0U; i < NDEF_T2T_CACHE_WINDOWS; i++) {
+    window = &subCtx.t2t.cache[i];
+    if ((window->len == 0U) || (addr < window->addr) || (addr >= (window->addr + window->len))) {
+      continue;
+    }
+    if (addr < NDEF_T2T_AREA_OFFSET) {
+      /* Lock and CC bytes are OTP: the tag ORs the written value, drop the window */
+      window->len = 0U;
+    } else {
+      (void)ST_MEMCPY(&window->buf[addr - window->addr], buf, NDEF_T2T_BLOCK_SIZE);
+    }
+  }
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT2TPollerContextInitialization(rfalNfcDevice *dev)
 {
@@ -223,20 +622,22 @@ ReturnCode NdefClass::ndefT2TPollerContextInitialization(rfalNfcDevice *dev)
   (void)ST_MEMCPY(&device, dev, sizeof(device));
 
   state                   = NDEF_STATE_INVALID;
-  subCtx.t2t.currentSecNo = 0U;
-  ndefT2TInvalidateCache();
-
-  return ERR_NONE;
+  areaLen                 = 0U;
+  subCtx.t2t.fastRead     = NDEF_T2T_FAST_READ_UNKNOWN;
+  subCtx.t2t.profile      = NULL;
+  ndefT2TPollerInvalidateCache();
+  ndefT2TWriteBackDrop();
+
+  /* Pick the read strategy from the tag model */
+  return ndefT2TPollerIdentify();
 }
 
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT2TPollerNdefDetect(ndefInfo *info)
 {
   ReturnCode           ret;
-  uint8_t              data[2];
-  uint32_t             offset;
-  uint16_t             lenTLV;
-  uint8_t              typeTLV;
+  ndefTlvScanner       scan;
+  ndefTlv              tlv;
 
   if (info != NULL) {
     info->state                = NDEF_STATE_INVALID;
@@ -252,6 +653,7 @@ ReturnCode NdefClass::ndefT2TPollerNdefDetect(ndefInfo *info)
   }
 
   state = NDEF_STATE_INVALID;
+  ndefT2TWriteBackDrop();
 
   /* Read CC TS T2T v1.0 7.5.1.1 */
   ret = ndefT2TPollerReadBytes(NDEF_T2T_CC_OFFSET, NDEF_T2T_CC_LEN, ccBuf, NULL);
@@ -266,57 +668,48 @@ ReturnCode NdefClass::ndefT2TPollerNdefDetect(ndefInfo *info)
   cc.t2t.readAccess   = (uint8_t)(ccBuf[NDEF_T2T_CC_3] >> 4U);
   cc.t2t.writeAccess  = (uint8_t)(ccBuf[NDEF_T2T_CC_3] & 0xFU);
   areaLen = (uint32_t)cc.t2t.size * NDEF_T2T_SIZE_DIVIDER;
+  if ((subCtx.t2t.profile != NULL) && (areaLen > subCtx.t2t.profile->areaMaxLen)) {
+    /* CC claiming more than the tag memory: stay within the memory of the model */
+    areaLen = subCtx.t2t.profile->areaMaxLen;
+  }
   /* Check version number TS T2T v1.0 7.5.1.2 */
   if ((cc.t2t.magicNumber != NDEF_T2T_MAGIC) || (cc.t2t.majorVersion > ndefMajorVersion(NDEF_T2T_VERSION_1_0))) {
     /* Conclude procedure TS T2T v1.0 7.5.1.2 */
     return ERR_REQUEST;
   }
-  /* Search for NDEF message TLV TS T2T v1.0 7.5.1.3 */
-  offset = NDEF_T2T_AREA_OFFSET;
-  while ((offset < (NDEF_T2T_AREA_OFFSET + areaLen))) {
-    ret = ndefT2TPollerReadBytes(offset, 1, data, NULL);
+  /* Search for NDEF message TLV TS T2T v1.0 7.5.1.3. The read cache already keeps whole READ/FAST_READ
+   * responses: refilling the scanner a block at a time serves it from there without reading past the TLVs */
+  ndefTlvScanInit(&scan, NDEF_T2T_AREA_OFFSET, NDEF_T2T_AREA_OFFSET + areaLen, NDEF_T2T_BLOCK_SIZE, NDEF_T2T_BLOCK_SIZE);
+  while (true) {
+    ret = ndefTlvScanNext(&scan, &tlv);
     if (ret != ERR_NONE) {
-      /* Conclude procedure */
+      /* Conclude procedure: end of the T2T area or read error */
       return ret;
     }
-    typeTLV = data[0];
-    if (typeTLV == NDEF_T2T_TLV_NDEF_MESSAGE) {
-      subCtx.t2t.offsetNdefTLV = offset;
-    }
-    offset++;
-    if (typeTLV == NDEF_T2T_TLV_TERMINATOR) {
+    if (tlv.type == NDEF_T2T_TLV_TERMINATOR) {
       break;
     }
-    if (typeTLV == NDEF_T2T_TLV_NULL) {
-      continue;
-    }
-    /* read TLV Len */
-    ret = ndefT2TPollerReadBytes(offset, 1, data, NULL);
-    if (ret != ERR_NONE) {
-      /* Conclude procedure */
-      return ret;
-    }
-    offset++;
-    lenTLV = data[0];
-    if (lenTLV == NDEF_T2T_3_BYTES_TLV_LEN) {
-      ret = ndefT2TPollerReadBytes(offset, 2, data, NULL);
+
+    if ((tlv.type == NDEF_T2T_TLV_LOCK_CTRL) || (tlv.type == NDEF_T2T_TLV_MEMORY_CTRL)) {
+      /* Lock/reserved bytes are skipped by the following TLVs */
+      ret = ndefT2TPollerAddCtrlArea(&scan, &tlv);
       if (ret != ERR_NONE) {
-        /* Conclude procedure */
         return ret;
       }
-      offset += 2U;
-      lenTLV = GETU16(&data[0]);
-    }
-
-    if ((typeTLV == NDEF_T2T_TLV_LOCK_CTRL) || (typeTLV == NDEF_T2T_TLV_MEMORY_CTRL)) {
-      /* No support of Lock control or Memory control in this version */
-      return ERR_REQUEST;
     }
     /* NDEF message present TLV TS T2T v1.0 7.5.1.4 */
-    if (typeTLV == NDEF_T2T_TLV_NDEF_MESSAGE) {
+    if (tlv.type == NDEF_T2T_TLV_NDEF_MESSAGE) {
+      /* The NDEF TLV is accessed as a contiguous range: it must not span reserved/lock bytes */
+      if (ndefTlvScanNextReserved(&scan, tlv.offset) < (tlv.valueOffset + tlv.len)) {
+        return ERR_REQUEST;
+      }
+      /* Keep message writes clear of the reserved/lock bytes following it */
+      areaLen = ndefTlvScanNextReserved(&scan, tlv.valueOffset) - NDEF_T2T_AREA_OFFSET;
+
+      subCtx.t2t.offsetNdefTLV = tlv.offset;
       /* Read length TS T2T v1.0 7.5.1.5 */
-      messageLen    = lenTLV;
-      messageOffset = offset;
+      messageLen    = tlv.len;
+      messageOffset = tlv.valueOffset;
       if (messageLen == 0U) {
         if (!(ndefT2TIsReadWriteAccessGranted())) {
           /* Conclude procedure  */
@@ -347,11 +740,38 @@ ReturnCode NdefClass::ndefT2TPollerNdefDetect(ndefInfo *info)
       }
       return ERR_NONE;
     }
-    offset += lenTLV;
   }
   return ERR_REQUEST;
 }
 
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TPollerAddCtrlArea(ndefTlvScanner *scan, const ndefTlv *tlv)
+{
+  ReturnCode           ret;
+  uint8_t              ctrl[NDEF_T2T_TLV_CTRL_LEN];
+  uint32_t             offset = tlv->valueOffset;
+  uint32_t             size;
+  uint32_t             addr;
+
+  if (tlv->len != NDEF_T2T_TLV_CTRL_LEN) {
+    return ERR_REQUEST;
+  }
+  ret = ndefTlvScanRead(scan, &offset, ctrl, NDEF_T2T_TLV_CTRL_LEN);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+
+  /* TS T2T v1.0 4.7.2 & 4.7.3: Position (page address, byte offset), Size, Page Control (bytes per page) */
+  addr = ((uint32_t)(ctrl[0] >> 4U) << (ctrl[2] & 0x0FU)) + (uint32_t)(ctrl[0] & 0x0FU);
+  size = (ctrl[1] == 0U) ? NDEF_T2T_TLV_CTRL_MAX_SIZE : (uint32_t)ctrl[1];
+  if (tlv->type == NDEF_T2T_TLV_LOCK_CTRL) {
+    /* Size is the number of dynamic lock bits */
+    size = (size + 7U) / 8U;
+  }
+
+  return ndefTlvScanAddReserved(scan, addr, size);
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT2TPollerReadRawMessage(uint8_t *buf, uint32_t bufLen, uint32_t *rcvdLen)
 {
@@ -396,15 +816,15 @@ ReturnCode NdefClass::ndefT2TPollerWriteBlock(uint16_t blockAddr, const uint8_t
   secNo = (uint8_t)(blockAddr >> 8U);
   blNo  = (uint8_t)blockAddr;
 
-  if (secNo != subCtx.t2t.currentSecNo) {
-    ret = rfal_nfc->rfalT2TPollerSectorSelect(secNo);
-    if (ret != ERR_NONE) {
-      return ret;
-    }
-    subCtx.t2t.currentSecNo = secNo;
+  ret = ndefT2TPollerSelectSector(secNo);
+  if (ret != ERR_NONE) {
+    return ret;
   }
 
   ret = rfal_nfc->rfalT2TPollerWrite(blNo, buf);
+  if (ret == ERR_NONE) {
+    ndefT2TCacheUpdate(blockAddr, buf);
+  }
 
   return ret;
 }
@@ -412,43 +832,49 @@ ReturnCode NdefClass::ndefT2TPollerWriteBlock(uint16_t blockAddr, const uint8_t
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT2TPollerWriteBytes(uint32_t offset, const uint8_t *buf, uint32_t len)
 {
-  ReturnCode           ret;
-  uint32_t             lvOffset = offset;
-  uint32_t             lvLen    = len;
-  const uint8_t       *lvBuf    = buf;
-  uint16_t             blockAddr;
-  uint8_t              byteNo;
-  uint8_t              le;
-  uint8_t              tempBuf[NDEF_T2T_READ_RESP_SIZE];
+  ReturnCode             ret;
+  uint32_t               lvOffset = offset;
+  uint32_t               lvLen    = len;
+  const uint8_t         *lvBuf    = buf;
+  uint16_t               blockAddr;
+  uint16_t               lFieldBlockAddr;
+  uint8_t                byteNo;
+  uint8_t                le;
+  ndefT2TWriteBackBlock *wb;
 
   if (!ndefT2TisT2TDevice(&device) || (lvLen == 0U)) {
     return ERR_PARAM;
   }
 
-  ndefT2TInvalidateCache();
+  /* During a message write, the block holding the end of the L-field is only written with the final L-field */
+  lFieldBlockAddr = (uint16_t)((messageOffset - 1U) / NDEF_T2T_BLOCK_SIZE);
 
   do {
     blockAddr = (uint16_t)(lvOffset / NDEF_T2T_BLOCK_SIZE);
     byteNo    = (uint8_t)(lvOffset % NDEF_T2T_BLOCK_SIZE);
     le = (lvLen < NDEF_T2T_BLOCK_SIZE) ? (uint8_t)lvLen : (uint8_t)NDEF_T2T_BLOCK_SIZE;
-    if ((byteNo != 0U) || (lvLen < NDEF_T2T_BLOCK_SIZE)) {
-      ret = ndefT2TPollerReadBlock(blockAddr, tempBuf);
-      if (ret != ERR_NONE) {
-        return ret;
-      }
-      if ((NDEF_T2T_BLOCK_SIZE - byteNo) < le) {
-        le = NDEF_T2T_BLOCK_SIZE - byteNo;
-      }
-      if (le > 0U) {
-        (void)ST_MEMCPY(&tempBuf[byteNo], lvBuf, le);
-      }
-      ret = ndefT2TPollerWriteBlock(blockAddr, tempBuf);
+    if ((NDEF_T2T_BLOCK_SIZE - byteNo) < le) {
+      le = NDEF_T2T_BLOCK_SIZE - byteNo;
+    }
+
+    wb = (subCtx.t2t.writeBack && (blockAddr == lFieldBlockAddr)) ? &subCtx.t2t.wbLField : &subCtx.t2t.wbData;
+    if ((wb->mask != 0U) && (wb->blockAddr != blockAddr)) {
+      ret = ndefT2TWriteBackFlushBlock(wb);
       if (ret != ERR_NONE) {
+        ndefT2TWriteBackDrop();
         return ret;
       }
-    } else {
-      ret = ndefT2TPollerWriteBlock(blockAddr, lvBuf);
+    }
+
+    /* Merge into the pending block: partially written blocks are completed by the next writes */
+    (void)ST_MEMCPY(&wb->buf[byteNo], lvBuf, le);
+    wb->blockAddr = blockAddr;
+    wb->mask     |= (uint8_t)(((1U << le) - 1U) << byteNo);
+
+    if ((wb == &subCtx.t2t.wbData) && (wb->mask == NDEF_T2T_WB_MASK_FULL)) {
+      ret = ndefT2TWriteBackFlushBlock(wb);
       if (ret != ERR_NONE) {
+        ndefT2TWriteBackDrop();
         return ret;
       }
     }
@@ -458,9 +884,75 @@ ReturnCode NdefClass::ndefT2TPollerWriteBytes(uint32_t offset, const uint8_t *bu
 
   } while (lvLen != 0U);
 
+  if (!subCtx.t2t.writeBack) {
+    ret = ndefT2TWriteBackFlush();
+    if (ret != ERR_NONE) {
+      return ret;
+    }
+  }
+
   return ERR_NONE;
 }
 
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TWriteBackFlushBlock(ndefT2TWriteBackBlock *wb)
+{
+  ReturnCode           ret;
+  const uint8_t       *data;
+  uint8_t              avail;
+  uint8_t              mask;
+  uint8_t              i;
+
+  mask     = wb->mask;
+  wb->mask = 0U;
+  if (mask == 0U) {
+    return ERR_NONE;
+  }
+
+  if ((mask != NDEF_T2T_WB_MASK_FULL) || differentialWrite) {
+    /* Read-modify-write: take the bytes not written from the cache. Differential
+     * writes compare the following blocks too: fetch them all at once */
+    data = ndefT2TCacheLookup((uint32_t)wb->blockAddr * NDEF_T2T_BLOCK_SIZE, &avail);
+    if (data == NULL) {
+      ret = differentialWrite ? ndefT2TCacheFillWindows(wb->blockAddr, NDEF_T2T_CACHE_WINDOWS) : ndefT2TCacheFill(wb->blockAddr);
+      if (ret != ERR_NONE) {
+        return ret;
+      }
+      data = ndefT2TCacheLookup((uint32_t)wb->blockAddr * NDEF_T2T_BLOCK_SIZE, &avail);
+      if (data == NULL) {
+        return ERR_SYSTEM;
+      }
+    }
+    for (i = 0U; i < NDEF_T2T_BLOCK_SIZE; i++) {
+      if ((mask & (1U << i)) == 0U) {
+        wb->buf[i] = data[i];
+      }
+    }
+    if (differentialWrite && (ST_BYTECMP(wb->buf, data, NDEF_T2T_BLOCK_SIZE) == 0)) {
+      /* Block content unchanged */
+      return ERR_NONE;
+    }
+  }
+
+  return ndefT2TPollerWriteBlock(wb->blockAddr, wb->buf);
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT2TWriteBackFlush()
+{
+  ReturnCode           ret;
+
+  /* Message data first, L-field last */
+  ret = ndefT2TWriteBackFlushBlock(&subCtx.t2t.wbData);
+  if (ret == ERR_NONE) {
+    ret = ndefT2TWriteBackFlushBlock(&subCtx.t2t.wbLField);
+  }
+  if (ret != ERR_NONE) {
+    ndefT2TWriteBackDrop();
+  }
+  return ret;
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT2TPollerWriteRawMessageLen(uint32_t rawMessageLen)
 {
@@ -482,6 +974,8 @@ ReturnCode NdefClass::ndefT2TPollerWriteRawMessageLen(uint32_t rawMessageLen)
     buf[dataIt] = (uint8_t) rawMessageLen;
     dataIt++;
   } else {
+    buf[dataIt] = NDEF_T2T_3_BYTES_TLV_LEN;
+    dataIt++;
     buf[dataIt] = (uint8_t)(rawMessageLen >> 8U);
     dataIt++;
     buf[dataIt] = (uint8_t) rawMessageLen;
@@ -501,6 +995,11 @@ ReturnCode NdefClass::ndefT2TPollerWriteRawMessageLen(uint32_t rawMessageLen)
     (void)ndefT2TPollerWriteBytes(messageOffset + rawMessageLen, buf, dataIt);
   }
 
+  if (ret == ERR_NONE) {
+    /* L-field written last, together with the pending message data */
+    ret = ndefT2TWriteBackFlush();
+  }
+
   return ret;
 }
 
@@ -572,6 +1071,8 @@ ReturnCode NdefClass::ndefT2TPollerTagFormat(const ndefCapabilityContainer *cc_p
     return ERR_PARAM;
   }
 
+  ndefT2TWriteBackDrop();
+
   /*
    * Read CC area
    */
@@ -580,7 +1081,7 @@ ReturnCode NdefClass::ndefT2TPollerTagFormat(const ndefCapabilityContainer *cc_p
     return ret;
   }
 
-  ndefT2TInvalidateCache();
+  ndefT2TPollerInvalidateCache();
 
   /*
    * Write CC only in case of virgin CC area
@@ -632,13 +1133,9 @@ ReturnCode NdefClass::ndefT2TPollerCheckPresence()
   }
 
   blockAddr = 0U;
-  ret = ndefT2TPollerReadBlock(blockAddr, subCtx.t2t.cacheBuf);
-  if (ret != ERR_NONE) {
-    ndefT2TInvalidateCache();
-    return ret;
-  }
-  subCtx.t2t.cacheAddr = (uint32_t)blockAddr * NDEF_T2T_BLOCK_SIZE;
-  return ERR_NONE;
+  ret = ndefT2TCacheFill(blockAddr);
+
+  return ret;
 }
 
 /*******************************************************************************/
@@ -677,6 +1174,7 @@ ReturnCode NdefClass::ndefT2TPollerBeginWriteMessage(uint32_t messageLen)
   }
 
   /* TS T2T v1.0 7.5.3.4: reset L_Field to 0 */
+  ndefT2TWriteBackDrop();
   ret = ndefT2TPollerWriteRawMessageLen(0U);
   if (ret != ERR_NONE) {
     /* Conclude procedure */
@@ -689,6 +1187,10 @@ ReturnCode NdefClass::ndefT2TPollerBeginWriteMessage(uint32_t messageLen)
   messageOffset += NDEF_T2T_TLV_T_LEN; /* T Len */
   messageOffset += lLen;               /* L Len */
 
+  /* Buffer the message writes until ndefT2TPollerEndWriteMessage() */
+  subCtx.t2t.writeBack = true;
+  subCtx.t2t.writeEnd  = messageOffset + messageLen;
+
   state = NDEF_STATE_INITIALIZED;
 
   return ERR_NONE;
@@ -709,6 +1211,7 @@ ReturnCode NdefClass::ndefT2TPollerEndWriteMessage(uint32_t messageLen)
 
   /* TS T2T v1.0 7.5.3.6 & 7.5.3.7: update L_Field and write Terminator TLV */
   ret = ndefT2TPollerWriteRawMessageLen(messageLen);
+  subCtx.t2t.writeBack = false;
   if (ret != ERR_NONE) {
     /* Conclude procedure */
     state = NDEF_STATE_INVALID;
@@ -54,7 +54,12 @@
 #define NDEF_T3T_WRITEFLAG_OFF              0x0U /*!< WriteFlag OFF value TS T3T 1.0 7.2.2.16            */
 #define NDEF_T3T_AREA_OFFSET                 16U /*!< T3T Area starts at block #1                        */
 #define NDEF_T3T_BLOCKLEN                    16U /*!< T3T block len is always 16                         */
-#define NDEF_T3T_NBBLOCKSMAX                  4U /*!< T3T max nb of blocks per read/write                */
+#define NDEF_T3T_NBBLOCKSMAX                  4U /*!< T3T nb of blocks per read/write until AIB is read  */
+#define NDEF_T3T_CHECK_MAX_BLOCKS            15U /*!< T3T max nb of blocks per CHECK T3T 1.0 5.4.1.10    */
+#define NDEF_T3T_UPDATE_MAX_BLOCKS           13U /*!< T3T max nb of blocks per UPDATE T3T 1.0 5.4.1.10   */
+#define NDEF_T3T_UPDATE_MAX_BLOCKS_3B        12U /*!< T3T UPDATE max nb of blocks w/ 3 bytes elements    */
+#define NDEF_T3T_SERVICE_CODE_READ       0x000BU /*!< T3T NDEF service code for CHECK                    */
+#define NDEF_T3T_SERVICE_CODE_WRITE      0x0009U /*!< T3T NDEF service code for UPDATE                   */
 #define NDEF_T3T_FLAG_RW                      1U /*!< T3T read/write flag value                          */
 #define NDEF_T3T_FLAG_RO                      0U /*!< T3T read only flag value                           */
 #define NDEF_T3T_SENSFRES_NFCID2              2U /*!< T3T offset of UID in SENSFRES struct               */
@@ -70,6 +75,8 @@
 #define NDEF_T3T_ATTRIB_INFO_BLOCK_NB         0U /*!< T3T attribute info block number                    */
 #define NDEF_T3T_BLOCKNB_CONF              0x80U /*!< T3T TxRx config value for Read/Write block         */
 #define NDEF_T3T_CHECK_NB_BLOCKS_LEN          1U /*!< T3T Length of the Nb of blocks in the CHECK reply  */
+#define NDEF_T3T_CHECK_RES_HEADER_LEN        12U /*!< T3T CHECK reply LEN, cmd, NFCID2, ST1 and ST2 len  */
+#define NDEF_T3T_BLOCKNB_2B_MAX            0xFFU /*!< T3T highest block nb of a 2 bytes list element     */
 
 /*
  ******************************************************************************
@@ -85,6 +92,7 @@
 
 #define ndefT3TisT3TDevice(device) ((device)->type == RFAL_NFC_LISTEN_TYPE_NFCF)
 #define ndefT3TIsWriteFlagON(writeFlag) ((writeFlag) == NDEF_T3T_WRITEFLAG_ON)
+#define ndefT3TClampNbBlocks(nb, max) (((nb) == 0U) ? 1U : (((nb) > (max)) ? (max) : (nb)))
 
 /*
  ******************************************************************************
@@ -105,16 +113,40 @@
  ******************************************************************************
  */
 
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT3TPollerSetBlockList(rfalNfcfServBlockListParam *servBlock, rfalNfcfServ *serviceCode, uint16_t blockNum, uint8_t nbBlocks)
+{
+  rfalNfcfBlockListElem *listBlocks;
+  uint8_t                index;
+
+  if ((nbBlocks == 0U) || (nbBlocks > NDEF_T3T_MAX_NB_BLOCKS)) {
+    return ERR_PARAM;
+  }
+
+  listBlocks = subCtx.t3t.listBlocks;
+
+  for (index = 0U; index < nbBlocks; index++) {
+    /* Write each block number (16 bits per block address) */
+    listBlocks[index].blockNum = (uint16_t)(blockNum + (uint16_t) index);
+    listBlocks[index].conf     = (listBlocks[index].blockNum > NDEF_T3T_BLOCKNB_2B_MAX) ? 0U /* 3 bytes element */ : (uint8_t) NDEF_T3T_BLOCKNB_CONF;
+  }
+
+  servBlock->numServ   = 1U;
+  servBlock->servList  = serviceCode;
+  servBlock->numBlock  = nbBlocks;
+  servBlock->blockList = listBlocks;
+
+  return ERR_NONE;
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT3TPollerReadBlocks(uint16_t blockNum, uint8_t nbBlocks, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen)
 {
   ReturnCode                 ret;
   uint16_t                   requestedDataSize;
   rfalNfcfServBlockListParam servBlock;
-  rfalNfcfBlockListElem     *listBlocks;
-  uint8_t                    index;
   uint16_t                   rcvdLen = 0U;
-  rfalNfcfServ               serviceCodeLst = 0x000BU; /* serviceCodeLst */
+  rfalNfcfServ               serviceCodeLst = NDEF_T3T_SERVICE_CODE_READ; /* serviceCodeLst */
 
   if (!ndefT3TisT3TDevice(&device)) {
     return ERR_PARAM;
@@ -125,19 +157,11 @@ ReturnCode NdefClass::ndefT3TPollerReadBlocks(uint16_t blockNum, uint8_t nbBlock
     return ERR_PARAM;
   }
 
-  listBlocks = subCtx.t3t.listBlocks;
-
-  for (index = 0U; index < nbBlocks; index++) {
-    /* Write each block number (16 bits per block address) */
-    listBlocks[index].conf     = (uint8_t) NDEF_T3T_BLOCKNB_CONF;
-    listBlocks[index].blockNum = (uint16_t)(blockNum + (uint16_t) index);
+  ret = ndefT3TPollerSetBlockList(&servBlock, &serviceCodeLst, blockNum, nbBlocks);
+  if (ret != ERR_NONE) {
+    return ret;
   }
 
-  servBlock.numServ   = 1U;
-  servBlock.servList  = &serviceCodeLst;
-  servBlock.numBlock  = nbBlocks;
-  servBlock.blockList = listBlocks;
-
   ret = rfal_nfc->rfalNfcfPollerCheck(device.dev.nfcf.sensfRes.NFCID2, &servBlock, subCtx.t3t.rxbuf, (uint16_t)sizeof(subCtx.t3t.rxbuf), &rcvdLen);
   if (ret != ERR_NONE) {
     return ret;
@@ -154,11 +178,53 @@ ReturnCode NdefClass::ndefT3TPollerReadBlocks(uint16_t blockNum, uint8_t nbBlock
   return ERR_NONE;
 }
 
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT3TPollerReadBlocksInPlace(uint16_t blockNum, uint8_t nbBlocks, uint8_t *buf, uint16_t bufLen, uint16_t *rcvLen)
+{
+  ReturnCode                 ret;
+  uint16_t                   requestedDataSize;
+  rfalNfcfServBlockListParam servBlock;
+  uint16_t                   rcvdLen = 0U;
+  uint8_t                    prevByte;
+  uint8_t                   *rxBuf;
+  rfalNfcfServ               serviceCodeLst = NDEF_T3T_SERVICE_CODE_READ;
+
+  /* The CHECK reply is received one byte before buf: once its header is removed the
+   * Nb of blocks lands on buf[-1] (restored afterwards) and the block data on buf.
+   * bufLen must leave room for the header received after the data before removal  */
+  if (!ndefT3TisT3TDevice(&device) || (buf == NULL)) {
+    return ERR_PARAM;
+  }
+
+  requestedDataSize = (uint16_t)nbBlocks * NDEF_T3T_BLOCK_SIZE;
+  if (bufLen < (requestedDataSize + NDEF_T3T_CHECK_RES_HEADER_LEN)) {
+    return ERR_PARAM;
+  }
+
+  ret = ndefT3TPollerSetBlockList(&servBlock, &serviceCodeLst, blockNum, nbBlocks);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+
+  rxBuf    = buf - NDEF_T3T_CHECK_NB_BLOCKS_LEN;
+  prevByte = rxBuf[0];
+  ret      = rfal_nfc->rfalNfcfPollerCheck(device.dev.nfcf.sensfRes.NFCID2, &servBlock, rxBuf, (uint16_t)(bufLen + NDEF_T3T_CHECK_NB_BLOCKS_LEN), &rcvdLen);
+  if ((ret == ERR_NONE) && ((rcvdLen != (uint16_t)(NDEF_T3T_CHECK_NB_BLOCKS_LEN + requestedDataSize)) || (rxBuf[0] != nbBlocks))) {
+    ret = ERR_REQUEST;
+  }
+  rxBuf[0] = prevByte;
+  if ((ret == ERR_NONE) && (rcvLen != NULL)) {
+    *rcvLen = requestedDataSize;
+  }
+  return ret;
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT3TPollerReadBytes(uint32_t offset, uint32_t len, uint8_t *buf, uint32_t *rcvdLen)
 {
   uint16_t        res;
   uint16_t        nbRead;
+  uint16_t        chunkLen;
   ReturnCode      result     = ERR_NONE;
   uint32_t        currentLen = len;
   uint32_t        lvRcvLen   = 0U;
@@ -167,17 +233,22 @@ ReturnCode NdefClass::ndefT3TPollerReadBytes(uint32_t offset, uint32_t len, uint
   uint16_t        startAddr  = (uint16_t)(startBlock * blockLen);
   uint16_t        startOffset = (uint16_t)(offset - (uint32_t) startAddr);
   uint16_t        nbBlocks   = (uint16_t) NDEF_T3T_NBBLOCKSMAX;
+  uint8_t         tmpBuf[NDEF_T3T_BLOCKLEN];
 
   if (!ndefT3TisT3TDevice(&device) || (len == 0U)) {
     return ERR_PARAM;
   }
+  result = ndefT3TPollerConfirmAttributeInformationBlock(0U, NULL);
+  if (result != ERR_NONE) {
+    return result;
+  }
   if (state != NDEF_STATE_INVALID) {
-    nbBlocks = cc.t3t.nbR;
+    nbBlocks = ndefT3TClampNbBlocks((uint16_t)cc.t3t.nbR, NDEF_T3T_CHECK_MAX_BLOCKS);
   }
 
   if (startOffset != 0U) {
     /* Unaligned read, need to use a tmp buffer */
-    res = ndefT3TPollerReadBlocks(startBlock, 1U /* One block */, subCtx.t3t.rxbuf, blockLen, &nbRead);
+    res = ndefT3TPollerReadBlocks(startBlock, 1U /* One block */, tmpBuf, blockLen, &nbRead);
     if (res != ERR_NONE) {
       /* Check result */
       result = res;
@@ -190,7 +261,7 @@ ReturnCode NdefClass::ndefT3TPollerReadBytes(uint32_t offset, uint32_t len, uint
         nbRead = (uint16_t) currentLen;
       }
       if (nbRead > 0U) {
-        (void)ST_MEMCPY(buf, &subCtx.t3t.rxbuf[offset], (uint32_t)nbRead);
+        (void)ST_MEMCPY(buf, &tmpBuf[startOffset], (uint32_t)nbRead);
       }
       lvRcvLen   += (uint32_t) nbRead;
       currentLen -= (uint32_t) nbRead;
@@ -203,15 +274,21 @@ ReturnCode NdefClass::ndefT3TPollerReadBytes(uint32_t offset, uint32_t len, uint
       /* Reduce the nb of blocks to read */
       nbBlocks = (uint16_t)(currentLen / blockLen);
     }
-    res = ndefT3TPollerReadBlocks(startBlock, (uint8_t)nbBlocks, subCtx.t3t.rxbuf, blockLen * nbBlocks, &nbRead);
+    chunkLen = blockLen * nbBlocks;
+    if ((lvRcvLen > 0U) && ((currentLen - chunkLen) >= NDEF_T3T_CHECK_RES_HEADER_LEN)) {
+      /* Enough room around the destination: decode the reply straight into buf, the bytes
+       * following the data are overwritten by the next reads */
+      res = ndefT3TPollerReadBlocksInPlace(startBlock, (uint8_t)nbBlocks, &buf[lvRcvLen], chunkLen + NDEF_T3T_CHECK_RES_HEADER_LEN, &nbRead);
+    } else {
+      res = ndefT3TPollerReadBlocks(startBlock, (uint8_t)nbBlocks, &buf[lvRcvLen], chunkLen, &nbRead);
+    }
     if (res != ERR_NONE) {
       /* Check result */
       return res;
-    } else if (nbRead != (blockLen * nbBlocks)) {
+    } else if (nbRead != chunkLen) {
       /* Check len */
       return ERR_MEM_CORRUPT;
     } else {
-      (void)ST_MEMCPY(&buf[lvRcvLen], subCtx.t3t.rxbuf, (uint32_t)currentLen);
       lvRcvLen   += nbRead;
       currentLen -= nbRead;
       startBlock += nbBlocks;
@@ -219,7 +296,7 @@ ReturnCode NdefClass::ndefT3TPollerReadBytes(uint32_t offset, uint32_t len, uint
   }
   if ((currentLen > 0U) && (result == ERR_NONE)) {
     /* Unaligned read, need to use a tmp buffer */
-    res = ndefT3TPollerReadBlocks(startBlock, 1U /* One block */, subCtx.t3t.rxbuf, blockLen, &nbRead);
+    res = ndefT3TPollerReadBlocks(startBlock, 1U /* One block */, tmpBuf, blockLen, &nbRead);
     if (res != ERR_NONE) {
       /* Check result */
       return res;
@@ -228,7 +305,7 @@ ReturnCode NdefClass::ndefT3TPollerReadBytes(uint32_t offset, uint32_t len, uint
       return ERR_MEM_CORRUPT;
     } else {
       if (currentLen > 0U) {
-        (void)ST_MEMCPY(&buf[lvRcvLen], subCtx.t3t.rxbuf, (uint32_t)currentLen);
+        (void)ST_MEMCPY(&buf[lvRcvLen], tmpBuf, (uint32_t)currentLen);
       }
       lvRcvLen   += (uint32_t) currentLen;
       currentLen -= (uint32_t) currentLen;
@@ -248,43 +325,168 @@ ReturnCode NdefClass::ndefT3TPollerReadAttributeInformationBlock()
 {
   /* Follow 7.4.1 NDEF Detection Procedure */
   ReturnCode   retcode;
-  uint8_t     *rxbuf;
-  uint16_t     checksum_received;
-  uint16_t     checksum_computed = 0U;
   uint16_t     rcvLen            = 0U;
-  uint8_t      i;
 
   if (!ndefT3TisT3TDevice(&device)) {
     return ERR_PARAM;
   }
-  rxbuf   = ccBuf;
-  retcode = ndefT3TPollerReadBlocks(NDEF_T3T_ATTRIB_INFO_BLOCK_NB, 1U /* One block */, rxbuf, NDEF_T3T_BLOCK_SIZE, &rcvLen);
+  retcode = ndefT3TPollerReadBlocks(NDEF_T3T_ATTRIB_INFO_BLOCK_NB, 1U /* One block */, ccBuf, NDEF_T3T_BLOCK_SIZE, &rcvLen);
   if ((retcode != ERR_NONE) && (rcvLen != NDEF_T3T_BLOCK_SIZE)) {
     return retcode;
   }
+  retcode = ndefT3TPollerParseAttributeInformationBlock(ccBuf);
+  if (retcode != ERR_NONE) {
+    return retcode;
+  }
+  ndefT3TAibCacheStore(ccBuf);
+  subCtx.t3t.aibSpeculative = false;
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT3TPollerParseAttributeInformationBlock(const uint8_t *aib)
+{
+  uint16_t     checksum_received;
+  uint16_t     checksum_computed = 0U;
+  uint8_t      i;
+
   /* Now compute checksum */
   for (i = 0U; i < NDEF_T3T_ATTRIB_INFO_CHECKSUM_LEN; i++) {
-    checksum_computed += (uint16_t) rxbuf[i];
+    checksum_computed += (uint16_t) aib[i];
   }
-  checksum_received = ((uint16_t)rxbuf[NDEF_T3T_ATTRIB_INFO_CHECKSUM_LEN] << 8U) + (uint16_t)rxbuf[NDEF_T3T_ATTRIB_INFO_CHECKSUM_LEN + 1U];
+  checksum_received = ((uint16_t)aib[NDEF_T3T_ATTRIB_INFO_CHECKSUM_LEN] << 8U) + (uint16_t)aib[NDEF_T3T_ATTRIB_INFO_CHECKSUM_LEN + 1U];
   if (checksum_received !=  checksum_computed) {
     return ERR_REQUEST;
   }
 
   /* Now copy the attribute struct */
-  cc.t3t.majorVersion  = (rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_VERSION] >> 4U);
-  cc.t3t.minorVersion  = (rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_VERSION] & 0xFU);
-  cc.t3t.nbR           = rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_NBR];
-  cc.t3t.nbW           = rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_NBW];
-  cc.t3t.nMaxB         = ((uint16_t)rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_MAXB] << 8U) + (uint16_t)rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_MAXB + 1U];
-  cc.t3t.writeFlag     = rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_W];
-  cc.t3t.rwFlag        = rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_RW];
-  cc.t3t.Ln            = ((uint32_t)rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_LN + 0U] << 0x10U)
-                         | ((uint32_t)rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_LN + 1U] << 0x8U)
-                         | (uint32_t)rxbuf[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_LN + 2U];
+  cc.t3t.majorVersion  = (aib[NDEF_T3T_ATTRIB_INFO_OFFSET_VERSION] >> 4U);
+  cc.t3t.minorVersion  = (aib[NDEF_T3T_ATTRIB_INFO_OFFSET_VERSION] & 0xFU);
+  cc.t3t.nbR           = aib[NDEF_T3T_ATTRIB_INFO_OFFSET_NBR];
+  cc.t3t.nbW           = aib[NDEF_T3T_ATTRIB_INFO_OFFSET_NBW];
+  cc.t3t.nMaxB         = ((uint16_t)aib[NDEF_T3T_ATTRIB_INFO_OFFSET_MAXB] << 8U) + (uint16_t)aib[NDEF_T3T_ATTRIB_INFO_OFFSET_MAXB + 1U];
+  cc.t3t.writeFlag     = aib[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_W];
+  cc.t3t.rwFlag        = aib[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_RW];
+  cc.t3t.Ln            = ((uint32_t)aib[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_LN + 0U] << 0x10U)
+                         | ((uint32_t)aib[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_LN + 1U] << 0x8U)
+                         | (uint32_t)aib[NDEF_T3T_ATTRIB_INFO_OFFSET_FLAG_LN + 2U];
   return ERR_NONE;
 }
 
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT3TPollerApplyAttributeInformationBlock()
+{
+  /* TS T3T v1.0 7.4.1.6 The Reader/Writer SHALL check if it supports the NDEF mapping version number based on the rules given in Section 7.3. */
+  if (cc.t3t.majorVersion != ndefMajorVersion(NDEF_T3T_ATTRIB_INFO_VERSION_1_0)) {
+    return ERR_REQUEST;
+  }
+
+  messageLen     = cc.t3t.Ln;
+  messageOffset  = NDEF_T3T_AREA_OFFSET;
+  areaLen        = (uint32_t)cc.t3t.nMaxB * NDEF_T3T_BLOCK_SIZE;
+  state          = NDEF_STATE_INITIALIZED;
+  if (messageLen > 0U) {
+    if (cc.t3t.rwFlag == NDEF_T3T_FLAG_RW) {
+      state = NDEF_STATE_READWRITE;
+    } else {
+      if (cc.t3t.rwFlag == NDEF_T3T_FLAG_RO) {
+        state = NDEF_STATE_READONLY;
+      }
+    }
+  }
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT3TPollerConfirmAttributeInformationBlock(uint32_t dataLen, uint32_t *headLen)
+{
+  ReturnCode                 ret;
+  rfalNfcfServBlockListParam servBlock;
+  uint16_t                   rcvdLen = 0U;
+  uint32_t                   nbBlocks;
+  uint32_t                   maxBlocks;
+  const uint8_t             *aib;
+  rfalNfcfServ               serviceCodeLst = NDEF_T3T_SERVICE_CODE_READ;
+
+  if (headLen != NULL) {
+    *headLen = 0U;
+  }
+  if (!subCtx.t3t.aibSpeculative) {
+    return ERR_NONE;
+  }
+  subCtx.t3t.aibSpeculative = false;
+
+  /* Read the AIB along with the first dataLen bytes of the NDEF area, within Nbr */
+  nbBlocks  = 1U + ((dataLen + NDEF_T3T_BLOCKLEN - 1U) / NDEF_T3T_BLOCKLEN);
+  maxBlocks = ndefT3TClampNbBlocks((uint32_t)cc.t3t.nbR, NDEF_T3T_CHECK_MAX_BLOCKS);
+  if (nbBlocks > maxBlocks) {
+    nbBlocks = maxBlocks;
+  }
+  ret = ndefT3TPollerSetBlockList(&servBlock, &serviceCodeLst, NDEF_T3T_ATTRIB_INFO_BLOCK_NB, (uint8_t)nbBlocks);
+  if (ret == ERR_NONE) {
+    ret = rfal_nfc->rfalNfcfPollerCheck(device.dev.nfcf.sensfRes.NFCID2, &servBlock, subCtx.t3t.rxbuf, (uint16_t)sizeof(subCtx.t3t.rxbuf), &rcvdLen);
+  }
+  if ((ret == ERR_NONE) && (rcvdLen != (uint16_t)(NDEF_T3T_CHECK_NB_BLOCKS_LEN + (nbBlocks * NDEF_T3T_BLOCK_SIZE)))) {
+    ret = ERR_REQUEST;
+  }
+  if (ret != ERR_NONE) {
+    state = NDEF_STATE_INVALID;
+    return ret;
+  }
+
+  aib = &subCtx.t3t.rxbuf[NDEF_T3T_CHECK_NB_BLOCKS_LEN];
+  if (ST_BYTECMP(aib, ccBuf, NDEF_T3T_BLOCK_SIZE) == 0) {
+    /* Cached AIB confirmed, the data blocks read along are valid */
+    if (headLen != NULL) {
+      *headLen = (nbBlocks - 1U) * NDEF_T3T_BLOCK_SIZE;
+      if (*headLen > dataLen) {
+        *headLen = dataLen;
+      }
+    }
+    return ERR_NONE;
+  }
+
+  /* Tag content changed since it was cached: use the AIB just read */
+  (void)ST_MEMCPY(ccBuf, aib, NDEF_T3T_BLOCK_SIZE);
+  ret = ndefT3TPollerParseAttributeInformationBlock(ccBuf);
+  if (ret == ERR_NONE) {
+    ndefT3TAibCacheStore(ccBuf);
+    ret = ndefT3TPollerApplyAttributeInformationBlock();
+  } else {
+    ndefT3TAibCacheRemove();
+  }
+  if (ret != ERR_NONE) {
+    state = NDEF_STATE_INVALID;
+  }
+  return ret;
+}
+
+/*******************************************************************************/
+const uint8_t *NdefClass::ndefT3TAibCacheFind()
+{
+  const ndefT3TAibCacheEntry *entry;
+
+  entry = (const ndefT3TAibCacheEntry *)ndefUidCacheFind(&t3tAibCache, device.dev.nfcf.sensfRes.NFCID2, RFAL_NFCF_NFCID2_LEN);
+  return (entry != NULL) ? entry->aib : NULL;
+}
+
+/*******************************************************************************/
+void NdefClass::ndefT3TAibCacheStore(const uint8_t *aib)
+{
+  ndefT3TAibCacheEntry *entry;
+
+  entry = (ndefT3TAibCacheEntry *)ndefUidCacheStore(&t3tAibCache, device.dev.nfcf.sensfRes.NFCID2, RFAL_NFCF_NFCID2_LEN);
+  if (entry != NULL) {
+    (void)ST_MEMCPY(entry->aib, aib, NDEF_T3T_BLOCK_SIZE);
+  }
+}
+
+/*******************************************************************************/
+void NdefClass::ndefT3TAibCacheRemove()
+{
+  ndefUidCacheRemove(&t3tAibCache, device.dev.nfcf.sensfRes.NFCID2, RFAL_NFCF_NFCID2_LEN);
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT3TPollerContextInitialization(rfalNfcDevice *dev)
 {
@@ -294,7 +496,8 @@ ReturnCode NdefClass::ndefT3TPollerContextInitialization(rfalNfcDevice *dev)
 
   (void)ST_MEMCPY(&device, dev, sizeof(device));
 
-  state                   = NDEF_STATE_INVALID;
+  state                     = NDEF_STATE_INVALID;
+  subCtx.t3t.aibSpeculative = false;
 
   return ERR_NONE;
 }
@@ -306,6 +509,7 @@ ReturnCode NdefClass::ndefT3TPollerNdefDetect(ndefInfo *info)
   rfalFeliCaPollRes pollRes[NDEF_T3T_MAX_DEVICE];
   uint8_t           devCnt     = NDEF_T3T_MAX_DEVICE;
   uint8_t           collisions = 0U;
+  const uint8_t    *aib;
 
   if (info != NULL) {
     info->state                = NDEF_STATE_INVALID;
@@ -319,7 +523,8 @@ ReturnCode NdefClass::ndefT3TPollerNdefDetect(ndefInfo *info)
   if (!ndefT3TisT3TDevice(&device)) {
     return ERR_PARAM;
   }
-  state = NDEF_STATE_INVALID;
+  state                     = NDEF_STATE_INVALID;
+  subCtx.t3t.aibSpeculative = false;
 
   /* TS T3T v1.0 7.4.1.1 the Reader/Writer SHALL send a SENSF_REQ Command with System Code set to 12FCh. */
   retcode = rfal_nfc->rfalNfcfPollerPoll(RFAL_FELICA_1_SLOT, NDEF_T3T_SYSTEMCODE, (uint8_t)RFAL_FELICA_POLL_RC_NO_REQUEST, pollRes, &devCnt, &collisions);
@@ -333,30 +538,26 @@ ReturnCode NdefClass::ndefT3TPollerNdefDetect(ndefInfo *info)
     return ERR_REQUEST; /* Wrong UID */
   }
 
-  /* TS T3T v1.0 7.4.1.3 The Reader/Writer SHALL read the Attribute Information Block using the CHECK Command. */
-  /* TS T3T v1.0 7.4.1.4 The Reader/Writer SHALL verify the value of Checksum of the Attribute Information Block. */
-  retcode = ndefT3TPollerReadAttributeInformationBlock();
+  aib = ndefT3TAibCacheFind();
+  if (aib != NULL) {
+    /* Tag seen before: use its last known AIB, confirmed by the first CHECK of the NDEF area */
+    (void)ST_MEMCPY(ccBuf, aib, NDEF_T3T_BLOCK_SIZE);
+    retcode                   = ndefT3TPollerParseAttributeInformationBlock(ccBuf);
+    subCtx.t3t.aibSpeculative = true;
+  } else {
+    /* TS T3T v1.0 7.4.1.3 The Reader/Writer SHALL read the Attribute Information Block using the CHECK Command. */
+    /* TS T3T v1.0 7.4.1.4 The Reader/Writer SHALL verify the value of Checksum of the Attribute Information Block. */
+    retcode = ndefT3TPollerReadAttributeInformationBlock();
+  }
   if (retcode != ERR_NONE) {
+    subCtx.t3t.aibSpeculative = false;
     return retcode;
   }
 
-  /* TS T3T v1.0 7.4.1.6 The Reader/Writer SHALL check if it supports the NDEF mapping version number based on the rules given in Section 7.3. */
-  if (cc.t3t.majorVersion != ndefMajorVersion(NDEF_T3T_ATTRIB_INFO_VERSION_1_0)) {
-    return ERR_REQUEST;
-  }
-
-  messageLen     = cc.t3t.Ln;
-  messageOffset  = NDEF_T3T_AREA_OFFSET;
-  areaLen        = (uint32_t)cc.t3t.nMaxB * NDEF_T3T_BLOCK_SIZE;
-  state          = NDEF_STATE_INITIALIZED;
-  if (messageLen > 0U) {
-    if (cc.t3t.rwFlag == NDEF_T3T_FLAG_RW) {
-      state = NDEF_STATE_READWRITE;
-    } else {
-      if (cc.t3t.rwFlag == NDEF_T3T_FLAG_RO) {
-        state = NDEF_STATE_READONLY;
-      }
-    }
+  retcode = ndefT3TPollerApplyAttributeInformationBlock();
+  if (retcode != ERR_NONE) {
+    subCtx.t3t.aibSpeculative = false;
+    return retcode;
   }
 
   if (info != NULL) {
@@ -375,6 +576,8 @@ ReturnCode NdefClass::ndefT3TPollerNdefDetect(ndefInfo *info)
 ReturnCode NdefClass::ndefT3TPollerReadRawMessage(uint8_t *buf, uint32_t bufLen, uint32_t *rcvdLen)
 {
   ReturnCode ret;
+  uint32_t   headLen = 0U;
+  uint32_t   readLen = 0U;
 
   if (!ndefT3TisT3TDevice(&device) || (buf == NULL)) {
     return ERR_PARAM;
@@ -385,6 +588,14 @@ ReturnCode NdefClass::ndefT3TPollerReadRawMessage(uint8_t *buf, uint32_t bufLen,
   if (state <= NDEF_STATE_INITIALIZED) {
     return ERR_WRONG_STATE;
   }
+  /* AIB from the cache: the first CHECK reads it back along with the beginning of the message */
+  ret = ndefT3TPollerConfirmAttributeInformationBlock(messageLen, &headLen);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+  if (state <= NDEF_STATE_INITIALIZED) {
+    return ERR_WRONG_STATE;
+  }
   /* TS T3T v1.0 7.4.2.1: If the WriteFlag remembered during the NDEF detection procedure is set to ON, the NDEF data may be inconsistent ...*/
   if (ndefT3TIsWriteFlagON(cc.t3t.writeFlag)) {
     /*  TS T3T v1.0 7.4.2.1: ... the Reader/Writer SHALL conclude the NDEF read procedure*/
@@ -396,7 +607,15 @@ ReturnCode NdefClass::ndefT3TPollerReadRawMessage(uint8_t *buf, uint32_t bufLen,
   }
 
   /*  TS T3T v1.0 7.4.2.2: Read NDEF data */
-  ret = ndefT3TPollerReadBytes(messageOffset, messageLen, buf, rcvdLen);
+  if (headLen > 0U) {
+    (void)ST_MEMCPY(buf, &subCtx.t3t.rxbuf[NDEF_T3T_CHECK_NB_BLOCKS_LEN + NDEF_T3T_BLOCK_SIZE], headLen);
+  }
+  if (messageLen > headLen) {
+    ret = ndefT3TPollerReadBytes(messageOffset + headLen, messageLen - headLen, &buf[headLen], &readLen);
+  }
+  if (rcvdLen != NULL) {
+    *rcvdLen = headLen + readLen;
+  }
   if (ret != ERR_NONE) {
     state = NDEF_STATE_INVALID;
   }
@@ -408,25 +627,16 @@ ReturnCode NdefClass::ndefT3TPollerWriteBlocks(uint16_t blockNum, uint8_t nbBloc
 {
   ReturnCode                 ret;
   rfalNfcfServBlockListParam servBlock;
-  rfalNfcfBlockListElem     *listBlocks;
-  uint8_t                    index;
-  rfalNfcfServ               serviceCodeLst = 0x0009U;
+  rfalNfcfServ               serviceCodeLst = NDEF_T3T_SERVICE_CODE_WRITE;
 
   if (!ndefT3TisT3TDevice(&device)) {
     return ERR_PARAM;
   }
 
-  listBlocks = subCtx.t3t.listBlocks;
-
-  for (index = 0U; index < nbBlocks; index++) {
-    /* Write each block number (16 bits per block address) */
-    listBlocks[index].conf     = (uint8_t) NDEF_T3T_BLOCKNB_CONF;
-    listBlocks[index].blockNum = (uint16_t)(blockNum + (uint16_t) index);
+  ret = ndefT3TPollerSetBlockList(&servBlock, &serviceCodeLst, blockNum, nbBlocks);
+  if (ret != ERR_NONE) {
+    return ret;
   }
-  servBlock.numServ   = 1U;
-  servBlock.servList  = &serviceCodeLst;
-  servBlock.numBlock  = nbBlocks;
-  servBlock.blockList = listBlocks;
 
   ret = rfal_nfc->rfalNfcfPollerUpdate(device.dev.nfcf.sensfRes.NFCID2, &servBlock, subCtx.t3t.txbuf, (uint16_t)sizeof(subCtx.t3t.txbuf), dataBlocks, subCtx.t3t.rxbuf, (uint16_t)sizeof(subCtx.t3t.rxbuf));
 
@@ -452,8 +662,12 @@ ReturnCode NdefClass::ndefT3TPollerWriteBytes(uint32_t offset, const uint8_t *bu
   if (!ndefT3TisT3TDevice(&device) || (len == 0U)) {
     return ERR_PARAM;
   }
+  result = ndefT3TPollerConfirmAttributeInformationBlock(0U, NULL);
+  if (result != ERR_NONE) {
+    return result;
+  }
   if (state != NDEF_STATE_INVALID) {
-    nbBlocks = cc.t3t.nbW;
+    nbBlocks = ndefT3TClampNbBlocks((uint16_t)cc.t3t.nbW, NDEF_T3T_UPDATE_MAX_BLOCKS);
   }
 
   if (startOffset != 0U) {
@@ -487,6 +701,10 @@ ReturnCode NdefClass::ndefT3TPollerWriteBytes(uint32_t offset, const uint8_t *bu
       /* Reduce the nb of blocks to read */
       nbBlocks = (uint16_t)(currentLen / blockLen);
     }
+    if (((startBlock + nbBlocks - 1U) > NDEF_T3T_BLOCKNB_2B_MAX) && (nbBlocks > NDEF_T3T_UPDATE_MAX_BLOCKS_3B)) {
+      /* 3 bytes block list elements: keep the UPDATE within a frame */
+      nbBlocks = NDEF_T3T_UPDATE_MAX_BLOCKS_3B;
+    }
     nbWrite = blockLen * nbBlocks;
     res     = ndefT3TPollerWriteBlocks(startBlock, (uint8_t) nbBlocks, &buf[txtLen]);
     if (res != ERR_NONE) {
@@ -585,6 +803,13 @@ ReturnCode NdefClass::ndefT3TPollerWriteAttributeInformationBlock()
   dataIt++;
 
   ret = ndefT3TPollerWriteBlocks(NDEF_T3T_ATTRIB_INFO_BLOCK_NB, 1U /* One block */, buf);
+  if (ret == ERR_NONE) {
+    /* The tag now holds this AIB */
+    ndefT3TAibCacheStore(buf);
+    subCtx.t3t.aibSpeculative = false;
+  } else {
+    ndefT3TAibCacheRemove();
+  }
   return ret;
 }
 
@@ -598,6 +823,10 @@ ReturnCode NdefClass::ndefT3TPollerWriteRawMessage(const uint8_t *buf, uint32_t
   }
   /* TS T3T v1.0 7.4.3: This procedure assumes that the Reader/Writer has successfully performed the NDEF detection procedure... */
   /* Warning: current tag content must not be changed between NDEF Detect procedure and NDEF read procedure*/
+  ret = ndefT3TPollerConfirmAttributeInformationBlock(0U, NULL);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
 
   /* TS T3T v1.0 7.4.3: ... and that the RWFlag in the Attribute Information Block is set to 01h. */
   if ((state != NDEF_STATE_INITIALIZED) && (state != NDEF_STATE_READWRITE)) {
@@ -717,6 +946,10 @@ ReturnCode NdefClass::ndefT3TPollerBeginWriteMessage(uint32_t messageLen)
   if (!ndefT3TisT3TDevice(&device)) {
     return ERR_PARAM;
   }
+  ret = ndefT3TPollerConfirmAttributeInformationBlock(0U, NULL);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
 
   if ((state != NDEF_STATE_INITIALIZED) && (state != NDEF_STATE_READWRITE)) {
     return ERR_WRONG_STATE;
@@ -761,9 +994,15 @@ ReturnCode NdefClass::ndefT3TPollerEndWriteMessage(uint32_t messageLen)
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT3TPollerWriteRawMessageLen(uint32_t rawMessageLen)
 {
+  ReturnCode ret;
+
   if (!ndefT3TisT3TDevice(&device)) {
     return ERR_PARAM;
   }
+  ret = ndefT3TPollerConfirmAttributeInformationBlock(0U, NULL);
+  if (ret != ERR_NONE) {
+    return ret;
+  }
 
   if ((state != NDEF_STATE_INITIALIZED) && (state != NDEF_STATE_READWRITE)) {
     return ERR_WRONG_STATE;
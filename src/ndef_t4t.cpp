@@ -63,7 +63,9 @@
 
 
 #define NDEF_T4T_FID_SIZE              2U        /*!< File Id size                                      */
-#define NDEF_T4T_WRITE_ODO_PREFIX_SIZE 7U        /*!< Size of ODO for Write Binary: 54 03 xxyyzz 53 Ld  */
+#define NDEF_T4T_WRITE_ODO_PREFIX_SIZE 9U        /*!< Max size of ODO for Write Binary: 54 03 xxyyzz 53 82 LdLd */
+#define NDEF_T4T_DATA_DO            0x53U        /*!< Tag value for data BER-TLV data object            */
+#define NDEF_T4T_BER_LEN_1B_MAX     0x7FU        /*!< Max BER-TLV length coded on one byte              */
 
 #define NDEF_T4T_DEFAULT_MLC      0x000DU        /*!< Defauit Max Lc value before reading CCFILE values */
 #define NDEF_T4T_DEFAULT_MLE      0x000FU        /*!< Defauit Max Le value before reading CCFILE values */
@@ -90,8 +92,10 @@
 
 #define NDEF_T4T_MV2_MAX_OFSSET   0x7FFFU        /*!< ReadBinary maximum Offset (offset range 0000-7FFFh)*/
 
-#define NDEF_T4T_MAX_MLE             255U        /*!< Maximum MLe value supported in this implementation (short field coding). Le=0 (MLe=256) not supported by some tag. */
-#define NDEF_T4T_MAX_MLC             255U        /*!< Maximum MLc value supported in this implementation (short field coding).                                           */
+#define NDEF_T4T_MAX_SHORT_MLE       255U        /*!< Maximum MLe value used with short field coding. Le=0 (MLe=256) not supported by some tag. */
+#define NDEF_T4T_MAX_SHORT_MLC       255U        /*!< Maximum MLc value used with short field coding.                                           */
+#define NDEF_T4T_MAX_MLE          (RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN - RFAL_T4T_MAX_RAPDU_SW1SW2_LEN)                         /*!< Maximum MLe value supported (extended field coding), bound by the APDU buffer */
+#define NDEF_T4T_MAX_MLC          (RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN - RFAL_T4T_MAX_CAPDU_PROLOGUE_LEN - RFAL_T4T_LC_EXT_LEN) /*!< Maximum MLc value supported (extended field coding), bound by the APDU buffer */
 
 /*
  ******************************************************************************
@@ -144,14 +148,23 @@ void NdefClass::ndefT4TInitializeIsoDepTxRxParam(rfalIsoDepApduTxRxParam *isoDep
 
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT4TTransceiveTxRx(rfalIsoDepApduTxRxParam *isoDepAPDU)
+{
+  return ndefT4TTransceiveTxRxInto(isoDepAPDU, NULL, 0U);
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT4TTransceiveTxRxInto(rfalIsoDepApduTxRxParam *isoDepAPDU, uint8_t *rxDst, uint16_t rxDstLen)
 {
   ReturnCode               ret;
+  uint16_t                 swPos;
+  uint8_t                  sw[RFAL_T4T_MAX_RAPDU_SW1SW2_LEN];
+  uint8_t                  i;
 
   /* Initialize respAPDU */
   subCtx.t4t.respAPDU.rApduBuf = &subCtx.t4t.rApduBuf;
   isoDepAPDU->rxLen                 = &subCtx.t4t.respAPDU.rcvdLen;
 
-  ret = rfal_nfc->rfalIsoDepStartApduTransceive(*isoDepAPDU);
+  ret = rfal_nfc->rfalIsoDepStartApduTransceiveInto(*isoDepAPDU, rxDst, rxDstLen);
   if (ret == ERR_NONE) {
     do {
       /* Blocking implementation, T4T may define rather long timeouts */
@@ -161,13 +174,31 @@ ReturnCode NdefClass::ndefT4TTransceiveTxRx(rfalIsoDepApduTxRxParam *isoDepAPDU)
   }
 
   if (ret != ERR_NONE) {
+    /* The tag state is unknown after a link error: SELECT again next time */
+    rfal_nfc->rfalT4TPollerSetSelectedAppl(NULL, 0U);
     return ret;
   }
 
-  ret = rfal_nfc->rfalT4TPollerParseRAPDU(&subCtx.t4t.respAPDU);
-  subCtx.t4t.rApduBodyLen = subCtx.t4t.respAPDU.rApduBodyLen;
+  if (rxDst == NULL) {
+    ret = rfal_nfc->rfalT4TPollerParseRAPDU(&subCtx.t4t.respAPDU);
+    subCtx.t4t.rApduBodyLen = subCtx.t4t.respAPDU.rApduBodyLen;
+    return ret;
+  }
 
-  return ret;
+  /* R-APDU body is in rxDst, SW1 SW2 follow it either in rxDst or at the start of rApduBuf */
+  if (subCtx.t4t.respAPDU.rcvdLen < RFAL_T4T_MAX_RAPDU_SW1SW2_LEN) {
+    return ERR_PROTO;
+  }
+  subCtx.t4t.respAPDU.rApduBodyLen = (subCtx.t4t.respAPDU.rcvdLen - (uint16_t)RFAL_T4T_MAX_RAPDU_SW1SW2_LEN);
+  subCtx.t4t.rApduBodyLen          = subCtx.t4t.respAPDU.rApduBodyLen;
+
+  for (i = 0U; i < RFAL_T4T_MAX_RAPDU_SW1SW2_LEN; i++) {
+    swPos = (uint16_t)(subCtx.t4t.respAPDU.rApduBodyLen + i);
+    sw[i] = ((swPos < rxDstLen) ? rxDst[swPos] : subCtx.t4t.rApduBuf.apdu[swPos - rxDstLen]);
+  }
+  subCtx.t4t.respAPDU.statusWord = GETU16(sw);
+
+  return ((subCtx.t4t.respAPDU.statusWord == RFAL_T4T_ISO7816_STATUS_COMPLETE) ? ERR_NONE : ERR_REQUEST);
 }
 
 /*******************************************************************************/
@@ -178,6 +209,12 @@ ReturnCode NdefClass::ndefT4TReadAndParseCCFile()
   ReturnCode           ret;
   uint8_t              dataIt;
 
+  /* CC file already read since the application was selected: only restore MLe/MLc */
+  if (subCtx.t4t.ccValid) {
+    ndefT4TApplyMLeMLc();
+    return ERR_NONE;
+  }
+
   /* Select CCFILE TS T4T v1.0 7.2.1.3 */
   ret =  ndefT4TPollerSelectFile(RFAL_T4T_FID_CC);
   if (ret != ERR_NONE) {
@@ -209,8 +246,7 @@ ReturnCode NdefClass::ndefT4TReadAndParseCCFile()
     return ERR_REQUEST;
   }
 
-  subCtx.t4t.curMLe   = (uint8_t)MIN(cc.t4t.mLe, NDEF_T4T_MAX_MLE); /* Only short field codind supported */
-  subCtx.t4t.curMLc   = (uint8_t)MIN(cc.t4t.mLc, NDEF_T4T_MAX_MLC); /* Only short field codind supported */
+  ndefT4TApplyMLeMLc();
 
   /* TS T4T v1.0 7.2.1.7 and 4.3.2.4 verify support of mapping version */
   if (ndefMajorVersion(cc.t4t.vNo) > ndefMajorVersion(NDEF_T4T_MAPPING_VERSION_3_0)) {
@@ -267,9 +303,18 @@ ReturnCode NdefClass::ndefT4TReadAndParseCCFile()
     cc.t4t.writeAccess = ccBuf[dataIt];
     dataIt++;
   }
+  subCtx.t4t.ccValid = true;
   return ERR_NONE;
 }
 
+/*******************************************************************************/
+void NdefClass::ndefT4TApplyMLeMLc()
+{
+  /* Extended field coding is only used when the tag advertises MLe/MLc beyond the short field range */
+  subCtx.t4t.curMLe   = (uint16_t)((cc.t4t.mLe > RFAL_T4T_MAX_LE) ? MIN(cc.t4t.mLe, NDEF_T4T_MAX_MLE) : MIN(cc.t4t.mLe, NDEF_T4T_MAX_SHORT_MLE));
+  subCtx.t4t.curMLc   = (uint16_t)((cc.t4t.mLc > RFAL_T4T_MAX_LC) ? MIN(cc.t4t.mLc, NDEF_T4T_MAX_MLC) : MIN(cc.t4t.mLc, NDEF_T4T_MAX_SHORT_MLC));
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT4TPollerSelectNdefTagApplication()
 {
@@ -282,6 +327,17 @@ ReturnCode NdefClass::ndefT4TPollerSelectNdefTagApplication()
     return ERR_PARAM;
   }
 
+  /* Still selected since the activation: nothing to send */
+  if (rfal_nfc->rfalT4TPollerIsApplSelected(NDEF_T4T_AID_NDEF, (uint8_t)sizeof(NDEF_T4T_AID_NDEF))) {
+    subCtx.t4t.mv1Flag = false;
+    return ERR_NONE;
+  }
+  if (rfal_nfc->rfalT4TPollerIsApplSelected(NDEF_T4T_AID_NDEF_V1, (uint8_t)sizeof(NDEF_T4T_AID_NDEF_V1))) {
+    subCtx.t4t.mv1Flag = true;
+    return ERR_NONE;
+  }
+  subCtx.t4t.ccValid = false;
+
   ndefT4TInitializeIsoDepTxRxParam(&isoDepAPDU);
   (void)rfal_nfc->rfalT4TPollerComposeSelectAppl(isoDepAPDU.txBuf, NDEF_T4T_AID_NDEF, (uint8_t)sizeof(NDEF_T4T_AID_NDEF), &isoDepAPDU.txBufLen);
   ret = ndefT4TTransceiveTxRx(&isoDepAPDU);
@@ -289,6 +345,7 @@ ReturnCode NdefClass::ndefT4TPollerSelectNdefTagApplication()
   if (ret == ERR_NONE) {
     /* application v2 or higher found */
     subCtx.t4t.mv1Flag = false;
+    rfal_nfc->rfalT4TPollerSetSelectedAppl(NDEF_T4T_AID_NDEF, (uint8_t)sizeof(NDEF_T4T_AID_NDEF));
     return ret;
   }
 
@@ -297,12 +354,14 @@ ReturnCode NdefClass::ndefT4TPollerSelectNdefTagApplication()
   }
 
   /* if v2 application not found, try v1 */
+  rfal_nfc->rfalT4TPollerSetSelectedAppl(NULL, 0U);
   (void)rfal_nfc->rfalT4TPollerComposeSelectAppl(isoDepAPDU.txBuf, NDEF_T4T_AID_NDEF_V1, (uint8_t)sizeof(NDEF_T4T_AID_NDEF_V1), &isoDepAPDU.txBufLen);
   ret = ndefT4TTransceiveTxRx(&isoDepAPDU);
 
   if (ret == ERR_NONE) {
     /* application v1 found */
     subCtx.t4t.mv1Flag = true;
+    rfal_nfc->rfalT4TPollerSetSelectedAppl(NDEF_T4T_AID_NDEF_V1, (uint8_t)sizeof(NDEF_T4T_AID_NDEF_V1));
   }
   return ret;
 }
@@ -312,27 +371,36 @@ ReturnCode NdefClass::ndefT4TPollerSelectFile(const uint8_t *fileId)
 {
   ReturnCode               ret;
   rfalIsoDepApduTxRxParam  isoDepAPDU;
+  uint16_t                 fid;
 
-  if (!ndefT4TisT4TDevice(&device)) {
+  if (!ndefT4TisT4TDevice(&device) || (fileId == NULL)) {
     return ERR_PARAM;
   }
 
+  /* Skip the SELECT when the file is still the current one */
+  fid = GETU16(fileId);
+  if (rfal_nfc->rfalT4TPollerGetSelectedFile() == fid) {
+    return ERR_NONE;
+  }
+
   ndefT4TInitializeIsoDepTxRxParam(&isoDepAPDU);
 
   if (subCtx.t4t.mv1Flag) {
-    (void)rfal_nfc->rfalT4TPollerComposeSelectFileV1Mapping(isoDepAPDU.txBuf, fileId, (uint8_t)sizeof(fileId), &isoDepAPDU.txBufLen);
+    (void)rfal_nfc->rfalT4TPollerComposeSelectFileV1Mapping(isoDepAPDU.txBuf, fileId, NDEF_T4T_FID_SIZE, &isoDepAPDU.txBufLen);
   } else {
     (void)rfal_nfc->rfalT4TPollerComposeSelectFile(isoDepAPDU.txBuf, fileId, NDEF_T4T_FID_SIZE, &isoDepAPDU.txBufLen);
   }
 
   ret = ndefT4TTransceiveTxRx(&isoDepAPDU);
 
+  rfal_nfc->rfalT4TPollerSetSelectedFile((ret == ERR_NONE) ? fid : RFAL_T4T_FID_NONE);
+
   return ret;
 }
 
 
 /*******************************************************************************/
-ReturnCode NdefClass::ndefT4TPollerReadBinary(uint16_t offset, uint8_t len)
+ReturnCode NdefClass::ndefT4TPollerReadBinary(uint16_t offset, uint16_t len)
 {
   ReturnCode               ret;
   rfalIsoDepApduTxRxParam  isoDepAPDU;
@@ -349,11 +417,29 @@ ReturnCode NdefClass::ndefT4TPollerReadBinary(uint16_t offset, uint8_t len)
 }
 
 /*******************************************************************************/
-ReturnCode NdefClass::ndefT4TPollerReadBinaryODO(uint32_t offset, uint8_t len)
+ReturnCode NdefClass::ndefT4TPollerReadBinaryInto(uint16_t offset, uint16_t len, uint8_t *buf, uint16_t bufLen)
 {
   ReturnCode               ret;
   rfalIsoDepApduTxRxParam  isoDepAPDU;
 
+  if (!ndefT4TisT4TDevice(&device) || (len >  subCtx.t4t.curMLe) || (offset > NDEF_T4T_OFFSET_MAX) || (buf == NULL)) {
+    return ERR_PARAM;
+  }
+
+  ndefT4TInitializeIsoDepTxRxParam(&isoDepAPDU);
+  (void)rfal_nfc->rfalT4TPollerComposeReadData(isoDepAPDU.txBuf, offset, len, &isoDepAPDU.txBufLen);
+  ret = ndefT4TTransceiveTxRxInto(&isoDepAPDU, buf, bufLen);
+
+  return ret;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT4TPollerReadBinaryODO(uint32_t offset, uint16_t len)
+{
+  ReturnCode               ret;
+  rfalIsoDepApduTxRxParam  isoDepAPDU;
+  uint16_t                 hdrLen;
+
   if (!ndefT4TisT4TDevice(&device) || (len >  subCtx.t4t.curMLe)  || (offset > NDEF_T4T_ODO_OFFSET_MAX)) {
     return ERR_PARAM;
   }
@@ -361,15 +447,32 @@ ReturnCode NdefClass::ndefT4TPollerReadBinaryODO(uint32_t offset, uint8_t len)
   ndefT4TInitializeIsoDepTxRxParam(&isoDepAPDU);
   (void)rfal_nfc->rfalT4TPollerComposeReadDataODO(isoDepAPDU.txBuf, offset, len, &isoDepAPDU.txBufLen);
   ret = ndefT4TTransceiveTxRx(&isoDepAPDU);
+  if ((ret != ERR_NONE) || (subCtx.t4t.rApduBodyLen == 0U)) {
+    return ret;
+  }
 
-  return ret;
+  /* Strip the data object header 53 L (BER-TLV length) so that the body only holds file data */
+  hdrLen = 2U;
+  if ((subCtx.t4t.rApduBodyLen < hdrLen) || (subCtx.t4t.rApduBuf.apdu[0] != NDEF_T4T_DATA_DO)) {
+    return ERR_PROTO;
+  }
+  if (subCtx.t4t.rApduBuf.apdu[1] > NDEF_T4T_BER_LEN_1B_MAX) {
+    hdrLen += (uint16_t)(subCtx.t4t.rApduBuf.apdu[1] & NDEF_T4T_BER_LEN_1B_MAX);
+  }
+  if (hdrLen > subCtx.t4t.rApduBodyLen) {
+    return ERR_PROTO;
+  }
+  subCtx.t4t.rApduBodyLen -= hdrLen;
+  (void)ST_MEMMOVE(subCtx.t4t.rApduBuf.apdu, &subCtx.t4t.rApduBuf.apdu[hdrLen], subCtx.t4t.rApduBodyLen);
+
+  return ERR_NONE;
 }
 
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT4TPollerReadBytes(uint32_t offset, uint32_t len, uint8_t *buf, uint32_t *rcvdLen)
 {
   ReturnCode           ret;
-  uint8_t              le;
+  uint16_t             le;
   uint32_t             lvOffset = offset;
   uint32_t             lvLen    = len;
   uint8_t             *lvBuf    = buf;
@@ -382,11 +485,12 @@ ReturnCode NdefClass::ndefT4TPollerReadBytes(uint32_t offset, uint32_t len, uint
   }
 
   do {
-    le = (lvLen > subCtx.t4t.curMLe) ? subCtx.t4t.curMLe : (uint8_t)lvLen;
+    le = (lvLen > subCtx.t4t.curMLe) ? subCtx.t4t.curMLe : (uint16_t)lvLen;
     if (lvOffset > NDEF_T4T_MV2_MAX_OFSSET) {
       ret = ndefT4TPollerReadBinaryODO(lvOffset, le);
     } else {
-      ret = ndefT4TPollerReadBinary((uint16_t)lvOffset, le);
+      /* Body assembled straight into the caller's buffer, SW1 SW2 may land right after it */
+      ret = ndefT4TPollerReadBinaryInto((uint16_t)lvOffset, le, lvBuf, (uint16_t)MIN(lvLen, 0xFFFFU));
     }
     if (ret != ERR_NONE) {
       return ret;
@@ -397,7 +501,9 @@ ReturnCode NdefClass::ndefT4TPollerReadBytes(uint32_t offset, uint32_t len, uint
     if (subCtx.t4t.rApduBodyLen >  lvLen) {
       return ERR_SYSTEM;
     }
-    (void)ST_MEMCPY(lvBuf, subCtx.t4t.rApduBuf.apdu, subCtx.t4t.rApduBodyLen);
+    if (lvOffset > NDEF_T4T_MV2_MAX_OFSSET) {
+      (void)ST_MEMCPY(lvBuf, subCtx.t4t.rApduBuf.apdu, subCtx.t4t.rApduBodyLen);
+    }
     lvBuf     = &lvBuf[subCtx.t4t.rApduBodyLen];
     lvOffset += subCtx.t4t.rApduBodyLen;
     lvLen    -= subCtx.t4t.rApduBodyLen;
@@ -545,7 +651,7 @@ ReturnCode NdefClass::ndefT4TPollerReadRawMessage(uint8_t *buf, uint32_t bufLen,
 }
 
 /*******************************************************************************/
-ReturnCode NdefClass::ndefT4TPollerWriteBinary(uint16_t offset, const uint8_t *data, uint8_t len)
+ReturnCode NdefClass::ndefT4TPollerWriteBinary(uint16_t offset, const uint8_t *data, uint16_t len)
 {
   ReturnCode               ret;
   rfalIsoDepApduTxRxParam  isoDepAPDU;
@@ -562,7 +668,7 @@ ReturnCode NdefClass::ndefT4TPollerWriteBinary(uint16_t offset, const uint8_t *d
 }
 
 /*******************************************************************************/
-ReturnCode NdefClass::ndefT4TPollerWriteBinaryODO(uint32_t offset, const uint8_t *data, uint8_t len)
+ReturnCode NdefClass::ndefT4TPollerWriteBinaryODO(uint32_t offset, const uint8_t *data, uint16_t len)
 {
   ReturnCode               ret;
   rfalIsoDepApduTxRxParam  isoDepAPDU;
@@ -582,7 +688,7 @@ ReturnCode NdefClass::ndefT4TPollerWriteBinaryODO(uint32_t offset, const uint8_t
 ReturnCode NdefClass::ndefT4TPollerWriteBytes(uint32_t offset, const uint8_t *buf, uint32_t len)
 {
   ReturnCode           ret;
-  uint8_t              lc;
+  uint16_t             lc;
   uint32_t             lvOffset = offset;
   uint32_t             lvLen    = len;
   const uint8_t       *lvBuf    = buf;
@@ -594,10 +700,10 @@ ReturnCode NdefClass::ndefT4TPollerWriteBytes(uint32_t offset, const uint8_t *bu
   do {
 
     if (lvOffset > NDEF_T4T_MV2_MAX_OFSSET) {
-      lc = (lvLen > ((uint32_t)subCtx.t4t.curMLc - NDEF_T4T_WRITE_ODO_PREFIX_SIZE)) ? (uint8_t)(subCtx.t4t.curMLc - NDEF_T4T_WRITE_ODO_PREFIX_SIZE) : (uint8_t)lvLen;
+      lc = (lvLen > ((uint32_t)subCtx.t4t.curMLc - NDEF_T4T_WRITE_ODO_PREFIX_SIZE)) ? (uint16_t)(subCtx.t4t.curMLc - NDEF_T4T_WRITE_ODO_PREFIX_SIZE) : (uint16_t)lvLen;
       ret = ndefT4TPollerWriteBinaryODO(lvOffset, lvBuf, lc);
     } else {
-      lc = (lvLen > subCtx.t4t.curMLc) ? subCtx.t4t.curMLc : (uint8_t)lvLen;
+      lc = (lvLen > subCtx.t4t.curMLc) ? subCtx.t4t.curMLc : (uint16_t)lvLen;
       ret = ndefT4TPollerWriteBinary((uint16_t)lvOffset, lvBuf, lc);
     }
     if (ret != ERR_NONE) {
@@ -67,7 +67,14 @@
 #define NDEF_T5T_TLV_T_LEN                     1U    /*!< TLV T Length: 1 bytes                             */
 
 #define NDEF_T5T_MAX_BLOCK_1_BYTE_ADDR       256U    /*!< Max number of blocks for 1 byte addressing        */
+#define NDEF_T5T_WRITE_COMPLETION_MS          20U    /*!< Max time for a VICC to end a pending write (ms)   */
+#define NDEF_T5T_MAX_RD_MULT_BLOCKS          256U    /*!< Max number of blocks of a Read Multiple Blocks    */
+#define NDEF_T5T_WR_MULT_HEADER_LEN            6U    /*!< Flags, Cmd, Extended first block, Extended count  */
+#define NDEF_T5T_WR_MULT_TX_BUF_LEN  (NDEF_T5T_WR_MULT_HEADER_LEN + RFAL_NFCV_UID_LEN \
+                 + (NDEF_T5T_WR_MULT_MAX_BLOCKS * RFAL_NFCV_MAX_BLOCK_LEN)) /*!< Write Multiple Blocks request buffer len */
 #define NDEF_T5T_MAX_MLEN_1_BYTE_ENCODING    256U    /*!< MLEN max value for 1 byte encoding                */
+#define NDEF_T5T_DIFF_RD_BUF_LEN  (MAX(NDEF_T5T_RD_MULT_MAX_LEN, RFAL_NFCV_MAX_BLOCK_LEN) \
+                 + NDEF_T5T_TxRx_BUFF_HEADER_SIZE + NDEF_T5T_TxRx_BUFF_FOOTER_SIZE) /*!< Differential write compare buffer len */
 
 #define NDEF_T5T_TL_MAX_SIZE  (NDEF_T5T_TLV_T_LEN \
                        + NDEF_T5T_TLV_L_3_BYTES_LEN) /*!< Max TL size                                       */
@@ -119,6 +126,8 @@ ReturnCode NdefClass::ndefT5TPollerReadBytes(uint32_t offset, uint32_t len, uint
   uint16_t        blockLen;
   uint16_t        startBlock;
   uint16_t        startAddr;
+  uint16_t        nbBlocks;
+  uint16_t        maxBlocks;
   ReturnCode      result     = ERR_PARAM;
   uint32_t        currentLen = len;
   uint32_t        lvRcvLen   = 0U;
@@ -142,15 +151,28 @@ ReturnCode NdefClass::ndefT5TPollerReadBytes(uint32_t offset, uint32_t len, uint
       }
       lvRcvLen   += (uint32_t) nbRead;
       currentLen -= (uint32_t) nbRead;
-      while (currentLen >= ((uint32_t)blockLen + 2U)) {
+      maxBlocks   = ndefT5TPollerReadMultipleMaxBlocks();
+      while (currentLen >= ((uint32_t)blockLen + NDEF_T5T_TxRx_BUFF_FOOTER_SIZE)) {
+        /* As many whole blocks as fit in the caller buffer, the status byte overwriting the previous data byte */
+        nbBlocks = (uint16_t)MIN((currentLen - NDEF_T5T_TxRx_BUFF_FOOTER_SIZE) / blockLen, (uint32_t)maxBlocks);
         startBlock++;
         lastVal = buf[lvRcvLen - 1U];
-        res = ndefT5TPollerReadSingleBlock(startBlock, &buf[lvRcvLen - 1U], blockLen + 3U, &nbRead);
+        if (nbBlocks > 1U) {
+          res = ndefT5TPollerReadMultipleBlocks(startBlock, (uint8_t)(nbBlocks - 1U), &buf[lvRcvLen - 1U], (uint16_t)((nbBlocks * blockLen) + 3U), &nbRead);
+        } else {
+          res = ndefT5TPollerReadSingleBlock(startBlock, &buf[lvRcvLen - 1U], blockLen + 3U, &nbRead);
+        }
         status  = buf[lvRcvLen - 1U]; /* Keep status */
         buf[lvRcvLen - 1U] = lastVal; /* Restore previous value */
-        if ((res == ERR_NONE) && (nbRead > 0U) && (status == 0U)) {
-          lvRcvLen   += blockLen;
-          currentLen -= blockLen;
+        if ((res == ERR_NONE) && (nbRead > 0U) && (status == 0U) && ((nbBlocks == 1U) || (nbRead == ((nbBlocks * blockLen) + 1U)))) {
+          lvRcvLen   += (uint32_t)nbBlocks * blockLen;
+          currentLen -= (uint32_t)nbBlocks * blockLen;
+          startBlock  = (uint16_t)(startBlock + nbBlocks - 1U);
+        } else if (nbBlocks > 1U) {
+          /* Read Multiple Blocks rejected: carry on block per block */
+          subCtx.t5t.rdMultDisabled = true;
+          maxBlocks = 1U;
+          startBlock--;
         } else {
           break;
         }
@@ -187,7 +209,10 @@ ReturnCode NdefClass::ndefT5TPollerReadBytes(uint32_t offset, uint32_t len, uint
 ReturnCode NdefClass::ndefT5TPollerContextInitialization(rfalNfcDevice *dev)
 {
   ReturnCode    result;
+  ReturnCode    extRet;
+  ReturnCode    ret;
   uint16_t      rcvLen;
+  const ndefT5TSysInfoCacheEntry *entry;
 
   if ((dev == NULL) || !ndefT5TisT5TDevice(dev)) {
     return ERR_PARAM;
@@ -204,6 +229,8 @@ ReturnCode NdefClass::ndefT5TPollerContextInitialization(rfalNfcDevice *dev)
   subCtx.t5t.TlvNDEFOffset = 0U; /* Offset for TLV */
 
   subCtx.t5t.legacySTHighDensity = false;
+  subCtx.t5t.rdMultDisabled      = false;
+  subCtx.t5t.wrMultDisabled      = false;
   result = ndefT5TPollerReadSingleBlock(0U, subCtx.t5t.txrxBuf, (uint16_t)sizeof(subCtx.t5t.txrxBuf), &rcvLen);
   if ((result != ERR_NONE) && (device.dev.nfcv.InvRes.UID[NDEF_T5T_UID_MANUFACTURER_ID_POS] == NDEF_T5T_MANUFACTURER_ID_ST)) {
     /* Try High Density Legacy mode */
@@ -220,38 +247,85 @@ ReturnCode NdefClass::ndefT5TPollerContextInitialization(rfalNfcDevice *dev)
     return ERR_PROTO;
   }
 
+  /* ST tags answer the Fast read commands at twice the data rate */
+  subCtx.t5t.stFastRead = (device.dev.nfcv.InvRes.UID[NDEF_T5T_UID_MANUFACTURER_ID_POS] == NDEF_T5T_MANUFACTURER_ID_ST);
+
   if (rfal_nfc->rfalNfcvPollerSelect((uint8_t)RFAL_NFCV_REQ_FLAG_DEFAULT, device.dev.nfcv.InvRes.UID)  == ERR_NONE) {
     subCtx.t5t.pAddressedUid = NULL; /* Switch to selected mode */
   }
 
+  /* Known tag answering block 0 as when it was cached: reuse its System Information */
+  entry = ndefT5TSysInfoCacheFind();
+  if ((entry != NULL) && (entry->blockLen == subCtx.t5t.blockLen) && (entry->legacySTHighDensity == subCtx.t5t.legacySTHighDensity) &&
+      (!entry->sysInfoSupported || (ndefT5TSysInfoMemSizePresent(entry->sysInfo.infoFlags) == 0U) || (entry->sysInfo.blockSize == subCtx.t5t.blockLen))) {
+    (void)ST_MEMCPY(&subCtx.t5t.sysInfo, &entry->sysInfo, sizeof(ndefSystemInformation));
+    subCtx.t5t.sysInfoSupported = entry->sysInfoSupported;
+    return result;
+  }
+
   subCtx.t5t.sysInfoSupported = false;
 
+  extRet = ERR_NOTSUPP;
   if (!subCtx.t5t.legacySTHighDensity) {
     /* Extended Get System Info */
-    if (ndefT5TGetSystemInformation(true) == ERR_NONE) {
+    extRet = ndefT5TGetSystemInformation(true);
+    if (extRet == ERR_NONE) {
       subCtx.t5t.sysInfoSupported = true;
     }
   }
+  ret = ERR_NONE;
   if (!subCtx.t5t.sysInfoSupported) {
     /* Get System Info */
-    if (ndefT5TGetSystemInformation(false) == ERR_NONE) {
+    ret = ndefT5TGetSystemInformation(false);
+    if (ret == ERR_NONE) {
       subCtx.t5t.sysInfoSupported = true;
     }
   }
+
+  /* Only cache a definitive answer: a System Information, or the tag rejecting both requests */
+  if (subCtx.t5t.sysInfoSupported || (ndefT5TSysInfoIsRejected(extRet) && ndefT5TSysInfoIsRejected(ret))) {
+    ndefT5TSysInfoCacheStore();
+  }
   return result;
 }
 
+/*******************************************************************************/
+bool NdefClass::ndefT5TSysInfoIsRejected(ReturnCode ret)
+{
+  /* Error flag set in the response (rfalNfcvParseError()), unlike a timeout or a transmission error */
+  return ((ret == ERR_NOTSUPP) || (ret == ERR_REQUEST));
+}
+
+/*******************************************************************************/
+const ndefT5TSysInfoCacheEntry *NdefClass::ndefT5TSysInfoCacheFind()
+{
+  return (const ndefT5TSysInfoCacheEntry *)ndefUidCacheFind(&t5tSysInfoCache, device.dev.nfcv.InvRes.UID, RFAL_NFCV_UID_LEN);
+}
+
+/*******************************************************************************/
+void NdefClass::ndefT5TSysInfoCacheStore()
+{
+  ndefT5TSysInfoCacheEntry *entry;
+
+  entry = (ndefT5TSysInfoCacheEntry *)ndefUidCacheStore(&t5tSysInfoCache, device.dev.nfcv.InvRes.UID, RFAL_NFCV_UID_LEN);
+  if (entry == NULL) {
+    return;
+  }
+  (void)ST_MEMCPY(&entry->sysInfo, &subCtx.t5t.sysInfo, sizeof(ndefSystemInformation));
+  entry->sysInfoSupported    = subCtx.t5t.sysInfoSupported;
+  entry->legacySTHighDensity = subCtx.t5t.legacySTHighDensity;
+  entry->blockLen            = subCtx.t5t.blockLen;
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT5TPollerNdefDetect(ndefInfo *info)
 {
-  ReturnCode result;
-  uint8_t    tmpBuf[NDEF_T5T_TL_MAX_SIZE];
-  ReturnCode returnCode = ERR_REQUEST; /* Default return code */
-  uint16_t   offset;
-  uint16_t   length;
-  uint32_t   TlvOffset;
-  bool       bExit;
-  uint32_t   rcvLen;
+  ReturnCode     result;
+  ReturnCode     returnCode = ERR_REQUEST; /* Default return code */
+  bool           bExit;
+  uint32_t       rcvLen;
+  ndefTlvScanner scan;
+  ndefTlv        tlv;
 
   if (!ndefT5TisT5TDevice(&device)) {
     return ERR_PARAM;
@@ -260,6 +334,7 @@ ReturnCode NdefClass::ndefT5TPollerNdefDetect(ndefInfo *info)
   state                           = NDEF_STATE_INVALID;
   cc.t5t.ccLen                    = 0U;
   cc.t5t.memoryLen                = 0U;
+  cc.t5t.multipleBlockRead        = false;
   messageLen                      = 0U;
   messageOffset                   = 0U;
 
@@ -305,28 +380,23 @@ ReturnCode NdefClass::ndefT5TPollerNdefDetect(ndefInfo *info)
     }
     messageLen     = 0U;
     messageOffset  = cc.t5t.ccLen;
-    TlvOffset = cc.t5t.ccLen;
     bExit     = false;
+    /* Walk the TLVs through the scanner read-ahead buffer, starting with the blocks read for the CC.
+     * Each refill fills the whole buffer with a single Read Multiple Blocks where supported */
+    ndefTlvScanInit(&scan, cc.t5t.ccLen, (uint32_t)cc.t5t.ccLen + ((uint32_t)cc.t5t.memoryLen * NDEF_T5T_MLEN_DIVIDER), subCtx.t5t.blockLen, (uint8_t)NDEF_TLV_SCAN_BUF_LEN);
+    ndefTlvScanSeed(&scan, 0U, ccBuf, rcvLen);
     do {
-      result = ndefT5TPollerReadBytes(TlvOffset, NDEF_T5T_TL_MAX_SIZE, tmpBuf, &rcvLen);
-      if ((result != ERR_NONE) || (rcvLen != NDEF_T5T_TL_MAX_SIZE)) {
+      result = ndefTlvScanNext(&scan, &tlv);
+      if (result != ERR_NONE) {
         break;
       }
-      offset = 2U;
-      length = tmpBuf[1U];
-      if (length == (NDEF_SHORT_VFIELD_MAX_LEN + 1U)) {
-        /* Size is encoded in 1 + 2 bytes */
-        length = (((uint16_t)tmpBuf[2U]) << 8U) + (uint16_t)tmpBuf[3U];
-        offset += 2U;
-      }
-      if (tmpBuf[0U] == (uint8_t)NDEF_T5T_TLV_NDEF) {
+      if (tlv.type == (uint8_t)NDEF_T5T_TLV_NDEF) {
         /* NDEF record return it */
         returnCode                    = ERR_NONE;  /* Default */
-        subCtx.t5t.TlvNDEFOffset = TlvOffset; /* Offset for TLV */
-        messageOffset            = TlvOffset + offset;
-        messageLen               = length;
-        TlvOffset = 0U;
-        if (length == 0U) {
+        subCtx.t5t.TlvNDEFOffset = tlv.offset; /* Offset for TLV */
+        messageOffset            = tlv.valueOffset;
+        messageLen               = tlv.len;
+        if (tlv.len == 0U) {
           /* Req 40 7.5.1.6 */
           if ((cc.t5t.readAccess == 0U) && (cc.t5t.writeAccess == 0U)) {
             state = NDEF_STATE_INITIALIZED;
@@ -345,19 +415,16 @@ ReturnCode NdefClass::ndefT5TPollerNdefDetect(ndefInfo *info)
           }
           bExit = true;
         }
-      } else if (tmpBuf[0U] == (uint8_t) NDEF_T5T_TLV_TERMINATOR) {
+      } else if (tlv.type == (uint8_t) NDEF_T5T_TLV_TERMINATOR) {
         /* NDEF end */
-        TlvOffset = 0U;
         bExit     = true;
-      } else if (tmpBuf[0U] == (uint8_t) NDEF_T5T_TLV_PROPRIETARY) {
+      } else if (tlv.type == (uint8_t) NDEF_T5T_TLV_PROPRIETARY) {
         /* proprietary go next, nothing to do */
-        TlvOffset += (uint32_t)offset + (uint32_t)length;
       } else {
         /* RFU value */
-        TlvOffset = 0U;
         bExit = true;
       }
-    } while ((TlvOffset > 0U) && (bExit == false));
+    } while (bExit == false);
   } else {
     /* No CCFile */
     returnCode = ERR_REQUEST;
@@ -405,6 +472,7 @@ ReturnCode NdefClass::ndefT5TPollerWriteBytes(uint32_t offset, const uint8_t *bu
   uint16_t        blockLen16;
   uint16_t        startBlock;
   uint16_t        startAddr ;
+  uint16_t        nbBlocks;
   const uint8_t *wrbuf      = buf;
   uint32_t        currentLen = len;
 
@@ -426,10 +494,15 @@ ReturnCode NdefClass::ndefT5TPollerWriteBytes(uint32_t offset, const uint8_t *bu
       if (nbRead > (uint32_t) currentLen) {
         nbRead = (uint16_t) currentLen;
       }
-      if (nbRead > 0U) {
-        (void)ST_MEMCPY(&subCtx.t5t.txrxBuf[1U - startAddr + (uint16_t)offset], wrbuf, nbRead);
+      if (differentialWrite && (ST_BYTECMP(&subCtx.t5t.txrxBuf[1U - startAddr + (uint16_t)offset], wrbuf, nbRead) == 0)) {
+        /* Block content unchanged */
+        res = ERR_NONE;
+      } else {
+        if (nbRead > 0U) {
+          (void)ST_MEMCPY(&subCtx.t5t.txrxBuf[1U - startAddr + (uint16_t)offset], wrbuf, nbRead);
+        }
+        res = ndefT5TPollerWriteSingleBlock(startBlock, &subCtx.t5t.txrxBuf[1U]);
       }
-      res = ndefT5TPollerWriteSingleBlock(startBlock, &subCtx.t5t.txrxBuf[1U]);
       if (res != ERR_NONE) {
         return res;
       }
@@ -446,11 +519,18 @@ ReturnCode NdefClass::ndefT5TPollerWriteBytes(uint32_t offset, const uint8_t *bu
     startBlock++;
   }
   while (currentLen >= blockLen16) {
-    res = ndefT5TPollerWriteSingleBlock(startBlock, wrbuf);
+    /* Differential writes read a window of blocks at once and only write the blocks that differ */
+    if (differentialWrite) {
+      nbBlocks = (uint16_t)MIN(currentLen / blockLen16, (uint32_t)ndefT5TPollerReadMultipleMaxBlocks());
+      res = ndefT5TPollerWriteChangedBlocks(startBlock, nbBlocks, wrbuf);
+    } else {
+      nbBlocks = (uint16_t)MIN(currentLen / blockLen16, (uint32_t)NDEF_T5T_MAX_RD_MULT_BLOCKS);
+      res = ndefT5TPollerWriteBlocks(startBlock, nbBlocks, wrbuf);
+    }
     if (res == ERR_NONE) {
-      currentLen -= blockLen16;
-      wrbuf       = &wrbuf[blockLen16];
-      startBlock++;
+      currentLen -= (uint32_t)nbBlocks * blockLen16;
+      wrbuf       = &wrbuf[(uint32_t)nbBlocks * blockLen16];
+      startBlock  = (uint16_t)(startBlock + nbBlocks);
     } else {
       result = res;
       break;
@@ -460,10 +540,15 @@ ReturnCode NdefClass::ndefT5TPollerWriteBytes(uint32_t offset, const uint8_t *bu
     /* Unaligned end, must read the first block before */
     res = ndefT5TPollerReadSingleBlock(startBlock, subCtx.t5t.txrxBuf, blockLen16 + 3U, &nbRead);
     if ((res == ERR_NONE) && (subCtx.t5t.txrxBuf[0U] == 0U) && (nbRead > 0U)) {
-      if (currentLen > 0U) {
-        (void)ST_MEMCPY(&subCtx.t5t.txrxBuf[1U], wrbuf, currentLen);
+      if (differentialWrite && (ST_BYTECMP(&subCtx.t5t.txrxBuf[1U], wrbuf, currentLen) == 0)) {
+        /* Block content unchanged */
+        res = ERR_NONE;
+      } else {
+        if (currentLen > 0U) {
+          (void)ST_MEMCPY(&subCtx.t5t.txrxBuf[1U], wrbuf, currentLen);
+        }
+        res = ndefT5TPollerWriteSingleBlock(startBlock, &subCtx.t5t.txrxBuf[1U]);
       }
-      res = ndefT5TPollerWriteSingleBlock(startBlock, &subCtx.t5t.txrxBuf[1U]);
       if (res != ERR_NONE) {
         result = res;
       } else {
@@ -501,6 +586,8 @@ ReturnCode NdefClass::ndefT5TPollerWriteRawMessageLen(uint32_t rawMessageLen)
         TLV[len] = (uint8_t) rawMessageLen;
         len++;
       } else {
+        TLV[len] = (uint8_t)(NDEF_SHORT_VFIELD_MAX_LEN + 1U); /* 3 bytes L-field */
+        len++;
         TLV[len] = (uint8_t)(rawMessageLen >> 8U);
         len++;
         TLV[len] = (uint8_t) rawMessageLen;
@@ -696,7 +783,7 @@ ReturnCode NdefClass::ndefT5TPollerTagFormat(const ndefCapabilityContainer *cc_p
   if (result != ERR_NONE) {
     /* If write fails, try to use special frame if not yet used */
     if (!cc.t5t.specialFrame) {
-      delay(20U); /* Wait to be sure that previous command has ended */
+      ndefT5TPollerWaitWriteCompletion(); /* Wait to be sure that previous command has ended */
       cc.t5t.specialFrame = true; /* Add option flag */
       result = ndefT5TWriteCC();
       if (result != ERR_NONE) {
@@ -840,15 +927,169 @@ ReturnCode NdefClass::ndefT5TPollerWriteSingleBlock(uint16_t blockNum, const uin
   return ret;
 }
 
+/*******************************************************************************/
+uint16_t NdefClass::ndefT5TPollerWriteMultipleMaxBlocks(uint16_t blockNum, uint16_t nbBlocks)
+{
+  uint16_t maxBlocks;
+
+  /* Special frames need an EOF the Write Multiple Blocks path does not send */
+  if ((nbBlocks < 2U) || subCtx.t5t.wrMultDisabled || subCtx.t5t.legacySTHighDensity || cc.t5t.specialFrame ||
+      !subCtx.t5t.sysInfoSupported || (ndefT5TSysInfoCmdListPresent(subCtx.t5t.sysInfo.infoFlags) == 0U)) {
+    return 1U;
+  }
+  /* Batches never straddle a NDEF_T5T_WR_MULT_MAX_BLOCKS boundary */
+  maxBlocks = (uint16_t)MIN(nbBlocks, NDEF_T5T_WR_MULT_MAX_BLOCKS - (blockNum % NDEF_T5T_WR_MULT_MAX_BLOCKS));
+
+  if ((blockNum + maxBlocks) <= NDEF_T5T_MAX_BLOCK_1_BYTE_ADDR) {
+    if (ndefT5TSysInfoWriteMultipleBlocksSupported(subCtx.t5t.sysInfo.supportedCmd) == 0U) {
+      return 1U;
+    }
+  } else {
+    if (ndefT5TSysInfoExtWriteMultipleBlocksSupported(subCtx.t5t.sysInfo.supportedCmd) == 0U) {
+      return 1U;
+    }
+  }
+  return maxBlocks;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT5TPollerWriteMultipleBlocks(uint16_t firstBlockNum, uint16_t numOfBlocks, const uint8_t *wrData)
+{
+  uint8_t                   txBuf[NDEF_T5T_WR_MULT_TX_BUF_LEN];
+  uint16_t                  wrDataLen;
+
+  if (!ndefT5TisT5TDevice(&device) || (numOfBlocks == 0U) || (numOfBlocks > NDEF_T5T_WR_MULT_MAX_BLOCKS)) {
+    return ERR_PARAM;
+  }
+
+  wrDataLen = (uint16_t)(numOfBlocks * subCtx.t5t.blockLen);
+
+  if ((firstBlockNum + numOfBlocks) <= NDEF_T5T_MAX_BLOCK_1_BYTE_ADDR) {
+    return rfal_nfc->rfalNfcvPollerWriteMultipleBlocks((uint8_t)RFAL_NFCV_REQ_FLAG_DEFAULT, subCtx.t5t.pAddressedUid, (uint8_t)firstBlockNum, (uint8_t)numOfBlocks, txBuf, (uint16_t)sizeof(txBuf), subCtx.t5t.blockLen, wrData, wrDataLen);
+  }
+  return rfal_nfc->rfalNfcvPollerExtendedWriteMultipleBlocks((uint8_t)RFAL_NFCV_REQ_FLAG_DEFAULT, subCtx.t5t.pAddressedUid, firstBlockNum, numOfBlocks, txBuf, (uint16_t)sizeof(txBuf), subCtx.t5t.blockLen, wrData, wrDataLen);
+}
+
+/*******************************************************************************/
+void NdefClass::ndefT5TPollerWaitWriteCompletion()
+{
+  uint32_t                  start;
+  uint16_t                  rcvLen;
+
+  /* A VICC still programming its memory does not answer: poll until it does, bounded by the max write time */
+  start = millis();
+  do {
+    if (ndefT5TPollerReadSingleBlock(0U, subCtx.t5t.txrxBuf, (uint16_t)sizeof(subCtx.t5t.txrxBuf), &rcvLen) == ERR_NONE) {
+      return;
+    }
+  } while ((millis() - start) < NDEF_T5T_WRITE_COMPLETION_MS);
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT5TPollerWriteBlocks(uint16_t blockNum, uint16_t nbBlocks, const uint8_t *wrData)
+{
+  ReturnCode                res;
+  uint16_t                  blockLen16 = (uint16_t)subCtx.t5t.blockLen;
+  uint16_t                  lvBlockNum = blockNum;
+  uint16_t                  lvNbBlocks = nbBlocks;
+  const uint8_t            *lvData     = wrData;
+  uint16_t                  nbWritten;
+
+  while (lvNbBlocks != 0U) {
+    nbWritten = ndefT5TPollerWriteMultipleMaxBlocks(lvBlockNum, lvNbBlocks);
+    if (nbWritten > 1U) {
+      res = ndefT5TPollerWriteMultipleBlocks(lvBlockNum, nbWritten, lvData);
+      if (res != ERR_NONE) {
+        /* Write Multiple Blocks rejected: carry on block per block */
+        subCtx.t5t.wrMultDisabled = true;
+        nbWritten = 1U;
+        res = ndefT5TPollerWriteSingleBlock(lvBlockNum, lvData);
+      }
+    } else {
+      res = ndefT5TPollerWriteSingleBlock(lvBlockNum, lvData);
+    }
+    if (res != ERR_NONE) {
+      return res;
+    }
+    lvBlockNum  = (uint16_t)(lvBlockNum + nbWritten);
+    lvNbBlocks  = (uint16_t)(lvNbBlocks - nbWritten);
+    lvData      = &lvData[(uint32_t)nbWritten * blockLen16];
+  }
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+ReturnCode NdefClass::ndefT5TPollerWriteChangedBlocks(uint16_t blockNum, uint16_t nbBlocks, const uint8_t *wrData)
+{
+  ReturnCode                res;
+  uint8_t                   rdBuf[NDEF_T5T_DIFF_RD_BUF_LEN];
+  uint16_t                  blockLen16 = (uint16_t)subCtx.t5t.blockLen;
+  uint16_t                  rcvLen;
+  uint16_t                  first;
+  uint16_t                  i;
+  bool                      changed;
+
+  if ((nbBlocks == 0U) || (((uint32_t)nbBlocks * blockLen16) > (sizeof(rdBuf) - NDEF_T5T_TxRx_BUFF_HEADER_SIZE - NDEF_T5T_TxRx_BUFF_FOOTER_SIZE))) {
+    return ERR_PARAM;
+  }
+
+  if (nbBlocks > 1U) {
+    res = ndefT5TPollerReadMultipleBlocks(blockNum, (uint8_t)(nbBlocks - 1U), rdBuf, (uint16_t)sizeof(rdBuf), &rcvLen);
+  } else {
+    res = ndefT5TPollerReadSingleBlock(blockNum, rdBuf, (uint16_t)sizeof(rdBuf), &rcvLen);
+  }
+  if ((res != ERR_NONE) || (rdBuf[0U] != 0U) || (rcvLen != (((uint32_t)nbBlocks * blockLen16) + 1U))) {
+    if (nbBlocks > 1U) {
+      /* Read Multiple Blocks rejected: compare block per block from now on */
+      subCtx.t5t.rdMultDisabled = true;
+    }
+    /* Any read failure leads to a regular write */
+    return ndefT5TPollerWriteBlocks(blockNum, nbBlocks, wrData);
+  }
+
+  /* Write each run of changed blocks, batched as any other write */
+  first = nbBlocks;
+  for (i = 0U; i <= nbBlocks; i++) {
+    changed = (i < nbBlocks) && (ST_BYTECMP(&rdBuf[1U + ((uint32_t)i * blockLen16)], &wrData[(uint32_t)i * blockLen16], blockLen16) != 0);
+    if (changed && (first == nbBlocks)) {
+      first = i;
+    } else if (!changed && (first != nbBlocks)) {
+      res = ndefT5TPollerWriteBlocks((uint16_t)(blockNum + first), (uint16_t)(i - first), &wrData[(uint32_t)first * blockLen16]);
+      if (res != ERR_NONE) {
+        return res;
+      }
+      first = nbBlocks;
+    } else {
+      /* MISRA 15.7 - Empty else */
+    }
+  }
+  return ERR_NONE;
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT5TPollerReadMultipleBlocks(uint16_t firstBlockNum, uint8_t numOfBlocks, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen)
 {
   ReturnCode                ret;
+  ReturnCode                fastRet;
 
   if (!ndefT5TisT5TDevice(&device)) {
     return ERR_PARAM;
   }
 
+  fastRet = ERR_NONE;
+  if (subCtx.t5t.stFastRead) {
+    if (subCtx.t5t.legacySTHighDensity) {
+      fastRet = rfal_nfc->rfalST25xVPollerM24LRFastReadMultipleBlocks((uint8_t)RFAL_NFCV_REQ_FLAG_DEFAULT, subCtx.t5t.pAddressedUid, firstBlockNum, numOfBlocks, rxBuf, rxBufLen, rcvLen);
+    } else if (firstBlockNum < NDEF_T5T_MAX_BLOCK_1_BYTE_ADDR) {
+      fastRet = rfal_nfc->rfalST25xVPollerFastReadMultipleBlocks((uint8_t)RFAL_NFCV_REQ_FLAG_DEFAULT, subCtx.t5t.pAddressedUid, (uint8_t)firstBlockNum, numOfBlocks, rxBuf, rxBufLen, rcvLen);
+    } else {
+      fastRet = rfal_nfc->rfalST25xVPollerFastExtReadMultipleBlocks((uint8_t)RFAL_NFCV_REQ_FLAG_DEFAULT, subCtx.t5t.pAddressedUid, firstBlockNum, numOfBlocks, rxBuf, rxBufLen, rcvLen);
+    }
+    if (fastRet == ERR_NONE) {
+      return ERR_NONE;
+    }
+  }
+
   if (subCtx.t5t.legacySTHighDensity) {
 
     ret = rfal_nfc->rfalST25xVPollerM24LRReadMultipleBlocks((uint8_t)RFAL_NFCV_REQ_FLAG_DEFAULT, subCtx.t5t.pAddressedUid, firstBlockNum, numOfBlocks, rxBuf, rxBufLen, rcvLen);
@@ -860,9 +1101,36 @@ ReturnCode NdefClass::ndefT5TPollerReadMultipleBlocks(uint16_t firstBlockNum, ui
     }
   }
 
+  if ((fastRet != ERR_NONE) && (ret == ERR_NONE)) {
+    /* The standard command works where the Fast one does not: stop trying Fast mode */
+    subCtx.t5t.stFastRead = false;
+  }
+
   return ret;
 }
 
+/*******************************************************************************/
+uint16_t NdefClass::ndefT5TPollerReadMultipleMaxBlocks()
+{
+  bool supported;
+
+  if ((subCtx.t5t.blockLen == 0U) || subCtx.t5t.rdMultDisabled) {
+    return 1U;
+  }
+
+  /* Advertised either by the CC MBREAD bit or by the Extended Get System Info command list */
+  supported = cc.t5t.multipleBlockRead;
+  if (subCtx.t5t.sysInfoSupported && (ndefT5TSysInfoCmdListPresent(subCtx.t5t.sysInfo.infoFlags) != 0U) &&
+      (ndefT5TSysInfoReadMultipleBlocksSupported(subCtx.t5t.sysInfo.supportedCmd) != 0U)) {
+    supported = true;
+  }
+  if (!supported) {
+    return 1U;
+  }
+
+  return (uint16_t)MIN(NDEF_T5T_MAX_RD_MULT_BLOCKS, MAX(NDEF_T5T_RD_MULT_MAX_LEN / (uint16_t)subCtx.t5t.blockLen, 1U));
+}
+
 /*******************************************************************************/
 ReturnCode NdefClass::ndefT5TPollerReadSingleBlock(uint16_t blockNum, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen)
 {
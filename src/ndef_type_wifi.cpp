@@ -91,7 +91,7 @@ const ndefConstBuffer8 bufMediaTypeWifi      = { ndefMediaTypeWifi,      sizeof(
 #define NDEF_WIFI_ATTRIBUTE_AUTHENTICATION_LSB_OFFSET 0x05U    /*!< Attribute authentication offset */
 
 
-static uint8_t wifiConfigToken1[] = {
+static const uint8_t wifiConfigToken1[] = {
   0x10, 0x4A, /* Attribute ID: Version       */
   0x00, 0x01, /* Attribute ID Length         */
   0x10,       /* Version 1.0                 */
@@ -103,7 +103,7 @@ static uint8_t wifiConfigToken1[] = {
   0x10, 0x45  /* Attribute ID: SSID          */
 };
 
-static uint8_t wifiConfigToken3[] = {
+static const uint8_t wifiConfigToken3[] = {
   0x10, 0x03, /* Attribute ID:Authentication Type */
   0x00, 0x02, /* Attribute Length                 */
   0x00, 0x01, /* Attribute Type: Open             */
@@ -113,7 +113,7 @@ static uint8_t wifiConfigToken3[] = {
   0x10, 0x27  /* Attribute ID: Network Key        */
 };
 
-static uint8_t wifiConfigToken5[] = {
+static const uint8_t wifiConfigToken5[] = {
   0x10, 0x20,       /* Attribute ID: MAC Address           */
   0x00, 0x06,       /* Attribute Length                    */
   0,                /* MAC-ADDRESS                         */
@@ -146,7 +146,7 @@ static uint8_t wifiConfigToken5[] = {
 extern "C" {
 #endif
 static uint32_t ndefWifiPayloadGetLength(const ndefType *wifi);
-static const uint8_t *ndefWifiToPayloadItem(const ndefType *wifi, ndefConstBuffer *bufItem, bool begin);
+static const uint8_t *ndefWifiToPayloadItem(const ndefType *wifi, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin);
 #ifdef __cplusplus
 }
 #endif
@@ -207,37 +207,36 @@ static uint32_t ndefWifiPayloadGetLength(const ndefType *wifi)
 
 
 /*****************************************************************************/
-static const uint8_t *ndefWifiToPayloadItem(const ndefType *wifi, ndefConstBuffer *bufItem, bool begin)
+static const uint8_t *ndefWifiToPayloadItem(const ndefType *wifi, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin)
 {
-  static uint32_t item = 0;
   const ndefTypeWifi *wifiData;
   uint16_t credentialLength;
 
-  uint8_t defaultKey[4] = {0, 0, 0, 0};
-  ndefConstBuffer8 bufDefaultNetworkKey = { defaultKey, sizeof(defaultKey) };
+  static const uint8_t defaultKey[4] = {0, 0, 0, 0};
+  static const ndefConstBuffer8 bufDefaultNetworkKey = { defaultKey, sizeof(defaultKey) };
 
   const uint8_t CONFIG_TOKEN_1_CREDENTIAL_LENGTH_INDEX   =  7U;
   const uint8_t CONFIG_TOKEN_3_AUTHENTICATION_TYPE_INDEX =  5U;
   const uint8_t CONFIG_TOKEN_3_ENCRYPTION_TYPE_INDEX     = 11U;
 
-  static uint8_t zero[] = { 0 };
-  static ndefConstBuffer8 bufZero = { zero, sizeof(zero) };
+  static const uint8_t zero[] = { 0 };
+  static const ndefConstBuffer8 bufZero = { zero, sizeof(zero) };
 
   if ((wifi    == NULL) || (wifi->id != NDEF_TYPE_MEDIA_WIFI) ||
-      (bufItem == NULL)) {
+      (bufItem == NULL) || (cursor == NULL)) {
     return NULL;
   }
 
   wifiData = &wifi->data.wifi;
 
   if (begin == true) {
-    item = 0;
+    cursor->item = 0;
   }
 
   bufItem->buffer = NULL;
   bufItem->length = 0;
 
-  switch (item) {
+  switch (cursor->item) {
     case 0:
       /* Config Token1 */
 
@@ -251,10 +250,11 @@ static const uint8_t *ndefWifiToPayloadItem(const ndefType *wifi, ndefConstBuffe
                                     wifiData->bufNetworkKey.length +  /* Network key        */
                                     sizeof(wifiConfigToken5));        /* Token5 length      */
 
-      wifiConfigToken1[CONFIG_TOKEN_1_CREDENTIAL_LENGTH_INDEX]      = (uint8_t)(credentialLength >>    8U);
-      wifiConfigToken1[CONFIG_TOKEN_1_CREDENTIAL_LENGTH_INDEX + 1U] = (uint8_t)(credentialLength  & 0xFFU);
+      (void)ST_MEMCPY(cursor->scratch, wifiConfigToken1, sizeof(wifiConfigToken1));
+      cursor->scratch[CONFIG_TOKEN_1_CREDENTIAL_LENGTH_INDEX]      = (uint8_t)(credentialLength >>    8U);
+      cursor->scratch[CONFIG_TOKEN_1_CREDENTIAL_LENGTH_INDEX + 1U] = (uint8_t)(credentialLength  & 0xFFU);
 
-      bufItem->buffer = wifiConfigToken1;
+      bufItem->buffer = cursor->scratch;
       bufItem->length = sizeof(wifiConfigToken1);
       break;
 
@@ -280,10 +280,11 @@ static const uint8_t *ndefWifiToPayloadItem(const ndefType *wifi, ndefConstBuffe
       /* Config Token3 */
 
       /* Update Token3 with Authentication and Encryption Types */
-      wifiConfigToken3[CONFIG_TOKEN_3_AUTHENTICATION_TYPE_INDEX] = wifiData->authentication;
-      wifiConfigToken3[CONFIG_TOKEN_3_ENCRYPTION_TYPE_INDEX]     = wifiData->encryption;
+      (void)ST_MEMCPY(cursor->scratch, wifiConfigToken3, sizeof(wifiConfigToken3));
+      cursor->scratch[CONFIG_TOKEN_3_AUTHENTICATION_TYPE_INDEX] = wifiData->authentication;
+      cursor->scratch[CONFIG_TOKEN_3_ENCRYPTION_TYPE_INDEX]     = wifiData->encryption;
 
-      bufItem->buffer = wifiConfigToken3;
+      bufItem->buffer = cursor->scratch;
       bufItem->length = sizeof(wifiConfigToken3);
       break;
 
@@ -324,7 +325,7 @@ static const uint8_t *ndefWifiToPayloadItem(const ndefType *wifi, ndefConstBuffe
   }
 
   /* Move to next item for next call */
-  item++;
+  cursor->item++;
 
   return bufItem->buffer;
 }
@@ -114,6 +114,10 @@
 #define NDEF_VCARD_ENTRY_MAX                    16U    /*!< vCard maximum entries */
 
 
+/*! Payload encoder defines */
+#define NDEF_PAYLOAD_ITEM_SCRATCH_LEN           16U    /*!< Encoder scratch length, fits the largest Wifi config token */
+
+
 /*
  ******************************************************************************
  * GLOBAL TYPES
@@ -201,6 +205,15 @@ typedef struct {
 
 /*****************************************************************************/
 
+/*! Payload encoder iterator state, owned by the caller so that several records can be encoded concurrently */
+typedef struct {
+  uint32_t item;                                    /*!< Current item            */
+  uint32_t userItem;                                /*!< Current item in entry   */
+  uint32_t index;                                   /*!< Current entry           */
+  uint8_t  scratch[NDEF_PAYLOAD_ITEM_SCRATCH_LEN];  /*!< Item built by the encoder, valid until the next call */
+} ndefPayloadItemCursor;
+
+
 /*! NDEF Type Id enum */
 typedef enum {
   NDEF_TYPE_EMPTY = 0,
@@ -219,7 +232,7 @@ typedef enum {
 struct ndefTypeStruct {
   ndefTypeId      id;                                       /*!< Type Id           */
   uint32_t (*getPayloadLength)(const ndefType *type);       /*!< Return payload length, specific to each type */
-  const uint8_t *(*getPayloadItem)(const ndefType *type, ndefConstBuffer *item, bool begin); /*!< Payload Encoder, specific to each type */
+  const uint8_t *(*getPayloadItem)(const ndefType *type, ndefConstBuffer *item, ndefPayloadItemCursor *cursor, bool begin); /*!< Payload Encoder, specific to each type */
   union {
     ndefTypeRtdDeviceInfo  deviceInfo;    /*!< Device Information */
     ndefTypeRtdText        text;          /*!< Text               */
@@ -93,7 +93,7 @@ static const ndefConstBuffer bufValue_2_1   = { VALUE_2_1,    sizeof(VALUE_2_1)
 extern "C" {
 #endif
 static uint32_t ndefVCardPayloadGetLength(const ndefType *vCard);
-static const uint8_t *ndefVCardToPayloadItem(const ndefType *vCard, ndefConstBuffer *bufItem, bool begin);
+static const uint8_t *ndefVCardToPayloadItem(const ndefType *vCard, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin);
 #ifdef __cplusplus
 }
 #endif
@@ -264,24 +264,21 @@ static uint32_t ndefVCardPayloadGetLength(const ndefType *vCard)
 
 
 /*****************************************************************************/
-static const uint8_t *ndefVCardToPayloadItem(const ndefType *vCard, ndefConstBuffer *bufItem, bool begin)
+static const uint8_t *ndefVCardToPayloadItem(const ndefType *vCard, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin)
 {
-  static uint32_t item     = 0;
-  static uint32_t userItem = 0;
-  static uint32_t index    = 0;
   const ndefTypeVCard *vCardData;
 
   if ((vCard   == NULL) || (vCard->id != NDEF_TYPE_MEDIA_VCARD) ||
-      (bufItem == NULL)) {
+      (bufItem == NULL) || (cursor == NULL)) {
     return NULL;
   }
 
   vCardData = &vCard->data.vCard;
 
   if (begin == true) {
-    item     = 0;
-    userItem = 0;
-    index    = 0;
+    cursor->item     = 0;
+    cursor->userItem = 0;
+    cursor->index    = 0;
   }
 
   bufItem->buffer = NULL;
@@ -292,99 +289,99 @@ static const uint8_t *ndefVCardToPayloadItem(const ndefType *vCard, ndefConstBuf
     return NULL;
   }
 
-  switch (item) {
+  switch (cursor->item) {
     /* BEGIN:VCARD\r\n */
     case 0:
       bufItem->buffer = bufTypeBegin.buffer;
       bufItem->length = bufTypeBegin.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
     case 1:
       bufItem->buffer = bufDelimiterColon.buffer;
       bufItem->length = bufDelimiterColon.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
     case 2:
       bufItem->buffer = bufValueVCard.buffer;
       bufItem->length = bufValueVCard.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
     case 3:
       bufItem->buffer = bufDelimiterNewLine.buffer;
       bufItem->length = bufDelimiterNewLine.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
 
     /* VERSION:2.1\r\n */
     case 4:
       bufItem->buffer = bufTypeVersion.buffer;
       bufItem->length = bufTypeVersion.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
     case 5:
       bufItem->buffer = bufDelimiterColon.buffer;
       bufItem->length = bufDelimiterColon.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
     case 6:
       bufItem->buffer = bufValue_2_1.buffer;
       bufItem->length = bufValue_2_1.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
     case 7:
       bufItem->buffer = bufDelimiterNewLine.buffer;
       bufItem->length = bufDelimiterNewLine.length;
-      item++; /* Move to next item for next call */
-      userItem = 0;
-      index    = 0;
+      cursor->item++; /* Move to next item for next call */
+      cursor->userItem = 0;
+      cursor->index    = 0;
       break;
     case 8:
       /* User data */
-      switch (userItem) {
+      switch (cursor->userItem) {
         case 0:
           /* Type */
-          if (vCardData->entry[index].bufTypeBuffer == NULL) {
+          if (vCardData->entry[cursor->index].bufTypeBuffer == NULL) {
             bufItem->buffer = bufTypeEnd.buffer;
             bufItem->length = bufTypeEnd.length;
-            item++; /* Exit the user item loop */
+            cursor->item++; /* Exit the user item loop */
             break;
           }
-          bufItem->buffer = vCardData->entry[index].bufTypeBuffer;
-          bufItem->length = vCardData->entry[index].bufTypeLength;
+          bufItem->buffer = vCardData->entry[cursor->index].bufTypeBuffer;
+          bufItem->length = vCardData->entry[cursor->index].bufTypeLength;
 
-          if (vCardData->entry[index].bufSubTypeBuffer != NULL) {
-            userItem++;
+          if (vCardData->entry[cursor->index].bufSubTypeBuffer != NULL) {
+            cursor->userItem++;
           } else {
-            userItem += 3U; /* Skip sending semicolon and subtype, move to colon */
+            cursor->userItem += 3U; /* Skip sending semicolon and subtype, move to colon */
           }
           break;
         case 1:
           bufItem->buffer = bufDelimiterSemicolon.buffer;
           bufItem->length = bufDelimiterSemicolon.length;
-          userItem++;
+          cursor->userItem++;
           break;
         case 2:
           /* Subtype */
-          bufItem->buffer = vCardData->entry[index].bufSubTypeBuffer;
-          bufItem->length = vCardData->entry[index].bufSubTypeLength;
-          userItem++;
+          bufItem->buffer = vCardData->entry[cursor->index].bufSubTypeBuffer;
+          bufItem->length = vCardData->entry[cursor->index].bufSubTypeLength;
+          cursor->userItem++;
           break;
         case 3:
           bufItem->buffer = bufDelimiterColon.buffer;
           bufItem->length = bufDelimiterColon.length;
-          userItem++;
+          cursor->userItem++;
           break;
         case 4:
           /* Value */
-          bufItem->buffer = vCardData->entry[index].bufValueBuffer;
-          bufItem->length = vCardData->entry[index].bufValueLength;
-          userItem++;
+          bufItem->buffer = vCardData->entry[cursor->index].bufValueBuffer;
+          bufItem->length = vCardData->entry[cursor->index].bufValueLength;
+          cursor->userItem++;
           break;
         case 5:
           bufItem->buffer = bufDelimiterNewLine.buffer;
           bufItem->length = bufDelimiterNewLine.length;
-          index++;
-          userItem = 0; /* Looping to case 0 */
+          cursor->index++;
+          cursor->userItem = 0; /* Looping to case 0 */
           break;
         default:
           /* MISRA 16.4: mandatory default statement */
@@ -394,12 +391,12 @@ static const uint8_t *ndefVCardToPayloadItem(const ndefType *vCard, ndefConstBuf
     case 9:
       bufItem->buffer = bufDelimiterColon.buffer;
       bufItem->length = bufDelimiterColon.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
     case 10:
       bufItem->buffer = bufValueVCard.buffer;
       bufItem->length = bufValueVCard.length;
-      item++; /* Move to next item for next call */
+      cursor->item++; /* Move to next item for next call */
       break;
     default:
       bufItem->buffer = NULL;
@@ -174,13 +174,13 @@ static const ndefConstBuffer ndefUriPrefix[NDEF_URI_PREFIX_COUNT] = {
 extern "C" {
 #endif
 static uint32_t ndefEmptyTypePayloadGetLength(const ndefType *empty);
-static const uint8_t *ndefEmptyTypePayloadItem(const ndefType *empty, ndefConstBuffer *bufItem, bool begin);
+static const uint8_t *ndefEmptyTypePayloadItem(const ndefType *empty, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin);
 static uint32_t ndefRtdDeviceInfoPayloadGetLength(const ndefType *devInfo);
-static const uint8_t *ndefRtdDeviceInfoToPayloadItem(const ndefType *devInfo, ndefConstBuffer *bufItem, bool begin);
+static const uint8_t *ndefRtdDeviceInfoToPayloadItem(const ndefType *devInfo, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin);
 static uint32_t ndefRtdTextPayloadGetLength(const ndefType *text);
-static const uint8_t *ndefRtdTextToPayloadItem(const ndefType *text, ndefConstBuffer *bufItem, bool begin);
+static const uint8_t *ndefRtdTextToPayloadItem(const ndefType *text, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin);
 static uint32_t ndefRtdUriPayloadGetLength(const ndefType *uri);
-static const uint8_t *ndefRtdUriToPayloadItem(const ndefType *uri, ndefConstBuffer *bufItem, bool begin);
+static const uint8_t *ndefRtdUriToPayloadItem(const ndefType *uri, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin);
 #ifdef __cplusplus
 }
 #endif
@@ -211,12 +211,13 @@ static uint32_t ndefEmptyTypePayloadGetLength(const ndefType *empty)
 
 
 /*****************************************************************************/
-static const uint8_t *ndefEmptyTypePayloadItem(const ndefType *empty, ndefConstBuffer *bufItem, bool begin)
+static const uint8_t *ndefEmptyTypePayloadItem(const ndefType *empty, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin)
 {
   if ((empty == NULL) || (empty->id != NDEF_TYPE_EMPTY)) {
     return NULL;
   }
 
+  NO_WARNING(cursor);
   NO_WARNING(begin);
 
   if (bufItem != NULL) {
@@ -315,31 +316,30 @@ static uint32_t ndefRtdDeviceInfoPayloadGetLength(const ndefType *devInfo)
 
 
 /*****************************************************************************/
-static const uint8_t *ndefRtdDeviceInfoToPayloadItem(const ndefType *devInfo, ndefConstBuffer *bufItem, bool begin)
+static const uint8_t *ndefRtdDeviceInfoToPayloadItem(const ndefType *devInfo, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin)
 {
-  static uint32_t item = 0;
   const ndefTypeRtdDeviceInfo *rtdDevInfo;
   uint32_t index;
 
   if ((devInfo == NULL) || (devInfo->id != NDEF_TYPE_RTD_DEVICE_INFO) ||
-      (bufItem == NULL)) {
+      (bufItem == NULL) || (cursor == NULL)) {
     return NULL;
   }
 
   rtdDevInfo = &devInfo->data.deviceInfo;
 
   if (begin == true) {
-    item = 0;
+    cursor->item = 0;
   }
 
   bufItem->buffer = NULL;
   bufItem->length = 0;
 
-  index = item / 3U;
+  index = cursor->item / 3U;
 
   /* Stop streaming on first empty entry */
   if (rtdDevInfo->devInfo[index].length > 0U) {
-    switch (item % 3U) {
+    switch (cursor->item % 3U) {
       case 0:
         bufItem->buffer = &rtdDevInfo->devInfo[index].type;
         bufItem->length = sizeof(rtdDevInfo->devInfo[index].type);
@@ -360,7 +360,7 @@ static const uint8_t *ndefRtdDeviceInfoToPayloadItem(const ndefType *devInfo, nd
   }
 
   /* Move to next item for next call */
-  item++;
+  cursor->item++;
 
   return bufItem->buffer;
 }
@@ -607,23 +607,22 @@ static uint32_t ndefRtdTextPayloadGetLength(const ndefType *text)
 
 
 /*****************************************************************************/
-static const uint8_t *ndefRtdTextToPayloadItem(const ndefType *text, ndefConstBuffer *bufItem, bool begin)
+static const uint8_t *ndefRtdTextToPayloadItem(const ndefType *text, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin)
 {
-  static uint32_t item = 0;
   const ndefTypeRtdText *rtdText;
 
   if ((text    == NULL) || (text->id != NDEF_TYPE_RTD_TEXT) ||
-      (bufItem == NULL)) {
+      (bufItem == NULL) || (cursor == NULL)) {
     return NULL;
   }
 
   rtdText = &text->data.text;
 
   if (begin == true) {
-    item = 0;
+    cursor->item = 0;
   }
 
-  switch (item) {
+  switch (cursor->item) {
     case 0:
       /* Status byte */
       bufItem->buffer = &rtdText->status;
@@ -649,7 +648,7 @@ static const uint8_t *ndefRtdTextToPayloadItem(const ndefType *text, ndefConstBu
   }
 
   /* Move to next item for next call */
-  item++;
+  cursor->item++;
 
   return bufItem->buffer;
 }
@@ -823,23 +822,22 @@ static uint32_t ndefRtdUriPayloadGetLength(const ndefType *uri)
 
 
 /*****************************************************************************/
-static const uint8_t *ndefRtdUriToPayloadItem(const ndefType *uri, ndefConstBuffer *bufItem, bool begin)
+static const uint8_t *ndefRtdUriToPayloadItem(const ndefType *uri, ndefConstBuffer *bufItem, ndefPayloadItemCursor *cursor, bool begin)
 {
-  static uint32_t item = 0;
   const ndefTypeRtdUri *rtdUri;
 
   if ((uri     == NULL) || (uri->id != NDEF_TYPE_RTD_URI) ||
-      (bufItem == NULL)) {
+      (bufItem == NULL) || (cursor == NULL)) {
     return NULL;
   }
 
   rtdUri = &uri->data.uri;
 
   if (begin == true) {
-    item = 0;
+    cursor->item = 0;
   }
 
-  switch (item) {
+  switch (cursor->item) {
     case 0:
       /* Protocol byte */
       bufItem->buffer = &rtdUri->protocol;
@@ -859,7 +857,7 @@ static const uint8_t *ndefRtdUriToPayloadItem(const ndefType *uri, ndefConstBuff
   }
 
   /* Move to next item for next call */
-  item++;
+  cursor->item++;
 
   return bufItem->buffer;
 }
@@ -477,6 +477,9 @@ void RfalNfcClass::rfalIsoDepInitialize(void)
   gIsoDep.maxRetriesI    = RFAL_ISODEP_MAX_I_RETRYS;
   gIsoDep.maxRetriesRATS = RFAL_ISODEP_RATS_RETRIES;
 
+  /* A new activation starts with no application selected */
+  rfalT4TPollerSetSelectedAppl(NULL, 0U);
+
   isoDepClearCounters();
 }
 
@@ -1476,9 +1479,11 @@ ReturnCode RfalNfcClass::rfalIsoDepStartApduTransceive(rfalIsoDepApduTxRxParam p
   rfalIsoDepTxRxParam txRxParam;
 
   /* Initialize and store APDU context */
-  gIsoDep.APDUParam = param;
-  gIsoDep.APDUTxPos = 0;
-  gIsoDep.APDURxPos = 0;
+  gIsoDep.APDUParam    = param;
+  gIsoDep.APDUTxPos    = 0;
+  gIsoDep.APDURxPos    = 0;
+  gIsoDep.APDURxDst    = NULL;
+  gIsoDep.APDURxDstLen = 0;
 
   /* Assign current FSx to calculate INF length */
   gIsoDep.ourFsx = param.ourFSx;
@@ -1491,6 +1496,54 @@ ReturnCode RfalNfcClass::rfalIsoDepStartApduTransceive(rfalIsoDepApduTxRxParam p
 }
 
 
+/*******************************************************************************/
+ReturnCode RfalNfcClass::rfalIsoDepStartApduTransceiveInto(rfalIsoDepApduTxRxParam param, uint8_t *rxDst, uint16_t rxDstLen)
+{
+  ReturnCode ret;
+
+  if ((rxDst == NULL) && (rxDstLen != 0U)) {
+    return ERR_PARAM;
+  }
+
+  ret = rfalIsoDepStartApduTransceive(param);
+
+  /* Set after the start, which resets the APDU context */
+  gIsoDep.APDURxDst    = rxDst;
+  gIsoDep.APDURxDstLen = rxDstLen;
+
+  return ret;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalNfcClass::rfalIsoDepApduStoreRx(const uint8_t *inf, uint16_t infLen)
+{
+  uint16_t dstLen;
+
+  if (infLen == 0U) {   /* MISRA 21.18 */
+    return ERR_NONE;
+  }
+
+  /* Fill the caller's destination first, the remainder goes to the APDU buffer */
+  dstLen = 0U;
+  if ((gIsoDep.APDURxDst != NULL) && (gIsoDep.APDURxPos < gIsoDep.APDURxDstLen)) {
+    dstLen = MIN(infLen, (uint16_t)(gIsoDep.APDURxDstLen - gIsoDep.APDURxPos));
+    ST_MEMCPY(&gIsoDep.APDURxDst[gIsoDep.APDURxPos], inf, dstLen);
+  }
+
+  if (dstLen < infLen) {
+    if (((uint32_t)gIsoDep.APDURxPos + infLen - gIsoDep.APDURxDstLen) > RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN) {
+      return ERR_NOMEM;
+    }
+    ST_MEMCPY(&gIsoDep.APDUParam.rxBuf->apdu[(gIsoDep.APDURxPos + dstLen) - gIsoDep.APDURxDstLen], &inf[dstLen], (uint16_t)(infLen - dstLen));
+  }
+
+  gIsoDep.APDURxPos += infLen;
+
+  return ERR_NONE;
+}
+
+
 /*******************************************************************************/
 ReturnCode RfalNfcClass::rfalIsoDepGetApduTransceiveStatus(void)
 {
@@ -1519,11 +1572,8 @@ ReturnCode RfalNfcClass::rfalIsoDepGetApduTransceiveStatus(void)
         return ERR_BUSY;
       }
 
-      if (*gIsoDep.APDUParam.rxLen > 0U) {   /* MISRA 21.18 */
-        /* Copy packet from tmp buffer to APDU buffer */
-        ST_MEMCPY(&gIsoDep.APDUParam.rxBuf->apdu[gIsoDep.APDURxPos], gIsoDep.APDUParam.tmpBuf->inf, *gIsoDep.APDUParam.rxLen);
-        gIsoDep.APDURxPos += *gIsoDep.APDUParam.rxLen;
-      }
+      /* Copy packet from tmp buffer to APDU buffer (or destination) */
+      EXIT_ON_ERR(ret, rfalIsoDepApduStoreRx(gIsoDep.APDUParam.tmpBuf->inf, *gIsoDep.APDUParam.rxLen));
 
       /* APDU TxRx is done */
       break;
@@ -1531,11 +1581,8 @@ ReturnCode RfalNfcClass::rfalIsoDepGetApduTransceiveStatus(void)
     /*******************************************************************************/
     case ERR_AGAIN:
 
-      if (*gIsoDep.APDUParam.rxLen > 0U) {   /* MISRA 21.18 */
-        /* Copy chained packet from tmp buffer to APDU buffer */
-        ST_MEMCPY(&gIsoDep.APDUParam.rxBuf->apdu[gIsoDep.APDURxPos], gIsoDep.APDUParam.tmpBuf->inf, *gIsoDep.APDUParam.rxLen);
-        gIsoDep.APDURxPos += *gIsoDep.APDUParam.rxLen;
-      }
+      /* Copy chained packet from tmp buffer to APDU buffer (or destination) */
+      EXIT_ON_ERR(ret, rfalIsoDepApduStoreRx(gIsoDep.APDUParam.tmpBuf->inf, *gIsoDep.APDUParam.rxLen));
 
       /* Wait for next I-Block */
       return ERR_BUSY;
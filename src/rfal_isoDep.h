@@ -145,8 +145,14 @@
 #define RFAL_ISODEP_RATS_RETRIES                (1U)     /*!< RATS retries upon fail           Digital 1.1  A.6 - [0,1]                          */
 
 
+#ifndef RFAL_FEATURE_ISO_DEP_IBLOCK_MAX_LEN
 #define RFAL_FEATURE_ISO_DEP_IBLOCK_MAX_LEN    256U       /*!< ISO-DEP I-Block max length. Please use values as defined by rfalIsoDepFSx */
-#define RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN      1024U      /*!< ISO-DEP APDU max length. Please use multiples of I-Block max length       */
+#endif
+#ifndef RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN
+#define RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN      1024U      /*!< ISO-DEP APDU max length. Please use multiples of I-Block max length.
+                                                               Bounds the extended Lc/Le used by the T4T NDEF poller, may be raised
+                                                               from the build flags for tags advertising a larger MLe/MLc        */
+#endif
 
 /*! Frame Size for Proximity Card Integer definitions                                                               */
 typedef enum {
@@ -476,6 +482,8 @@ typedef struct {
   rfalIsoDepApduTxRxParam APDUParam;        /*!< APDU TxRx params               */
   uint16_t                APDUTxPos;        /*!< APDU Tx position               */
   uint16_t                APDURxPos;        /*!< APDU Rx position               */
+  uint8_t                 *APDURxDst;       /*!< APDU Rx destination, if any    */
+  uint16_t                APDURxDstLen;     /*!< APDU Rx destination length     */
   bool                    isAPDURxChaining; /*!< APDU Transceive chaining flag  */
 
 } rfalIsoDep;
@@ -72,6 +72,8 @@ RfalNfcClass::RfalNfcClass(RfalRfClass *rfal_rf) : rfalRfDev(rfal_rf)
   memset(&gRfalNfcb, 0, sizeof(rfalNfcb));
   memset(&gNfcip, 0, sizeof(rfalNfcDep));
   memset(&gRfalNfcfGreedyF, 0, sizeof(rfalNfcfGreedyF));
+  gT2TSectorNo = 0U;
+  rfalT4TPollerSetSelectedAppl(NULL, 0U);
 }
 
 
@@ -269,6 +271,7 @@ void RfalNfcClass::rfalNfcWorker(void)
       if (err != ERR_BUSY) {                                                    /* Wait until all technologies are performed            */
         if ((err != ERR_NONE) || (gNfcDev.techsFound == RFAL_NFC_TECH_NONE)) { /* Check if any error occurred or no techs were found   */
           rfalRfDev->rfalFieldOff();
+          rfalT2TPollerResetSector();
           gNfcDev.state = RFAL_NFC_STATE_LISTEN_TECHDETECT;                 /* Nothing found as poller, go to listener */
           break;
         }
@@ -349,6 +352,7 @@ void RfalNfcClass::rfalNfcWorker(void)
 
       if (timerIsExpired(gNfcDev.discTmr)) {
         rfalRfDev->rfalFieldOff();
+        rfalT2TPollerResetSector();
 
         gNfcDev.state = RFAL_NFC_STATE_START_DISCOVERY;                       /* Restart the discovery loop */
         break;
@@ -587,6 +591,7 @@ ReturnCode RfalNfcClass::rfalNfcPollTechDetetection(void)
     }
 
     rfalRfDev->rfalFieldOff();
+    rfalT2TPollerResetSector();
     return ERR_BUSY;
   }
 
@@ -1152,6 +1157,7 @@ ReturnCode RfalNfcClass::rfalNfcDeactivation(void)
   rfalRfDev->rfalWakeUpModeStop();
 
   rfalRfDev->rfalFieldOff();
+  rfalT2TPollerResetSector();
 
   gNfcDev.activeDev = NULL;
   return ERR_NONE;
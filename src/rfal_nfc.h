@@ -73,8 +73,10 @@
 #include "rfal_nfcb.h"
 #include "rfal_nfcf.h"
 #include "rfal_nfcv.h"
+#include "rfal_st25xv.h"
 #include "rfal_st25tb.h"
 #include "rfal_nfcDep.h"
+#include "rfal_t2t.h"
 #include "rfal_t4t.h"
 
 /*
@@ -690,6 +692,32 @@ class RfalNfcClass {
     ReturnCode rfalIsoDepStartApduTransceive(rfalIsoDepApduTxRxParam param);
 
 
+    /*!
+     *****************************************************************************
+     *  \brief ISO-DEP Start APDU Transceive into a destination buffer
+     *
+     *  Same as rfalIsoDepStartApduTransceive() except that the R-APDU is
+     *  assembled straight into rxDst instead of param.rxBuf->apdu, saving a
+     *  copy of the response body.
+     *  The first rxDstLen bytes of the R-APDU go to rxDst, any remaining
+     *  bytes (usually SW1 SW2) go to the start of param.rxBuf->apdu.
+     *  *param.rxLen holds the full R-APDU length on completion.
+     *
+     *  \warning when the R-APDU is shorter than rxDstLen + 2, SW1 SW2 are
+     *           placed in rxDst right after the response body
+     *
+     *  \param[in]  param    : reference parameters to be used for the Transceive
+     *  \param[out] rxDst    : destination of the R-APDU
+     *  \param[in]  rxDstLen : destination length
+     *
+     *  \return ERR_PARAM       : Bad request
+     *  \return ERR_WRONG_STATE : The module is not in a proper state
+     *  \return ERR_NONE        : The Transceive request has been started
+     *****************************************************************************
+     */
+    ReturnCode rfalIsoDepStartApduTransceiveInto(rfalIsoDepApduTxRxParam param, uint8_t *rxDst, uint16_t rxDstLen);
+
+
     /*!
      *****************************************************************************
      *  \brief Get the APDU Transceive status
@@ -3151,6 +3179,75 @@ class RfalNfcClass {
      */
     ReturnCode rfalST25xVPollerFastWriteMessage(uint8_t flags, const uint8_t *uid, uint8_t msgLen, const uint8_t *msgData, uint8_t *txBuf, uint16_t txBufLen);
 
+    /*!
+     *****************************************************************************
+     * \brief  ST25DV Mailbox channel initialization
+     *
+     * Prepares a channel streaming data through the ST25DV Mailbox (Fast
+     * Transfer Mode) and checks that the Mailbox is enabled (MB_EN in
+     * MB_CTRL_Dyn). The channel keeps the request parameters and the frame
+     * buffers used by rfalST25xVMbChannelSend() and rfalST25xVMbChannelReceive().
+     *
+     * \param[out] ch            : channel to initialize
+     * \param[in]  flags         : Flags to be used: Sub-carrier; Data_rate; Option
+     *                              for NFC-Forum use: RFAL_NFCV_REQ_FLAG_DEFAULT
+     * \param[in]  uid           : UID of the device, if not provided Select mode
+     *                              will be used (kept by reference)
+     * \param[in]  fast          : use the ST Fast commands (response at 52.97 kbps)
+     * \param[in]  timeout       : time in ms given to the host (I2C) side to
+     *                              put or consume each message
+     *
+     * \return ERR_PARAM          : Invalid parameters
+     * \return ERR_DISABLED       : Mailbox not enabled on the tag
+     * \return ERR_TIMEOUT        : Timeout error
+     * \return ERR_NONE           : No error
+     *****************************************************************************
+     */
+    ReturnCode rfalST25xVMbChannelInit(rfalST25xVMbChannel *ch, uint8_t flags, const uint8_t *uid, bool fast, uint16_t timeout);
+
+    /*!
+     *****************************************************************************
+     * \brief  ST25DV Mailbox channel send
+     *
+     * Sends data of any length to the host (I2C) side, fragmented in Write
+     * Message chunks of up to RFAL_ST25DV_MB_CHUNK_MAX_LEN bytes.
+     * Before each chunk MB_CTRL_Dyn is polled until the Mailbox is free (the
+     * previous message consumed by the host). The last chunk is not waited
+     * for: the host consumes it while the caller prepares the next call.
+     *
+     * \param[in]  ch            : initialized channel
+     * \param[in]  data          : data to send
+     * \param[in]  len           : data length, a single byte cannot be sent
+     *
+     * \return ERR_PARAM          : Invalid parameters
+     * \return ERR_TIMEOUT        : the host did not free the Mailbox in time
+     * \return ERR_PROTO          : Protocol error detected
+     * \return ERR_NONE           : No error
+     *****************************************************************************
+     */
+    ReturnCode rfalST25xVMbChannelSend(rfalST25xVMbChannel *ch, const uint8_t *data, uint32_t len);
+
+    /*!
+     *****************************************************************************
+     * \brief  ST25DV Mailbox channel receive
+     *
+     * Waits for a message put by the host (I2C) side and reads it.
+     * The chunks are received in the two channel buffers in turn: the chunk
+     * returned stays valid until the next-but-one call, so the caller can
+     * keep processing it while the next one is being read.
+     *
+     * \param[in]  ch            : initialized channel
+     * \param[out] chunk         : points to the message data in the channel
+     * \param[out] chunkLen      : message length
+     *
+     * \return ERR_PARAM          : Invalid parameters
+     * \return ERR_TIMEOUT        : no message put by the host in time
+     * \return ERR_PROTO          : Protocol error detected
+     * \return ERR_NONE           : No error
+     *****************************************************************************
+     */
+    ReturnCode rfalST25xVMbChannelReceive(rfalST25xVMbChannel *ch, const uint8_t **chunk, uint16_t *chunkLen);
+
 
     /*
     ******************************************************************************
@@ -3257,6 +3354,55 @@ class RfalNfcClass {
     ReturnCode rfalT2TPollerRead(uint8_t blockNum, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen);
 
 
+    /*!
+     *****************************************************************************
+     * \brief  NFC-A T2T Poller Fast Read
+     *
+     * This method sends a FAST_READ command (NTAG proprietary) to a NFC-A T2T
+     * Listener device, reading all the blocks from startBlockNum to endBlockNum
+     * in a single response.
+     * Both blocks must belong to the current sector and the response must fit
+     * in the RF buffer of the reader.
+     *
+     *
+     * \param[in]   startBlockNum : Number of the first block to read
+     * \param[in]   endBlockNum   : Number of the last block to read
+     * \param[out]  rxBuf         : pointer to place the read data
+     * \param[in]   rxBufLen      : size of rxBuf, at least (endBlockNum - startBlockNum + 1) * RFAL_T2T_BLOCK_LEN
+     * \param[out]  rcvLen        : actual received data
+     *
+     * \return ERR_WRONG_STATE  : RFAL not initialized or mode not set
+     * \return ERR_PARAM        : Invalid parameter
+     * \return ERR_NOTSUPP      : NACK received, command not supported or invalid range
+     * \return ERR_PROTO        : Protocol error
+     * \return ERR_NONE         : No error
+     *****************************************************************************
+     */
+    ReturnCode rfalT2TPollerFastRead(uint8_t startBlockNum, uint8_t endBlockNum, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen);
+
+
+    /*!
+     *****************************************************************************
+     * \brief  NFC-A T2T Poller Get Version
+     *
+     * This method sends a GET_VERSION command (NTAG/Ultralight EV1 proprietary)
+     * to a NFC-A T2T Listener device to identify its model.
+     * A tag not supporting it replies with a NACK (or not at all) and goes
+     * back to the IDLE state: it has to be activated again.
+     *
+     *
+     * \param[out]  version       : pointer to place the GET_VERSION response
+     *
+     * \return ERR_WRONG_STATE  : RFAL not initialized or mode not set
+     * \return ERR_PARAM        : Invalid parameter
+     * \return ERR_NOTSUPP      : NACK received, command not supported
+     * \return ERR_PROTO        : Protocol error
+     * \return ERR_NONE         : No error
+     *****************************************************************************
+     */
+    ReturnCode rfalT2TPollerGetVersion(rfalT2TVersion *version);
+
+
     /*!
      *****************************************************************************
      * \brief  NFC-A T2T Poller Write
@@ -3294,6 +3440,31 @@ class RfalNfcClass {
     ReturnCode rfalT2TPollerSectorSelect(uint8_t sectorNum);
 
 
+    /*!
+     *****************************************************************************
+     * \brief  NFC-A T2T Poller Get Sector
+     *
+     * This method returns the sector currently selected on the NFC-A T2T
+     * Listener device: the last one selected with rfalT2TPollerSectorSelect(),
+     * or 0 after the device has been activated or the field switched off
+     *
+     * \return the current sector number
+     *****************************************************************************
+     */
+    uint8_t rfalT2TPollerGetSector(void);
+
+
+    /*!
+     *****************************************************************************
+     * \brief  NFC-A T2T Poller Reset Sector
+     *
+     * This method records that the NFC-A T2T Listener device is back in
+     * sector 0, as after its activation or a field reset
+     *****************************************************************************
+     */
+    void rfalT2TPollerResetSector(void);
+
+
     /*
     ******************************************************************************
     * RFAL T4T FUNCTION PROTOTYPES
@@ -3432,7 +3603,7 @@ class RfalNfcClass {
      *
      * \param[out]     cApduBuf : buffer where the C-APDU will be placed
      * \param[in]      offset   : File offset
-     * \param[in]      expLen   : Expected length (Le)
+     * \param[in]      expLen   : Expected length (Le), extended coding above 256
      * \param[out]     cApduLen : Composed C-APDU length
      *
      * \return ERR_PARAM        : Invalid parameter
@@ -3440,7 +3611,7 @@ class RfalNfcClass {
      * \return ERR_NONE         : No error
      *****************************************************************************
      */
-    ReturnCode rfalT4TPollerComposeReadData(rfalIsoDepApduBufFormat *cApduBuf, uint16_t offset, uint8_t expLen, uint16_t *cApduLen);
+    ReturnCode rfalT4TPollerComposeReadData(rfalIsoDepApduBufFormat *cApduBuf, uint16_t offset, uint16_t expLen, uint16_t *cApduLen);
 
     /*!
      *****************************************************************************
@@ -3455,7 +3626,7 @@ class RfalNfcClass {
      *
      * \param[out]     cApduBuf : buffer where the C-APDU will be placed
      * \param[in]      offset   : File offset
-     * \param[in]      expLen   : Expected length (Le)
+     * \param[in]      expLen   : Expected length (Le), extended coding above 256
      * \param[out]     cApduLen : Composed C-APDU length
      *
      * \return ERR_PARAM        : Invalid parameter
@@ -3463,7 +3634,7 @@ class RfalNfcClass {
      * \return ERR_NONE         : No error
      *****************************************************************************
      */
-    ReturnCode rfalT4TPollerComposeReadDataODO(rfalIsoDepApduBufFormat *cApduBuf, uint32_t offset, uint8_t expLen, uint16_t *cApduLen);
+    ReturnCode rfalT4TPollerComposeReadDataODO(rfalIsoDepApduBufFormat *cApduBuf, uint32_t offset, uint16_t expLen, uint16_t *cApduLen);
 
     /*!
      *****************************************************************************
@@ -3479,7 +3650,7 @@ class RfalNfcClass {
      * \param[out]     cApduBuf : buffer where the C-APDU will be placed
      * \param[in]      offset   : File offset
      * \param[in]      data     : Data to be written
-     * \param[in]      dataLen  : Data length to be written (Lc)
+     * \param[in]      dataLen  : Data length to be written (Lc), extended coding above 255
      * \param[out]     cApduLen : Composed C-APDU length
      *
      * \return ERR_PARAM        : Invalid parameter
@@ -3487,7 +3658,7 @@ class RfalNfcClass {
      * \return ERR_NONE         : No error
      *****************************************************************************
      */
-    ReturnCode rfalT4TPollerComposeWriteData(rfalIsoDepApduBufFormat *cApduBuf, uint16_t offset, const uint8_t *data, uint8_t dataLen, uint16_t *cApduLen);
+    ReturnCode rfalT4TPollerComposeWriteData(rfalIsoDepApduBufFormat *cApduBuf, uint16_t offset, const uint8_t *data, uint16_t dataLen, uint16_t *cApduLen);
 
     /*!
      *****************************************************************************
@@ -3503,7 +3674,7 @@ class RfalNfcClass {
      * \param[out]     cApduBuf : buffer where the C-APDU will be placed
      * \param[in]      offset   : File offset
      * \param[in]      data     : Data to be written
-     * \param[in]      dataLen  : Data length to be written (Lc)
+     * \param[in]      dataLen  : Data length to be written (Lc), extended coding above 255
      * \param[out]     cApduLen : Composed C-APDU length
      *
      * \return ERR_PARAM        : Invalid parameter
@@ -3511,7 +3682,55 @@ class RfalNfcClass {
      * \return ERR_NONE         : No error
      *****************************************************************************
      */
-    ReturnCode rfalT4TPollerComposeWriteDataODO(rfalIsoDepApduBufFormat *cApduBuf, uint32_t offset, const uint8_t *data, uint8_t dataLen, uint16_t *cApduLen);
+    ReturnCode rfalT4TPollerComposeWriteDataODO(rfalIsoDepApduBufFormat *cApduBuf, uint32_t offset, const uint8_t *data, uint16_t dataLen, uint16_t *cApduLen);
+
+    /*!
+     *****************************************************************************
+     * \brief  T4T Poller Set Selected Application
+     *
+     * This method records the application successfully selected on the
+     * activated ISO-DEP device. The selected file is forgotten.
+     * The selection state is cleared whenever ISO-DEP is (re)initialized,
+     * i.e. on activation and deselection.
+     *
+     * \param[in]      aid      : Application ID selected, NULL to clear the selection
+     * \param[in]      aidLen   : Application ID length
+     *****************************************************************************
+     */
+    void rfalT4TPollerSetSelectedAppl(const uint8_t *aid, uint8_t aidLen);
+
+    /*!
+     *****************************************************************************
+     * \brief  T4T Poller Is Application Selected
+     *
+     * \param[in]      aid      : Application ID
+     * \param[in]      aidLen   : Application ID length
+     *
+     * \return true if the given application is known to be selected
+     *****************************************************************************
+     */
+    bool rfalT4TPollerIsApplSelected(const uint8_t *aid, uint8_t aidLen);
+
+    /*!
+     *****************************************************************************
+     * \brief  T4T Poller Set Selected File
+     *
+     * This method records the file successfully selected within the current
+     * application, RFAL_T4T_FID_NONE when unknown
+     *
+     * \param[in]      fid      : File ID
+     *****************************************************************************
+     */
+    void rfalT4TPollerSetSelectedFile(uint16_t fid);
+
+    /*!
+     *****************************************************************************
+     * \brief  T4T Poller Get Selected File
+     *
+     * \return the file known to be selected, RFAL_T4T_FID_NONE if unknown
+     *****************************************************************************
+     */
+    uint16_t rfalT4TPollerGetSelectedFile(void);
 
     RfalRfClass *getRfalRf()
     {
@@ -3531,6 +3750,7 @@ class RfalNfcClass {
     ReturnCode isoDepHandleControlMsg(rfalIsoDepControlMsg controlMsg, uint8_t param);
     void rfalIsoDepApdu2IBLockParam(rfalIsoDepApduTxRxParam apduParam, rfalIsoDepTxRxParam *iBlockParam, uint16_t txPos, uint16_t rxPos);
     ReturnCode isoDepDataExchangePCD(uint16_t *outActRxLen, bool *outIsChaining);
+    ReturnCode rfalIsoDepApduStoreRx(const uint8_t *inf, uint16_t infLen);
     void rfalIsoDepCalcBitRate(rfalBitRate maxAllowedBR, uint8_t piccBRCapability, rfalBitRate *dsi, rfalBitRate *dri);
     uint32_t rfalIsoDepSFGI2SFGT(uint8_t sfgi);
     uint8_t rfalNfcaCalculateBcc(const uint8_t *buf, uint8_t bufLen);
@@ -3556,6 +3776,7 @@ class RfalNfcClass {
     ReturnCode rfalST25xVPollerGenericReadMessageLength(uint8_t cmd, uint8_t flags, const uint8_t *uid, uint8_t *msgLen);
     ReturnCode rfalST25xVPollerGenericReadMessage(uint8_t cmd, uint8_t flags, const uint8_t *uid, uint8_t mbPointer, uint8_t numBytes, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen);
     ReturnCode rfalST25xVPollerGenericWriteMessage(uint8_t cmd, uint8_t flags, const uint8_t *uid, uint8_t msgLen, const uint8_t *msgData, uint8_t *txBuf, uint16_t txBufLen);
+    ReturnCode rfalST25xVMbChannelWait(const rfalST25xVMbChannel *ch, uint8_t mask, uint8_t value);
     uint32_t timerCalculateTimer(uint16_t time);
     bool timerIsExpired(uint32_t timer);
 
@@ -3565,6 +3786,8 @@ class RfalNfcClass {
     rfalNfcb gRfalNfcb; /*!< RFAL NFC-B Instance */
     rfalNfcDep gNfcip;                    /*!< NFCIP module instance                         */
     rfalNfcfGreedyF gRfalNfcfGreedyF;   /*!< Activity's NFCF Greedy collection */
+    uint8_t gT2TSectorNo;               /*!< T2T sector currently selected     */
+    rfalT4tSelection gT4TSelection;     /*!< T4T application/file selected    */
 
 };
 
@@ -165,6 +165,9 @@ ReturnCode RfalNfcClass::rfalNfcaPollerInitialize(void)
   EXIT_ON_ERR(ret, rfalRfDev->rfalSetMode(RFAL_MODE_POLL_NFCA, RFAL_BR_106, RFAL_BR_106));
   rfalRfDev->rfalSetErrorHandling(RFAL_ERRORHANDLING_NFC);
 
+  /* No device selected yet */
+  rfalT2TPollerResetSector();
+
   rfalRfDev->rfalSetGT(RFAL_GT_NFCA);
   rfalRfDev->rfalSetFDTListen(RFAL_FDT_LISTEN_NFCA_POLLER);
   rfalRfDev->rfalSetFDTPoll(RFAL_FDT_POLL_NFCA_POLLER);
@@ -360,6 +363,9 @@ ReturnCode RfalNfcClass::rfalNfcaPollerSingleCollisionResolution(uint8_t devLimi
       /* UID Selection complete, Stop Cascade Level loop */
       ST_MEMCPY(&nfcId1[*nfcId1Len], (uint8_t *)&selReq.nfcid1, RFAL_NFCA_CASCADE_1_UID_LEN);
       *nfcId1Len += RFAL_NFCA_CASCADE_1_UID_LEN;
+
+      /* A T2T supporting SECTOR SELECT starts in sector 0 once selected */
+      rfalT2TPollerResetSector();
       return ERR_NONE;
     }
   }
@@ -520,6 +526,9 @@ ReturnCode RfalNfcClass::rfalNfcaPollerSelect(const uint8_t *nfcid1, uint8_t nfc
 
   /* REMARK: Could check if NFCID1 is complete */
 
+  /* A T2T supporting SECTOR SELECT starts in sector 0 once selected */
+  rfalT2TPollerResetSector();
+
   return ERR_NONE;
 }
 
@@ -61,7 +61,6 @@
 #define RFAL_ST25xV_MBPOINTER_LEN        1U     /*!< Read Message MBPointer length                                     */
 #define RFAL_ST25xV_NUMBYTES_LEN         1U     /*!< Read Message Number of Bytes length                               */
 
-#define RFAL_ST25TV02K_TBOOT_RF          1U     /*!< RF Boot time (Minimum time from carrier generation to first data) */
 #define RFAL_ST25TV02K_TRF_OFF           2U     /*!< RF OFF time                                                       */
 
 #define RFAL_FDT_POLL_MAX                 rfalConvMsTo1fc(20) /*!< Maximum Wait time FDTV,EOF 20 ms    Digital 2.0  B.5 */
@@ -234,6 +233,39 @@ ReturnCode RfalNfcClass::rfalST25xVPollerGenericWriteMessage(uint8_t cmd, uint8_
   return ERR_NONE;
 }
 
+/*******************************************************************************/
+ReturnCode RfalNfcClass::rfalST25xVMbChannelWait(const rfalST25xVMbChannel *ch, uint8_t mask, uint8_t value)
+{
+  ReturnCode ret;
+  uint8_t    mbCtrl;
+  uint32_t   timer;
+
+  timer = timerCalculateTimer(ch->timeout);
+
+  do {
+    if (ch->fast) {
+      ret = rfalST25xVPollerFastReadDynamicConfiguration(ch->flags, ch->uid, RFAL_ST25DV_MB_CTRL_DYN, &mbCtrl);
+    } else {
+      ret = rfalST25xVPollerReadDynamicConfiguration(ch->flags, ch->uid, RFAL_ST25DV_MB_CTRL_DYN, &mbCtrl);
+    }
+
+    if (ret == ERR_NONE) {
+      if ((mbCtrl & RFAL_ST25DV_MB_CTRL_MB_EN) == 0U) {
+        return ERR_DISABLED;
+      }
+      if ((mbCtrl & mask) == value) {
+        return ERR_NONE;
+      }
+    } else if ((ret != ERR_TIMEOUT) && (ret != ERR_PROTO)) {
+      return ret;
+    } else {
+      /* Tag busy with the host (I2C) side: silent or error response, keep polling */
+    }
+  } while (!timerIsExpired(timer));
+
+  return ERR_TIMEOUT;
+}
+
 /*
 ******************************************************************************
 * GLOBAL FUNCTIONS
@@ -448,8 +480,7 @@ ReturnCode RfalNfcClass::rfalST25xVPollerGetRandomNumber(uint8_t flags, const ui
   rfalRfDev->rfalFieldOff();
   delay(RFAL_ST25TV02K_TRF_OFF);
   rfalNfcvPollerInitialize();
-  rfalRfDev->rfalFieldOnAndStartGT();
-  delay(RFAL_ST25TV02K_TBOOT_RF);
+  rfalRfDev->rfalFieldOnAndStartGT(); /* The NFC-V guard time exceeds tBOOT_RF and is waited before the request */
   return rfalNfcvPollerTransceiveReq(RFAL_NFCV_CMD_GET_RANDOM_NUMBER, flags, RFAL_NFCV_ST_IC_MFG_CODE, uid, NULL, 0U, rxBuf, rxBufLen, rcvLen);
 }
 
@@ -488,3 +519,93 @@ ReturnCode RfalNfcClass::rfalST25xVPollerFastReadMessage(uint8_t flags, const ui
 {
   return rfalST25xVPollerGenericReadMessage(RFAL_NFCV_CMD_FAST_READ_MESSAGE, flags, uid, mbPointer, numBytes, rxBuf, rxBufLen, rcvLen);
 }
+
+/*******************************************************************************/
+ReturnCode RfalNfcClass::rfalST25xVMbChannelInit(rfalST25xVMbChannel *ch, uint8_t flags, const uint8_t *uid, bool fast, uint16_t timeout)
+{
+  if (ch == NULL) {
+    return ERR_PARAM;
+  }
+
+  ch->flags   = flags;
+  ch->uid     = uid;
+  ch->fast    = fast;
+  ch->timeout = timeout;
+  ch->cur     = 0U;
+
+  /* Only check the Mailbox is enabled, whatever message is pending */
+  return rfalST25xVMbChannelWait(ch, 0U, 0U);
+}
+
+/*******************************************************************************/
+ReturnCode RfalNfcClass::rfalST25xVMbChannelSend(rfalST25xVMbChannel *ch, const uint8_t *data, uint32_t len)
+{
+  ReturnCode ret;
+  uint32_t   it;
+  uint32_t   chunkLen;
+
+  /* Write Message carries 2 to 255 bytes: a single byte cannot be sent */
+  if ((ch == NULL) || (data == NULL) || (len == 1U)) {
+    return ERR_PARAM;
+  }
+
+  it = 0;
+  while (it < len) {
+    chunkLen = MIN((len - it), RFAL_ST25DV_MB_CHUNK_MAX_LEN);
+    if ((len - it - chunkLen) == 1U) {
+      chunkLen--;                                /* Do not leave a single byte for the last chunk */
+    }
+
+    /* Mailbox free once the host has consumed the previous message */
+    EXIT_ON_ERR(ret, rfalST25xVMbChannelWait(ch, (RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG | RFAL_ST25DV_MB_CTRL_RF_PUT_MSG), 0U));
+
+    if (ch->fast) {
+      ret = rfalST25xVPollerFastWriteMessage(ch->flags, ch->uid, (uint8_t)(chunkLen - 1U), &data[it], ch->buf[ch->cur], (uint16_t)sizeof(ch->buf[ch->cur]));
+    } else {
+      ret = rfalST25xVPollerWriteMessage(ch->flags, ch->uid, (uint8_t)(chunkLen - 1U), &data[it], ch->buf[ch->cur], (uint16_t)sizeof(ch->buf[ch->cur]));
+    }
+    if (ret != ERR_NONE) {
+      return ret;
+    }
+
+    it += chunkLen;
+  }
+
+  return ERR_NONE;
+}
+
+/*******************************************************************************/
+ReturnCode RfalNfcClass::rfalST25xVMbChannelReceive(rfalST25xVMbChannel *ch, const uint8_t **chunk, uint16_t *chunkLen)
+{
+  ReturnCode ret;
+  uint16_t   rcvLen;
+  uint8_t   *buf;
+
+  if ((ch == NULL) || (chunk == NULL) || (chunkLen == NULL)) {
+    return ERR_PARAM;
+  }
+
+  EXIT_ON_ERR(ret, rfalST25xVMbChannelWait(ch, RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG, RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG));
+
+  /* Pointer and Number of bytes 00h: the whole message, which frees the Mailbox */
+  buf = ch->buf[ch->cur];
+  if (ch->fast) {
+    ret = rfalST25xVPollerFastReadMessage(ch->flags, ch->uid, 0U, 0U, buf, (uint16_t)sizeof(ch->buf[ch->cur]), &rcvLen);
+  } else {
+    ret = rfalST25xVPollerReadMessage(ch->flags, ch->uid, 0U, 0U, buf, (uint16_t)sizeof(ch->buf[ch->cur]), &rcvLen);
+  }
+  if (ret != ERR_NONE) {
+    return ret;
+  }
+  if (rcvLen < (RFAL_NFCV_FLAG_LEN + 1U)) {
+    return ERR_PROTO;
+  }
+
+  *chunk    = &buf[RFAL_NFCV_FLAG_LEN];
+  *chunkLen = (uint16_t)(rcvLen - RFAL_NFCV_FLAG_LEN);
+
+  /* Next exchange uses the other buffer, this chunk stays valid meanwhile */
+  ch->cur ^= 1U;
+
+  return ERR_NONE;
+}
@@ -51,8 +51,8 @@
  ******************************************************************************
  */
 #include "st_errno.h"
-#include "rfal_nfc.h"
 #include "rfal_rf.h"
+#include "rfal_nfcv.h"
 
 /*
  ******************************************************************************
@@ -64,6 +64,34 @@
 #define RFAL_NFCV_BLOCKNUM_M24LR_LEN                     2U      /*!< Block Number length of MR24LR tags: 16 bits                */
 #define RFAL_NFCV_ST_IC_MFG_CODE                         0x02    /*!< ST IC Mfg code (used for custom commands)                  */
 
+#define RFAL_ST25DV_MB_LEN                               256U    /*!< ST25DV Mailbox length                                      */
+#define RFAL_ST25DV_MB_CTRL_DYN                          0x0DU   /*!< ST25DV MB_CTRL_Dyn dynamic register pointer                */
+#define RFAL_ST25DV_MB_CTRL_MB_EN                        0x01U   /*!< MB_CTRL_Dyn MB_EN: Mailbox enabled                         */
+#define RFAL_ST25DV_MB_CTRL_HOST_PUT_MSG                 0x02U   /*!< MB_CTRL_Dyn HOST_PUT_MSG: message put by the host (I2C)    */
+#define RFAL_ST25DV_MB_CTRL_RF_PUT_MSG                   0x04U   /*!< MB_CTRL_Dyn RF_PUT_MSG: message put by the reader (RF)     */
+#define RFAL_ST25DV_MB_CTRL_HOST_MISS_MSG                0x10U   /*!< MB_CTRL_Dyn HOST_MISS_MSG: message not read by the host    */
+#define RFAL_ST25DV_MB_CTRL_RF_MISS_MSG                  0x20U   /*!< MB_CTRL_Dyn RF_MISS_MSG: message not read by the reader    */
+
+#define RFAL_ST25DV_MB_CHUNK_MAX_LEN                     255U    /*!< Longest chunk sent by the Mailbox channel (Write Message)  */
+#define RFAL_ST25DV_MB_BUF_LEN                           (RFAL_ST25DV_MB_LEN + 12U) /*!< Write Message frame / Read Message response  */
+
+
+/*
+ ******************************************************************************
+ * GLOBAL TYPES
+ ******************************************************************************
+ */
+
+/*! ST25DV Fast Transfer Mode channel: streams data through the 256 bytes Mailbox */
+typedef struct {
+  uint8_t                  flags;                                    /*!< NFC-V request flags                                */
+  const uint8_t           *uid;                                      /*!< UID of the tag, NULL for Select mode               */
+  bool                     fast;                                     /*!< Use the ST Fast commands                           */
+  uint16_t                 timeout;                                  /*!< Time the other side is given per message in ms     */
+  uint8_t                  buf[2][RFAL_ST25DV_MB_BUF_LEN];           /*!< Frame buffers, one exposed while the other is used */
+  uint8_t                  cur;                                      /*!< Buffer used by the next exchange                   */
+} rfalST25xVMbChannel;
+
 
 #endif /* RFAL_ST25xV_H */
 
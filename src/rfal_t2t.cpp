@@ -72,6 +72,8 @@
 /*! NFC-A T2T command set    T2T 1.0 5.1 */
 typedef enum {
   RFAL_T2T_CMD_READ           = 0x30,     /*!< T2T Read                                */
+  RFAL_T2T_CMD_GET_VERSION    = 0x60,     /*!< NTAG Get Version (proprietary)          */
+  RFAL_T2T_CMD_FAST_READ      = 0x3A,     /*!< NTAG Fast Read (proprietary)            */
   RFAL_T2T_CMD_WRITE          = 0xA2,     /*!< T2T Write                               */
   RFAL_T2T_CMD_SECTOR_SELECT  = 0xC2      /*!< T2T Sector Select                       */
 } rfalT2Tcmds;
@@ -84,6 +86,14 @@ typedef struct {
 } rfalT2TReadReq;
 
 
+/*! NTAG FAST_READ    NTAG21x 10.3 */
+typedef struct {
+  uint8_t code;                           /*!< Command code                            */
+  uint8_t startBlNo;                      /*!< Start block number                      */
+  uint8_t endBlNo;                        /*!< End block number                        */
+} rfalT2TFastReadReq;
+
+
 /*! NFC-A T2T WRITE    T2T 1.0 5.3 and table 12 */
 typedef struct {
   uint8_t code;                           /*!< Command code                            */
@@ -136,6 +146,59 @@ ReturnCode RfalNfcClass::rfalT2TPollerRead(uint8_t blockNum, uint8_t *rxBuf, uin
 }
 
 
+/*******************************************************************************/
+ReturnCode RfalNfcClass::rfalT2TPollerFastRead(uint8_t startBlockNum, uint8_t endBlockNum, uint8_t *rxBuf, uint16_t rxBufLen, uint16_t *rcvLen)
+{
+  ReturnCode          ret;
+  rfalT2TFastReadReq  req;
+
+  if ((rxBuf == NULL) || (rcvLen == NULL) || (startBlockNum > endBlockNum) ||
+      ((((uint32_t)endBlockNum - startBlockNum) + 1U) > ((uint32_t)rxBufLen / RFAL_T2T_BLOCK_LEN))) {
+    return ERR_PARAM;
+  }
+
+  req.code      = (uint8_t)RFAL_T2T_CMD_FAST_READ;
+  req.startBlNo = startBlockNum;
+  req.endBlNo   = endBlockNum;
+
+  /* Transceive Command */
+  ret = rfalRfDev->rfalTransceiveBlockingTxRx((uint8_t *)&req, sizeof(rfalT2TFastReadReq), rxBuf, rxBufLen, rcvLen, RFAL_TXRX_FLAGS_DEFAULT, RFAL_FDT_POLL_READ_MAX);
+
+  /* A tag not supporting FAST_READ or an invalid address range is reported by a NACK */
+  if ((ret == ERR_INCOMPLETE_BYTE) && (*rcvLen == RFAL_T2T_ACK_NACK_LEN) && ((*rxBuf & RFAL_T2T_ACK_MASK) != RFAL_T2T_ACK)) {
+    return ERR_NOTSUPP;
+  }
+  return ret;
+}
+
+
+/*******************************************************************************/
+ReturnCode RfalNfcClass::rfalT2TPollerGetVersion(rfalT2TVersion *version)
+{
+  ReturnCode      ret;
+  uint8_t         req;
+  uint16_t        rcvLen;
+
+  if (version == NULL) {
+    return ERR_PARAM;
+  }
+
+  req = (uint8_t)RFAL_T2T_CMD_GET_VERSION;
+
+  /* Transceive Command */
+  ret = rfalRfDev->rfalTransceiveBlockingTxRx(&req, sizeof(uint8_t), (uint8_t *)version, sizeof(rfalT2TVersion), &rcvLen, RFAL_TXRX_FLAGS_DEFAULT, RFAL_FDT_POLL_READ_MAX);
+
+  /* A tag not supporting GET_VERSION reports it by a NACK */
+  if ((ret == ERR_INCOMPLETE_BYTE) && (rcvLen == RFAL_T2T_ACK_NACK_LEN)) {
+    return ERR_NOTSUPP;
+  }
+  if ((ret == ERR_NONE) && (rcvLen != RFAL_T2T_VERSION_LEN)) {
+    return ERR_PROTO;
+  }
+  return ret;
+}
+
+
 /*******************************************************************************/
 ReturnCode RfalNfcClass::rfalT2TPollerWrite(uint8_t blockNum, const uint8_t *wrData)
 {
@@ -208,8 +271,23 @@ ReturnCode RfalNfcClass::rfalT2TPollerSectorSelect(uint8_t sectorNum)
 
   /* T2T 1.0 5.4.1.13 The Reader/Writer SHALL treat the transmission of the SECTOR SELECT Command Packet 2 as being successful when it receives no response until PATT2T,SL,MAX. */
   if (ret == ERR_TIMEOUT) {
+    gT2TSectorNo = sectorNum;
     return ERR_NONE;
   }
 
   return ret;
 }
+
+
+/*******************************************************************************/
+uint8_t RfalNfcClass::rfalT2TPollerGetSector(void)
+{
+  return gT2TSectorNo;
+}
+
+
+/*******************************************************************************/
+void RfalNfcClass::rfalT2TPollerResetSector(void)
+{
+  gT2TSectorNo = 0U;
+}
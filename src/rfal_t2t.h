@@ -63,6 +63,7 @@
 #define RFAL_T2T_BLOCK_LEN            4U                          /*!< T2T block length           */
 #define RFAL_T2T_READ_DATA_LEN        (4U * RFAL_T2T_BLOCK_LEN)   /*!< T2T READ data length       */
 #define RFAL_T2T_WRITE_DATA_LEN       RFAL_T2T_BLOCK_LEN          /*!< T2T WRITE data length      */
+#define RFAL_T2T_VERSION_LEN          8U                          /*!< GET_VERSION response length */
 
 /*
 ******************************************************************************
@@ -70,6 +71,18 @@
 ******************************************************************************
 */
 
+/*! NTAG/Ultralight GET_VERSION response    NTAG21x 10.1 */
+typedef struct {
+  uint8_t header;                         /*!< Fixed header (00h)                      */
+  uint8_t vendorId;                       /*!< Vendor ID (04h: NXP)                    */
+  uint8_t productType;                    /*!< Product type (03h: Ultralight, 04h: NTAG) */
+  uint8_t productSubtype;                 /*!< Product subtype                         */
+  uint8_t majorVersion;                   /*!< Major product version                   */
+  uint8_t minorVersion;                   /*!< Minor product version                   */
+  uint8_t storageSize;                    /*!< Storage size                            */
+  uint8_t protocolType;                   /*!< Protocol type (03h: ISO/IEC 14443-3)    */
+} rfalT2TVersion;
+
 
 /*
 ******************************************************************************
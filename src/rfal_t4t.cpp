@@ -57,8 +57,10 @@
 #define RFAL_T4T_OFFSET_DO          0x54U        /*!< Tag value for offset BER-TLV data object          */
 #define RFAL_T4T_LENGTH_DO          0x03U        /*!< Len value for offset BER-TLV data object          */
 #define RFAL_T4T_DATA_DO            0x53U        /*!< Tag value for data BER-TLV data object            */
+#define RFAL_T4T_BER_LEN_1B_MAX     0x7FU        /*!< Max BER-TLV length coded on one byte              */
+#define RFAL_T4T_BER_LEN_81         0x81U        /*!< BER-TLV length followed by one byte               */
+#define RFAL_T4T_BER_LEN_82         0x82U        /*!< BER-TLV length followed by two bytes              */
 
-#define RFAL_T4T_MAX_LC             255U         /*!< Maximum Lc value for short Lc coding              */
 /*
 ******************************************************************************
 * GLOBAL TYPES
@@ -91,6 +93,8 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeCAPDU(rfalT4tCApduParam *apduParam)
 {
   uint8_t                  hdrLen;
   uint16_t                 msgIt;
+  uint16_t                 leLen;
+  bool                     extended;
 
   if ((apduParam == NULL) || (apduParam->cApduBuf == NULL) || (apduParam->cApduLen == NULL)) {
     return ERR_PARAM;
@@ -102,24 +106,27 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeCAPDU(rfalT4tCApduParam *apduParam)
   /*******************************************************************************/
   /* Compute Command-APDU  according to the format   T4T 1.0 5.1.2 & ISO7816-4 2013 Table 1 */
 
+  /* Use extended field coding when Lc or Le do not fit the short one, both fields then share it   ISO7816-4 2013 5.1 */
+  extended = ((apduParam->LcFlag && (apduParam->Lc > RFAL_T4T_MAX_LC)) || (apduParam->LeFlag && (apduParam->Le > RFAL_T4T_MAX_LE)));
+
+  leLen = 0U;
+  if (apduParam->LeFlag) {
+    leLen = (extended ? (apduParam->LcFlag ? RFAL_T4T_LE_EXT_LEN : RFAL_T4T_LC_EXT_LEN) : RFAL_T4T_LE_LEN);
+  }
+
   /* Check if Data is present */
   if (apduParam->LcFlag) {
     if (apduParam->Lc == 0U) {
-      /* Extended field coding not supported */
+      /* An empty data field is signalled by not setting LcFlag */
       return ERR_PARAM;
     }
 
-    /* Check whether requested Lc fits */
-    if ((uint16_t)apduParam->Lc > (uint16_t)(RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN - RFAL_T4T_LE_LEN)) {
-      return ERR_PARAM; /*  PRQA S  2880 # MISRA 2.1 - Unreachable code due to configuration option being set/unset  */
-    }
-
     /* Calculate the header length a place the data/body where it should be */
-    hdrLen = RFAL_T4T_MAX_CAPDU_PROLOGUE_LEN + RFAL_T4T_LC_LEN;
+    hdrLen = RFAL_T4T_MAX_CAPDU_PROLOGUE_LEN + (extended ? RFAL_T4T_LC_EXT_LEN : RFAL_T4T_LC_LEN);
 
     /* make sure not to exceed buffer size */
-    if (((uint16_t)hdrLen + (uint16_t)apduParam->Lc + (apduParam->LeFlag ? RFAL_T4T_LC_LEN : 0U)) > RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN) {
-      return ERR_NOMEM; /*  PRQA S  2880 # MISRA 2.1 - Unreachable code due to configuration option being set/unset */
+    if (((uint32_t)hdrLen + (uint32_t)apduParam->Lc + (uint32_t)leLen) > RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN) {
+      return ERR_NOMEM;
     }
     ST_MEMMOVE(&apduParam->cApduBuf->apdu[hdrLen], apduParam->cApduBuf->apdu, apduParam->Lc);
   }
@@ -133,13 +140,23 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeCAPDU(rfalT4tCApduParam *apduParam)
 
   /* Check if Data field length is to be added */
   if (apduParam->LcFlag) {
-    apduParam->cApduBuf->apdu[msgIt++] = apduParam->Lc;
+    if (extended) {
+      apduParam->cApduBuf->apdu[msgIt++] = 0x00U;
+      apduParam->cApduBuf->apdu[msgIt++] = (uint8_t)(apduParam->Lc >> 8U);
+    }
+    apduParam->cApduBuf->apdu[msgIt++] = (uint8_t)apduParam->Lc;
     msgIt += apduParam->Lc;
   }
 
-  /* Check if Expected Response Length is to be added */
+  /* Check if Expected Response Length is to be added (short Le 256 is coded as 00h) */
   if (apduParam->LeFlag) {
-    apduParam->cApduBuf->apdu[msgIt++] = apduParam->Le;
+    if (extended) {
+      if (!apduParam->LcFlag) {
+        apduParam->cApduBuf->apdu[msgIt++] = 0x00U;
+      }
+      apduParam->cApduBuf->apdu[msgIt++] = (uint8_t)(apduParam->Le >> 8U);
+    }
+    apduParam->cApduBuf->apdu[msgIt++] = (uint8_t)apduParam->Le;
   }
 
   *(apduParam->cApduLen) = msgIt;
@@ -250,7 +267,7 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeSelectFileV1Mapping(rfalIsoDepApduB
 
 
 /*******************************************************************************/
-ReturnCode RfalNfcClass::rfalT4TPollerComposeReadData(rfalIsoDepApduBufFormat *cApduBuf, uint16_t offset, uint8_t expLen, uint16_t *cApduLen)
+ReturnCode RfalNfcClass::rfalT4TPollerComposeReadData(rfalIsoDepApduBufFormat *cApduBuf, uint16_t offset, uint16_t expLen, uint16_t *cApduLen)
 {
   rfalT4tCApduParam cAPDU;
 
@@ -271,7 +288,7 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeReadData(rfalIsoDepApduBufFormat *c
 
 
 /*******************************************************************************/
-ReturnCode RfalNfcClass::rfalT4TPollerComposeReadDataODO(rfalIsoDepApduBufFormat *cApduBuf, uint32_t offset, uint8_t expLen, uint16_t *cApduLen)
+ReturnCode RfalNfcClass::rfalT4TPollerComposeReadDataODO(rfalIsoDepApduBufFormat *cApduBuf, uint32_t offset, uint16_t expLen, uint16_t *cApduLen)
 {
   rfalT4tCApduParam cAPDU;
   uint8_t           dataIt;
@@ -302,7 +319,7 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeReadDataODO(rfalIsoDepApduBufFormat
 
 
 /*******************************************************************************/
-ReturnCode RfalNfcClass::rfalT4TPollerComposeWriteData(rfalIsoDepApduBufFormat *cApduBuf, uint16_t offset, const uint8_t *data, uint8_t dataLen, uint16_t *cApduLen)
+ReturnCode RfalNfcClass::rfalT4TPollerComposeWriteData(rfalIsoDepApduBufFormat *cApduBuf, uint16_t offset, const uint8_t *data, uint16_t dataLen, uint16_t *cApduLen)
 {
   rfalT4tCApduParam cAPDU;
 
@@ -319,6 +336,10 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeWriteData(rfalIsoDepApduBufFormat *
   cAPDU.cApduBuf = cApduBuf;
   cAPDU.cApduLen = cApduLen;
 
+  if (dataLen > (RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN - RFAL_T4T_MAX_CAPDU_PROLOGUE_LEN - RFAL_T4T_LC_EXT_LEN)) {
+    return ERR_NOMEM;
+  }
+
   if (dataLen > 0U) {
     ST_MEMCPY(cAPDU.cApduBuf->apdu, data, dataLen);
   }
@@ -327,10 +348,10 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeWriteData(rfalIsoDepApduBufFormat *
 }
 
 /*******************************************************************************/
-ReturnCode RfalNfcClass::rfalT4TPollerComposeWriteDataODO(rfalIsoDepApduBufFormat *cApduBuf, uint32_t offset, const uint8_t *data, uint8_t dataLen, uint16_t *cApduLen)
+ReturnCode RfalNfcClass::rfalT4TPollerComposeWriteDataODO(rfalIsoDepApduBufFormat *cApduBuf, uint32_t offset, const uint8_t *data, uint16_t dataLen, uint16_t *cApduLen)
 {
   rfalT4tCApduParam cAPDU;
-  uint8_t           dataIt;
+  uint16_t          dataIt;
 
   /* CLA INS P1  P2   Lc  Data                     Le  */
   /* 00h D7h 00h 00h  len 54 03 xxyyzz 53 Ld data  -   */
@@ -351,9 +372,19 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeWriteDataODO(rfalIsoDepApduBufForma
   cApduBuf->apdu[dataIt++] = (uint8_t)(offset >> 8U);
   cApduBuf->apdu[dataIt++] = (uint8_t)(offset);
   cApduBuf->apdu[dataIt++] = RFAL_T4T_DATA_DO;
-  cApduBuf->apdu[dataIt++] = dataLen;
 
-  if ((((uint32_t)dataLen + (uint32_t)dataIt) >= RFAL_T4T_MAX_LC) || (((uint32_t)dataLen + (uint32_t)dataIt) >= RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN)) {
+  /* Data object length in BER-TLV coding   ISO7816-4 2013 Table 6 */
+  if (dataLen > 0xFFU) {
+    cApduBuf->apdu[dataIt++] = RFAL_T4T_BER_LEN_82;
+    cApduBuf->apdu[dataIt++] = (uint8_t)(dataLen >> 8U);
+  } else if (dataLen > RFAL_T4T_BER_LEN_1B_MAX) {
+    cApduBuf->apdu[dataIt++] = RFAL_T4T_BER_LEN_81;
+  } else {
+    /* MISRA 15.7 - Empty else */
+  }
+  cApduBuf->apdu[dataIt++] = (uint8_t)dataLen;
+
+  if (((uint32_t)dataLen + (uint32_t)dataIt) > (RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN - RFAL_T4T_MAX_CAPDU_PROLOGUE_LEN - RFAL_T4T_LC_EXT_LEN)) {
     return (ERR_NOMEM);
   }
 
@@ -365,3 +396,38 @@ ReturnCode RfalNfcClass::rfalT4TPollerComposeWriteDataODO(rfalIsoDepApduBufForma
 
   return rfalT4TPollerComposeCAPDU(&cAPDU);
 }
+
+
+/*******************************************************************************/
+void RfalNfcClass::rfalT4TPollerSetSelectedAppl(const uint8_t *aid, uint8_t aidLen)
+{
+  gT4TSelection.aidLen = 0U;
+  gT4TSelection.fid    = RFAL_T4T_FID_NONE;
+
+  if ((aid != NULL) && (aidLen > 0U) && (aidLen <= RFAL_T4T_AID_MAX_LEN)) {
+    ST_MEMCPY(gT4TSelection.aid, aid, aidLen);
+    gT4TSelection.aidLen = aidLen;
+  }
+}
+
+
+/*******************************************************************************/
+bool RfalNfcClass::rfalT4TPollerIsApplSelected(const uint8_t *aid, uint8_t aidLen)
+{
+  return ((aid != NULL) && (aidLen != 0U) && (gT4TSelection.aidLen == aidLen) && (ST_BYTECMP(gT4TSelection.aid, aid, aidLen) == 0));
+}
+
+
+/*******************************************************************************/
+void RfalNfcClass::rfalT4TPollerSetSelectedFile(uint16_t fid)
+{
+  /* A file is only tracked within a known application */
+  gT4TSelection.fid = ((gT4TSelection.aidLen != 0U) ? fid : RFAL_T4T_FID_NONE);
+}
+
+
+/*******************************************************************************/
+uint16_t RfalNfcClass::rfalT4TPollerGetSelectedFile(void)
+{
+  return gT4TSelection.fid;
+}
@@ -67,6 +67,10 @@
 #define RFAL_T4T_MAX_CAPDU_PROLOGUE_LEN                          4U                          /*!< Command-APDU prologue length (CLA INS P1 P2)                    */
 #define RFAL_T4T_LE_LEN                                          1U                          /*!< Le Expected Response Length (short field coding)                */
 #define RFAL_T4T_LC_LEN                                          1U                          /*!< Lc Data field length  (short field coding)                      */
+#define RFAL_T4T_LE_EXT_LEN                                      2U                          /*!< Le Expected Response Length (extended field coding, Lc present) */
+#define RFAL_T4T_LC_EXT_LEN                                      3U                          /*!< Lc Data field length  (extended field coding)                   */
+#define RFAL_T4T_MAX_LC                                        255U                          /*!< Maximum Lc value for short Lc coding                            */
+#define RFAL_T4T_MAX_LE                                        256U                          /*!< Maximum Le value for short Le coding (coded as 00h)             */
 #define RFAL_T4T_MAX_RAPDU_SW1SW2_LEN                            2U                          /*!< SW1 SW2 length                                                  */
 #define RFAL_T4T_CLA                                          0x00U                          /*!< Class byte (contains 00h because secure message are not used)   */
 
@@ -78,6 +82,9 @@
 
 #define RFAL_T4T_ISO7816_STATUS_COMPLETE                      0x9000U                        /*!< Command completed \ Normal processing - No further qualification*/
 
+#define RFAL_T4T_AID_MAX_LEN                                    16U                          /*!< Maximum AID length   ISO7816-4 2013 12.2.3                      */
+#define RFAL_T4T_FID_NONE                                  0xFFFFU                          /*!< No file known to be selected (FFFFh is reserved)                */
+
 
 /*
 ******************************************************************************
@@ -97,9 +104,9 @@ typedef struct {
   uint8_t                  INS;                              /*!< Instruction byte                                   */
   uint8_t                  P1;                               /*!< Parameter byte 1                                   */
   uint8_t                  P2;                               /*!< Parameter byte 2                                   */
-  uint8_t                  Lc;                               /*!< Data field length                                  */
+  uint16_t                 Lc;                               /*!< Data field length (extended coding above 255)      */
   bool                     LcFlag;                           /*!< Lc flag (append Lc when true)                      */
-  uint8_t                  Le;                               /*!< Expected Response Length                           */
+  uint16_t                 Le;                               /*!< Expected Response Length (extended above 256)      */
   bool                     LeFlag;                           /*!< Le flag (append Le when true)                      */
 
   rfalIsoDepApduBufFormat  *cApduBuf;                        /*!< Command-APDU buffer  (Tx)                          */
@@ -116,6 +123,14 @@ typedef struct {
 
 
 
+/*! NFC-A T4T selection state of the activated ISO-DEP device */
+typedef struct {
+  uint8_t                  aid[RFAL_T4T_AID_MAX_LEN];        /*!< AID of the selected application                    */
+  uint8_t                  aidLen;                           /*!< AID length, 0 if no application known as selected  */
+  uint16_t                 fid;                              /*!< Selected file, RFAL_T4T_FID_NONE if unknown        */
+} rfalT4tSelection;
+
+
 /*! NFC-A T4T command set    T4T 1.0 & ISO7816-4 2013 Table 4 */
 typedef enum {
   RFAL_T4T_INS_SELECT           = 0xA4U,                     /*!< T4T Select                                         */